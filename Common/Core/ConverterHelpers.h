@@ -0,0 +1,78 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ConverterHelpers.h
+/// \brief Column transformations shared by the table converters
+///
+/// The converters copy the unchanged columns and only transform one or two of them.
+/// The transformations are collected here as branch-free kernels, so that the converters
+/// do not repeat the per-row bit loops and allocations.
+
+#ifndef COMMON_CORE_CONVERTERHELPERS_H_
+#define COMMON_CORE_CONVERTERHELPERS_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace o2::aod::converters
+{
+
+static constexpr int NITSLayers = 7;
+
+/// Lookup table from the 7-bit ITS cluster map to the ITS cluster sizes,
+/// with the size of every layer with a hit set to overflow (0xf)
+constexpr std::array<uint32_t, (1 << NITSLayers)> makeItsClusterSizesLut()
+{
+  std::array<uint32_t, (1 << NITSLayers)> lut{};
+  for (uint32_t map = 0; map < lut.size(); map++) {
+    uint32_t sizes = 0;
+    for (int layer = 0; layer < NITSLayers; layer++) {
+      if (map & (1 << layer)) {
+        sizes |= (0xf << (layer * 4));
+      }
+    }
+    lut[map] = sizes;
+  }
+  return lut;
+}
+
+static constexpr std::array<uint32_t, (1 << NITSLayers)> ItsClusterSizesLut = makeItsClusterSizesLut();
+
+/// Dummy ITS cluster sizes for a track stored with only the ITS cluster map
+inline uint32_t itsClusterSizesFromClusterMap(uint8_t itsClusterMap)
+{
+  return ItsClusterSizesLut[itsClusterMap & ((1 << NITSLayers) - 1)];
+}
+
+/// Converts the two mother indices of McParticles_000 into the mother list of McParticles_001.
+/// The list is cleared and refilled, so that it can be reused over the whole table.
+inline void mothersFromIndices(int mother0, int mother1, std::vector<int>& mothers)
+{
+  mothers.clear();
+  if (mother0 >= 0) {
+    mothers.push_back(mother0);
+  }
+  if (mother1 >= 0) {
+    mothers.push_back(mother1);
+  }
+}
+
+/// Converts the two daughter indices of McParticles_000 into the daughter range of McParticles_001
+inline void daughterRangeFromIndices(int daughter0, int daughter1, int (&daughters)[2])
+{
+  daughters[0] = daughter0 >= 0 ? daughter0 : -1;
+  daughters[1] = daughter0 >= 0 ? (daughter1 >= 0 ? daughter1 : daughter0) : -1;
+}
+
+} // namespace o2::aod::converters
+
+#endif // COMMON_CORE_CONVERTERHELPERS_H_
@@ -0,0 +1,118 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+//
+// Translation of the row indices of a source table into the row indices of a skimmed table.
+// Replaces the std::map<uint32_t, uint32_t> index maps of the skimming tasks with a dense vector
+// sized to the source table. The source rows are kept in a list in the order in which they were
+// kept, which is the reverse map when the new indices are assigned in increasing order.
+//
+
+#ifndef COMMON_CORE_INDEXREMAPPER_H_
+#define COMMON_CORE_INDEXREMAPPER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class IndexRemapper
+{
+ public:
+  static constexpr uint32_t NotKept = std::numeric_limits<uint32_t>::max();
+
+  /// @brief Forget all the kept rows and allocate the translation for a source table of nRows rows
+  /// @param withFilter allocate also a filter word for each source row
+  /// Rows beyond nRows can still be kept, the translation is enlarged when needed.
+  void reset(std::size_t nRows, bool withFilter = false)
+  {
+    mNewIndices.assign(nRows, NotKept);
+    mFilters.assign(withFilter ? nRows : 0, 0);
+    mKeptRows.clear();
+    mNextIndex = 0;
+  }
+
+  /// @brief Keep a source row with the next index of the running counter, if not kept already
+  /// @return the new index of the row, NotKept for a negative row (e.g. a missing index of -1)
+  uint32_t keep(int64_t row)
+  {
+    if (row < 0) {
+      return NotKept;
+    }
+    if (!isKept(row)) {
+      set(row, mNextIndex);
+    }
+    return mNewIndices[row];
+  }
+
+  /// @brief Keep a source row with an explicit new index (e.g. the last index of the produced table)
+  /// The running counter continues from newIndex + 1. Negative rows are ignored.
+  void set(int64_t row, uint32_t newIndex)
+  {
+    if (row < 0) {
+      return;
+    }
+    if (row >= static_cast<int64_t>(mNewIndices.size())) {
+      mNewIndices.resize(row + 1, NotKept);
+    }
+    if (mNewIndices[row] == NotKept) {
+      mKeptRows.push_back(row);
+    }
+    mNewIndices[row] = newIndex;
+    mNextIndex = newIndex + 1;
+  }
+
+  /// @brief Whether the source row was kept; negative and out-of-range rows are never kept
+  bool isKept(int64_t row) const
+  {
+    return row >= 0 && row < static_cast<int64_t>(mNewIndices.size()) && mNewIndices[row] != NotKept;
+  }
+
+  /// @brief New index of a source row, NotKept if the row was not kept
+  uint32_t operator[](int64_t row) const
+  {
+    return isKept(row) ? mNewIndices[row] : NotKept;
+  }
+
+  /// @brief Number of kept rows
+  std::size_t size() const { return mKeptRows.size(); }
+  bool empty() const { return mKeptRows.empty(); }
+  uint32_t nextIndex() const { return mNextIndex; }
+
+  /// @brief Source rows in the order in which they were kept (reverse map)
+  std::vector<uint32_t> const& keptRows() const { return mKeptRows; }
+
+  /// @brief Filter word of a source row, 0 if the filter words are not allocated
+  uint64_t filter(int64_t row) const
+  {
+    return (row >= 0 && row < static_cast<int64_t>(mFilters.size())) ? mFilters[row] : 0;
+  }
+
+  /// @brief Add bits to the filter word of a source row (bitwise OR with the existing ones)
+  void addFilter(int64_t row, uint64_t bits)
+  {
+    if (row < 0) {
+      return;
+    }
+    if (row >= static_cast<int64_t>(mFilters.size())) {
+      mFilters.resize(row + 1, 0);
+    }
+    mFilters[row] |= bits;
+  }
+
+ private:
+  std::vector<uint32_t> mNewIndices{}; // new index of each source row, NotKept if not kept
+  std::vector<uint64_t> mFilters{};    // optional filter word of each source row
+  std::vector<uint32_t> mKeptRows{};   // source rows in the order in which they were kept
+  uint32_t mNextIndex{0};              // running counter for keep()
+};
+
+#endif // COMMON_CORE_INDEXREMAPPER_H_
@@ -242,6 +242,8 @@ class TrackSelection
   void print() const;
 
  private:
+  friend class TrackSelectionMatrix;
+
   bool FulfillsITSHitRequirements(uint8_t itsClusterMap) const;
 
   o2::aod::track::TrackTypeEnum mTrackType{o2::aod::track::TrackTypeEnum::Track};
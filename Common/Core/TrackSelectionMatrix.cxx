@@ -0,0 +1,181 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+//
+// Evaluation of several track selections at once
+//
+
+#include "Common/Core/TrackSelectionMatrix.h"
+
+#include "Common/Core/TrackSelection.h"
+
+#include <Framework/DataTypes.h>
+#include <Framework/Logger.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+TrackSelectionMatrix::TrackSelectionMatrix()
+{
+  // predicate 0 stands for all the cuts which are always fulfilled
+  mPredicates.push_back({TrackCuts::kNCuts, -1});
+}
+
+int TrackSelectionMatrix::add(TrackSelection const& selection)
+{
+  const int index = mSelections.size();
+  mSelections.push_back(selection);
+
+  std::array<uint8_t, NCuts> predicates{};
+  PredicateWord required = 0;
+  for (int i = 0; i < NCuts; i++) {
+    const auto cut = static_cast<TrackCuts>(i);
+    int predicate = 0;
+    if (!isTrivial(selection, cut)) {
+      for (int j = 1; j < static_cast<int>(mPredicates.size()); j++) {
+        if (mPredicates[j].cut == cut && isSameCut(mSelections[mPredicates[j].selection], selection, cut)) {
+          predicate = j;
+          break;
+        }
+      }
+      if (predicate == 0) {
+        if (static_cast<int>(mPredicates.size()) == NMaxPredicates) {
+          LOG(fatal) << "Track selection matrix: more than " << NMaxPredicates << " distinct cuts";
+        }
+        predicate = mPredicates.size();
+        mPredicates.push_back({cut, index});
+        mUsedCuts |= 1u << i;
+      }
+    }
+    predicates[i] = predicate;
+    required |= PredicateWord{1} << predicate;
+  }
+  mSelectionPredicates.push_back(predicates);
+  mRequiredPredicates.push_back(required);
+  return index;
+}
+
+TrackSelectionMatrix::PredicateWord TrackSelectionMatrix::evaluateColumns(Columns const& c) const
+{
+  PredicateWord word = 1;
+  for (int i = 1; i < static_cast<int>(mPredicates.size()); i++) {
+    if (passes(c, mPredicates[i])) {
+      word |= PredicateWord{1} << i;
+    }
+  }
+  return word;
+}
+
+// Same cut definitions as TrackSelection::IsSelected(track, cut)
+bool TrackSelectionMatrix::passes(Columns const& c, Predicate const& predicate) const
+{
+  const auto& s = mSelections[predicate.selection];
+  switch (predicate.cut) {
+    case TrackCuts::kTrackType:
+      return c.trackType == s.mTrackType;
+    case TrackCuts::kPtRange:
+      return c.pt >= s.mMinPt && c.pt <= s.mMaxPt;
+    case TrackCuts::kEtaRange:
+      return c.eta >= s.mMinEta && c.eta <= s.mMaxEta;
+    case TrackCuts::kTPCNCls:
+      return c.tpcNClsFound >= s.mMinNClustersTPC;
+    case TrackCuts::kTPCCrossedRows:
+      return c.tpcNClsCrossedRows >= s.mMinNCrossedRowsTPC;
+    case TrackCuts::kTPCCrossedRowsOverNCls:
+      return c.tpcCrossedRowsOverFindableCls >= s.mMinNCrossedRowsOverFindableClustersTPC;
+    case TrackCuts::kTPCChi2NDF:
+      return c.tpcChi2NCl <= s.mMaxChi2PerClusterTPC;
+    case TrackCuts::kTPCRefit:
+      return c.isRun2 ? (c.flags & o2::aod::track::TPCrefit) : c.hasTPC;
+    case TrackCuts::kITSNCls:
+      return c.itsNCls >= s.mMinNClustersITS;
+    case TrackCuts::kITSChi2NDF:
+      return c.itsChi2NCl <= s.mMaxChi2PerClusterITS;
+    case TrackCuts::kITSRefit:
+      return c.isRun2 ? (c.flags & o2::aod::track::ITSrefit) : c.hasITS;
+    case TrackCuts::kITSHits:
+      return s.FulfillsITSHitRequirements(c.itsClusterMap);
+    case TrackCuts::kGoldenChi2:
+      return c.isRun2 ? (c.flags & o2::aod::track::GoldenChi2) : true;
+    case TrackCuts::kDCAxy:
+      return std::fabs(c.dcaXY) <= ((s.mMaxDcaXYPtDep) ? s.mMaxDcaXYPtDep(c.pt) : s.mMaxDcaXY);
+    case TrackCuts::kDCAz:
+      return std::fabs(c.dcaZ) <= s.mMaxDcaZ;
+    case TrackCuts::kTPCFracSharedCls:
+      return c.tpcFractionSharedCls <= s.mMaxTPCFractionSharedCls;
+    default:
+      return false;
+  }
+}
+
+// Cuts which pass for any track
+bool TrackSelectionMatrix::isTrivial(TrackSelection const& selection, TrackCuts cut) const
+{
+  switch (cut) {
+    case TrackCuts::kTPCRefit:
+      return !selection.mRequireTPCRefit;
+    case TrackCuts::kITSRefit:
+      return !selection.mRequireITSRefit;
+    case TrackCuts::kITSHits:
+      return selection.mRequiredITSHits.empty();
+    case TrackCuts::kGoldenChi2:
+      return !selection.mRequireGoldenChi2;
+    default:
+      return false;
+  }
+}
+
+bool TrackSelectionMatrix::isSameCut(TrackSelection const& a, TrackSelection const& b, TrackCuts cut) const
+{
+  switch (cut) {
+    case TrackCuts::kTrackType:
+      return a.mTrackType == b.mTrackType;
+    case TrackCuts::kPtRange:
+      return a.mMinPt == b.mMinPt && a.mMaxPt == b.mMaxPt;
+    case TrackCuts::kEtaRange:
+      return a.mMinEta == b.mMinEta && a.mMaxEta == b.mMaxEta;
+    case TrackCuts::kTPCNCls:
+      return a.mMinNClustersTPC == b.mMinNClustersTPC;
+    case TrackCuts::kTPCCrossedRows:
+      return a.mMinNCrossedRowsTPC == b.mMinNCrossedRowsTPC;
+    case TrackCuts::kTPCCrossedRowsOverNCls:
+      return a.mMinNCrossedRowsOverFindableClustersTPC == b.mMinNCrossedRowsOverFindableClustersTPC;
+    case TrackCuts::kTPCChi2NDF:
+      return a.mMaxChi2PerClusterTPC == b.mMaxChi2PerClusterTPC;
+    case TrackCuts::kTPCRefit:
+      return a.mRequireTPCRefit == b.mRequireTPCRefit;
+    case TrackCuts::kITSNCls:
+      return a.mMinNClustersITS == b.mMinNClustersITS;
+    case TrackCuts::kITSChi2NDF:
+      return a.mMaxChi2PerClusterITS == b.mMaxChi2PerClusterITS;
+    case TrackCuts::kITSRefit:
+      return a.mRequireITSRefit == b.mRequireITSRefit;
+    case TrackCuts::kITSHits:
+      return a.mRequiredITSHits == b.mRequiredITSHits;
+    case TrackCuts::kGoldenChi2:
+      return a.mRequireGoldenChi2 == b.mRequireGoldenChi2;
+    case TrackCuts::kDCAxy:
+      // pT dependent cuts cannot be compared
+      return !a.mMaxDcaXYPtDep && !b.mMaxDcaXYPtDep && a.mMaxDcaXY == b.mMaxDcaXY;
+    case TrackCuts::kDCAz:
+      return a.mMaxDcaZ == b.mMaxDcaZ;
+    case TrackCuts::kTPCFracSharedCls:
+      return a.mMaxTPCFractionSharedCls == b.mMaxTPCFractionSharedCls;
+    default:
+      return false;
+  }
+}
+
+void TrackSelectionMatrix::print() const
+{
+  LOG(info) << "Track selection matrix: " << mSelections.size() << " selections with " << mPredicates.size() - 1 << " distinct cuts";
+}
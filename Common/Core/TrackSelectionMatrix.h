@@ -0,0 +1,176 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+//
+// Evaluation of several track selections at once: every distinct cut of the registered
+// selections is evaluated a single time per track into a predicate word, from which the
+// masks of all the selections are derived.
+//
+
+#ifndef COMMON_CORE_TRACKSELECTIONMATRIX_H_
+#define COMMON_CORE_TRACKSELECTIONMATRIX_H_
+
+#include "Common/Core/TrackSelection.h"
+
+#include <Framework/DataTypes.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class TrackSelectionMatrix
+{
+ public:
+  using PredicateWord = uint64_t;
+  static constexpr int NMaxPredicates = 64;
+
+  TrackSelectionMatrix();
+
+  /// @brief Register a selection (copied, so it has to be fully configured)
+  /// @return index of the selection to be used in mask() and isSelected()
+  int add(TrackSelection const& selection);
+
+  /// @brief Evaluate all the distinct cuts of the registered selections for one track
+  template <typename T>
+  PredicateWord evaluate(T const& track) const
+  {
+    Columns columns;
+    readColumns(track, columns);
+    return evaluateColumns(columns);
+  }
+
+  /// @brief Evaluate the predicate words of a whole track table
+  template <typename TTracks>
+  void evaluate(TTracks const& tracks, std::vector<PredicateWord>& words) const
+  {
+    words.resize(tracks.size());
+    auto word = words.begin();
+    for (const auto& track : tracks) {
+      *word++ = evaluate(track);
+    }
+  }
+
+  /// @brief Equivalent of TrackSelection::IsSelectedMask for the selection with the given index
+  uint16_t mask(PredicateWord word, int selection) const
+  {
+    uint16_t flag = 0;
+    const auto& predicates = mSelectionPredicates[selection];
+    for (int cut = 0; cut < NCuts; cut++) {
+      flag |= ((word >> predicates[cut]) & 1) << cut;
+    }
+    return flag;
+  }
+
+  /// @brief Equivalent of TrackSelection::IsSelected for the selection with the given index
+  bool isSelected(PredicateWord word, int selection) const
+  {
+    return (word & mRequiredPredicates[selection]) == mRequiredPredicates[selection];
+  }
+
+  int getNPredicates() const { return mPredicates.size(); }
+
+  /// @brief Print the number of distinct cuts
+  void print() const;
+
+ private:
+  static constexpr int NCuts = static_cast<int>(TrackSelection::TrackCuts::kNCuts);
+  using TrackCuts = TrackSelection::TrackCuts;
+
+  // columns read once per track, only for the cuts in use
+  struct Columns {
+    bool isRun2 = false;
+    uint8_t trackType = 0;
+    uint32_t flags = 0;
+    bool hasTPC = false;
+    bool hasITS = false;
+    float pt = 0.f;
+    float eta = 0.f;
+    int tpcNClsFound = 0;
+    int tpcNClsCrossedRows = 0;
+    float tpcCrossedRowsOverFindableCls = 0.f;
+    float tpcChi2NCl = 0.f;
+    float tpcFractionSharedCls = 0.f;
+    int itsNCls = 0;
+    float itsChi2NCl = 0.f;
+    uint8_t itsClusterMap = 0;
+    float dcaXY = 0.f;
+    float dcaZ = 0.f;
+  };
+
+  struct Predicate {
+    TrackCuts cut;
+    int selection; // registered selection holding the parameters of the cut
+  };
+
+  bool uses(TrackCuts cut) const { return mUsedCuts & (1u << static_cast<int>(cut)); }
+
+  template <typename T>
+  void readColumns(T const& track, Columns& c) const
+  {
+    c.trackType = track.trackType();
+    c.isRun2 = c.trackType == o2::aod::track::Run2Track || c.trackType == o2::aod::track::Run2Tracklet;
+    if (uses(TrackCuts::kTPCRefit) || uses(TrackCuts::kITSRefit) || uses(TrackCuts::kGoldenChi2)) {
+      c.flags = track.flags();
+      c.hasTPC = track.hasTPC();
+      c.hasITS = track.hasITS();
+    }
+    if (uses(TrackCuts::kPtRange) || uses(TrackCuts::kDCAxy)) {
+      c.pt = track.pt();
+    }
+    if (uses(TrackCuts::kEtaRange)) {
+      c.eta = track.eta();
+    }
+    if (uses(TrackCuts::kTPCNCls)) {
+      c.tpcNClsFound = track.tpcNClsFound();
+    }
+    if (uses(TrackCuts::kTPCCrossedRows)) {
+      c.tpcNClsCrossedRows = track.tpcNClsCrossedRows();
+    }
+    if (uses(TrackCuts::kTPCCrossedRowsOverNCls)) {
+      c.tpcCrossedRowsOverFindableCls = track.tpcCrossedRowsOverFindableCls();
+    }
+    if (uses(TrackCuts::kTPCChi2NDF)) {
+      c.tpcChi2NCl = track.tpcChi2NCl();
+    }
+    if (uses(TrackCuts::kITSNCls)) {
+      c.itsNCls = track.itsNCls();
+    }
+    if (uses(TrackCuts::kITSChi2NDF)) {
+      c.itsChi2NCl = track.itsChi2NCl();
+    }
+    if (uses(TrackCuts::kITSHits)) {
+      c.itsClusterMap = track.itsClusterMap();
+    }
+    if (uses(TrackCuts::kDCAxy)) {
+      c.dcaXY = track.dcaXY();
+    }
+    if (uses(TrackCuts::kDCAz)) {
+      c.dcaZ = track.dcaZ();
+    }
+    if (uses(TrackCuts::kTPCFracSharedCls)) {
+      c.tpcFractionSharedCls = track.tpcFractionSharedCls();
+    }
+  }
+
+  PredicateWord evaluateColumns(Columns const& c) const;
+  bool passes(Columns const& c, Predicate const& predicate) const;
+
+  bool isTrivial(TrackSelection const& selection, TrackCuts cut) const;
+  bool isSameCut(TrackSelection const& a, TrackSelection const& b, TrackCuts cut) const;
+
+  std::vector<TrackSelection> mSelections{};
+  std::vector<Predicate> mPredicates{};                           // distinct cuts, predicate 0 is always fulfilled
+  std::vector<std::array<uint8_t, NCuts>> mSelectionPredicates{}; // predicate of each cut of each selection
+  std::vector<PredicateWord> mRequiredPredicates{};               // predicates needed to pass each selection
+  uint32_t mUsedCuts{0};                                          // cuts evaluated by at least one predicate
+};
+
+#endif // COMMON_CORE_TRACKSELECTIONMATRIX_H_
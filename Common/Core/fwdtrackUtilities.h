@@ -29,7 +29,9 @@
 
 #include <array>
 #include <cstdint>
+#include <functional>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace o2::aod
@@ -198,6 +200,43 @@ o2::dataformats::GlobalFwdTrack propagateTrackParCovFwd(TFwdTrackParCov const& f
   return propmuon;
 }
 
+/// Memoization of propagateMuon, for analyses propagating the same track several times to the same point
+/// (e.g. the MCH-MID track shared by all its MFT-MCH-MID matching candidates).
+/// The states are kept per track, collision and propagation point: the field and the z shift must not
+/// change between two calls of clear(), which has to be called at least at each new time frame.
+class PropagatedMuonCache
+{
+ public:
+  template <typename TFwdTrack, typename TFwdTrackCov, typename TCollision>
+  o2::dataformats::GlobalFwdTrack const& propagate(TFwdTrack const& muon, TFwdTrackCov const& cov, TCollision const& collision, const propagationPoint endPoint, const float matchingZ, const float bzkG, const float zshift = 0.f)
+  {
+    Key key{muon.globalIndex(), collision.globalIndex(), endPoint, endPoint == propagationPoint::kToMatchingPlane ? matchingZ : 0.f};
+    auto [state, isNew] = mStates.try_emplace(key);
+    if (isNew) {
+      state->second = propagateMuon(muon, cov, collision, endPoint, matchingZ, bzkG, zshift);
+    }
+    return state->second;
+  }
+
+  void clear() { mStates.clear(); }
+
+ private:
+  struct Key {
+    int64_t trackId;
+    int64_t collisionId;
+    propagationPoint point;
+    float z;
+    bool operator==(Key const& other) const { return trackId == other.trackId && collisionId == other.collisionId && point == other.point && z == other.z; }
+  };
+  struct KeyHash {
+    std::size_t operator()(Key const& key) const
+    {
+      return static_cast<std::size_t>((key.trackId * 0x9E3779B97F4A7C15ULL) ^ (key.collisionId << 8) ^ static_cast<int64_t>(key.point)) ^ std::hash<float>{}(key.z);
+    }
+  };
+  std::unordered_map<Key, o2::dataformats::GlobalFwdTrack, KeyHash> mStates; // node based: the returned references stay valid until clear()
+};
+
 template <typename TFwdTrack, typename TMFTTrack>
 o2::dataformats::GlobalFwdTrack refitGlobalMuonCov(TFwdTrack const& muon, TMFTTrack const& mft)
 {
@@ -0,0 +1,78 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FITSummary.h
+/// \brief Per-BC summary of the FT0, FV0 and FDD signals, joinable with BCs
+
+#ifndef COMMON_DATAMODEL_FITSUMMARY_H_
+#define COMMON_DATAMODEL_FITSUMMARY_H_
+
+#include <Framework/AnalysisDataModel.h>
+
+#include <cstdint>
+
+namespace o2::aod
+{
+namespace fitsummary
+{
+static constexpr int FT0AInnerRingMaxChannel = 31; // FT0-A channels 0-31 form the inner ring
+static constexpr int FT0CInnerRingMaxChannel = 47; // FT0-C channels 0-47 (96-143 in the global numbering) form the inner ring
+static constexpr int FV0InnerRingMaxChannel = 7;   // FV0-A channels 0-7 form the innermost ring
+static constexpr int FV0NRings = 5;                // FV0-A rings 1-4 have 8 channels each, ring 5 has channels 32-47
+
+inline int fv0Ring(int channel) { return channel / 8 < FV0NRings ? channel / 8 : FV0NRings - 1; }
+
+// Sums and times are -999 and counts and masks are 0 when the detector has no entry in the BC.
+// Sums are accumulated in the order of the channels in the AO2D, as the per-collision tasks do.
+// The times are the side times of the detector tables: per-channel times are not stored in the AO2D.
+DECLARE_SOA_COLUMN(FT0SumA, ft0SumA, float);                 //! FT0-A amplitude sum
+DECLARE_SOA_COLUMN(FT0SumC, ft0SumC, float);                 //! FT0-C amplitude sum
+DECLARE_SOA_COLUMN(FT0SumAInner, ft0SumAInner, float);       //! FT0-A amplitude sum, inner ring
+DECLARE_SOA_COLUMN(FT0SumAOuter, ft0SumAOuter, float);       //! FT0-A amplitude sum, outer ring
+DECLARE_SOA_COLUMN(FT0SumCInner, ft0SumCInner, float);       //! FT0-C amplitude sum, inner ring
+DECLARE_SOA_COLUMN(FT0SumCOuter, ft0SumCOuter, float);       //! FT0-C amplitude sum, outer ring
+DECLARE_SOA_COLUMN(FT0NChannelsA, ft0NChannelsA, uint8_t);   //! FT0-A number of channels with a signal
+DECLARE_SOA_COLUMN(FT0NChannelsC, ft0NChannelsC, uint8_t);   //! FT0-C number of channels with a signal
+DECLARE_SOA_COLUMN(FT0TimeA, ft0TimeA, float);               //! FT0-A mean time
+DECLARE_SOA_COLUMN(FT0TimeC, ft0TimeC, float);               //! FT0-C mean time
+DECLARE_SOA_COLUMN(FT0TriggerMask, ft0TriggerMask, uint8_t); //! FT0 trigger mask
+
+DECLARE_SOA_COLUMN(FV0SumA, fv0SumA, float);                 //! FV0-A amplitude sum
+DECLARE_SOA_COLUMN(FV0SumAOuter, fv0SumAOuter, float);       //! FV0-A amplitude sum without the innermost ring
+DECLARE_SOA_COLUMN(FV0RingSums, fv0RingSums, float[5]);      //! FV0-A amplitude sum per ring
+DECLARE_SOA_COLUMN(FV0NChannels, fv0NChannels, uint8_t);     //! FV0-A number of channels with a signal
+DECLARE_SOA_COLUMN(FV0Time, fv0Time, float);                 //! FV0-A mean time
+DECLARE_SOA_COLUMN(FV0TriggerMask, fv0TriggerMask, uint8_t); //! FV0 trigger mask
+
+DECLARE_SOA_COLUMN(FDDSumA, fddSumA, float);                 //! FDD-A charge sum
+DECLARE_SOA_COLUMN(FDDSumC, fddSumC, float);                 //! FDD-C charge sum
+DECLARE_SOA_COLUMN(FDDNChannelsA, fddNChannelsA, uint8_t);   //! FDD-A number of channels with a signal
+DECLARE_SOA_COLUMN(FDDNChannelsC, fddNChannelsC, uint8_t);   //! FDD-C number of channels with a signal
+DECLARE_SOA_COLUMN(FDDTimeA, fddTimeA, float);               //! FDD-A mean time
+DECLARE_SOA_COLUMN(FDDTimeC, fddTimeC, float);               //! FDD-C mean time
+DECLARE_SOA_COLUMN(FDDTriggerMask, fddTriggerMask, uint8_t); //! FDD trigger mask
+} // namespace fitsummary
+
+DECLARE_SOA_TABLE(FITSummaries, "AOD", "FITSUMMARY", //! FIT signals, one row per BC (joinable with BCs)
+                  fitsummary::FT0SumA, fitsummary::FT0SumC,
+                  fitsummary::FT0SumAInner, fitsummary::FT0SumAOuter,
+                  fitsummary::FT0SumCInner, fitsummary::FT0SumCOuter,
+                  fitsummary::FT0NChannelsA, fitsummary::FT0NChannelsC,
+                  fitsummary::FT0TimeA, fitsummary::FT0TimeC, fitsummary::FT0TriggerMask,
+                  fitsummary::FV0SumA, fitsummary::FV0SumAOuter, fitsummary::FV0RingSums,
+                  fitsummary::FV0NChannels, fitsummary::FV0Time, fitsummary::FV0TriggerMask,
+                  fitsummary::FDDSumA, fitsummary::FDDSumC,
+                  fitsummary::FDDNChannelsA, fitsummary::FDDNChannelsC,
+                  fitsummary::FDDTimeA, fitsummary::FDDTimeC, fitsummary::FDDTriggerMask);
+using FITSummary = FITSummaries::iterator;
+} // namespace o2::aod
+
+#endif // COMMON_DATAMODEL_FITSUMMARY_H_
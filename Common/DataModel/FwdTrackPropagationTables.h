@@ -0,0 +1,71 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FwdTrackPropagationTables.h
+/// \brief Table definitions for forward tracks propagated to the standard points (vertex, DCA, end of the absorber, MFT-MCH matching plane)
+
+#ifndef COMMON_DATAMODEL_FWDTRACKPROPAGATIONTABLES_H_
+#define COMMON_DATAMODEL_FWDTRACKPROPAGATIONTABLES_H_
+
+#include <Framework/AnalysisDataModel.h>
+
+namespace o2::aod
+{
+
+// Declares the parameters (FwdTrksAt<point>) and covariances (FwdTrksCovAt<point>) of the forward tracks
+// at one propagation point. The getters carry the point as suffix (e.g. xAtVtx()), so that the tables
+// of different points can be joined together and with FwdTracks.
+#define DECLARE_TABLES_FWDTRACK_PROPAGATED(_point_, _description_)                                          \
+  namespace fwdtrack_prop                                                                                 \
+  {                                                                                                       \
+  DECLARE_SOA_COLUMN(X##_point_, x##_point_, float);                 /*! x at the propagation point */    \
+  DECLARE_SOA_COLUMN(Y##_point_, y##_point_, float);                 /*! y at the propagation point */    \
+  DECLARE_SOA_COLUMN(Z##_point_, z##_point_, float);                 /*! z of the propagation point */    \
+  DECLARE_SOA_COLUMN(Phi##_point_, phi##_point_, float);             /*! phi at the propagation point */  \
+  DECLARE_SOA_COLUMN(Tgl##_point_, tgl##_point_, float);             /*! tan(lambda) */                   \
+  DECLARE_SOA_COLUMN(Signed1Pt##_point_, signed1Pt##_point_, float); /*! charge over pT */                \
+  DECLARE_SOA_COLUMN(CXX##_point_, cXX##_point_, float);             /*! covariance element */            \
+  DECLARE_SOA_COLUMN(CXY##_point_, cXY##_point_, float);             /*! covariance element */            \
+  DECLARE_SOA_COLUMN(CYY##_point_, cYY##_point_, float);             /*! covariance element */            \
+  DECLARE_SOA_COLUMN(CPhiX##_point_, cPhiX##_point_, float);         /*! covariance element */            \
+  DECLARE_SOA_COLUMN(CPhiY##_point_, cPhiY##_point_, float);         /*! covariance element */            \
+  DECLARE_SOA_COLUMN(CPhiPhi##_point_, cPhiPhi##_point_, float);     /*! covariance element */            \
+  DECLARE_SOA_COLUMN(CTglX##_point_, cTglX##_point_, float);         /*! covariance element */            \
+  DECLARE_SOA_COLUMN(CTglY##_point_, cTglY##_point_, float);         /*! covariance element */            \
+  DECLARE_SOA_COLUMN(CTglPhi##_point_, cTglPhi##_point_, float);     /*! covariance element */            \
+  DECLARE_SOA_COLUMN(CTglTgl##_point_, cTglTgl##_point_, float);     /*! covariance element */            \
+  DECLARE_SOA_COLUMN(C1PtX##_point_, c1PtX##_point_, float);         /*! covariance element */            \
+  DECLARE_SOA_COLUMN(C1PtY##_point_, c1PtY##_point_, float);         /*! covariance element */            \
+  DECLARE_SOA_COLUMN(C1PtPhi##_point_, c1PtPhi##_point_, float);     /*! covariance element */            \
+  DECLARE_SOA_COLUMN(C1PtTgl##_point_, c1PtTgl##_point_, float);     /*! covariance element */            \
+  DECLARE_SOA_COLUMN(C1Pt21Pt2##_point_, c1Pt21Pt2##_point_, float); /*! covariance element */            \
+  }                                                                                                       \
+  DECLARE_SOA_TABLE(FwdTrks##_point_, "AOD", "FWDTRK" _description_, /*! forward track parameters */      \
+                    fwdtrack_prop::X##_point_, fwdtrack_prop::Y##_point_, fwdtrack_prop::Z##_point_,      \
+                    fwdtrack_prop::Phi##_point_, fwdtrack_prop::Tgl##_point_,                             \
+                    fwdtrack_prop::Signed1Pt##_point_);                                                   \
+  DECLARE_SOA_TABLE(FwdTrksCov##_point_, "AOD", "FWDTRKCOV" _description_, /*! forward track cov. */      \
+                    fwdtrack_prop::CXX##_point_, fwdtrack_prop::CXY##_point_, fwdtrack_prop::CYY##_point_, \
+                    fwdtrack_prop::CPhiX##_point_, fwdtrack_prop::CPhiY##_point_,                         \
+                    fwdtrack_prop::CPhiPhi##_point_, fwdtrack_prop::CTglX##_point_,                       \
+                    fwdtrack_prop::CTglY##_point_, fwdtrack_prop::CTglPhi##_point_,                       \
+                    fwdtrack_prop::CTglTgl##_point_, fwdtrack_prop::C1PtX##_point_,                       \
+                    fwdtrack_prop::C1PtY##_point_, fwdtrack_prop::C1PtPhi##_point_,                       \
+                    fwdtrack_prop::C1PtTgl##_point_, fwdtrack_prop::C1Pt21Pt2##_point_);
+
+DECLARE_TABLES_FWDTRACK_PROPAGATED(AtVtx, "ATVTX");   // primary vertex, with MCS (MFT tracks: DCA point)
+DECLARE_TABLES_FWDTRACK_PROPAGATED(AtDCA, "ATDCA");   // z of the primary vertex, without Branson correction
+DECLARE_TABLES_FWDTRACK_PROPAGATED(AtRabs, "ATRABS"); // end of the absorber
+DECLARE_TABLES_FWDTRACK_PROPAGATED(AtMP, "ATMP");     // MFT-MCH matching plane
+
+} // namespace o2::aod
+
+#endif // COMMON_DATAMODEL_FWDTRACKPROPAGATIONTABLES_H_
@@ -8,6 +8,8 @@
 // In applying this license CERN does not waive the privileges and immunities
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
+#include "Common/Core/ConverterHelpers.h"
+
 #include <Framework/AnalysisDataModel.h>
 #include <Framework/AnalysisHelpers.h>
 #include <Framework/AnalysisTask.h>
@@ -23,27 +25,15 @@ using namespace o2::framework;
 struct McConverter {
   Produces<aod::StoredMcParticles_001> mcParticles_001;
 
+  std::vector<int> mothers; // reused for all particles to avoid an allocation per row
+
   void process(aod::StoredMcParticles_000 const& mcParticles_000)
   {
     mcParticles_001.reserve(mcParticles_000.size());
-    for (auto& p : mcParticles_000) {
-
-      std::vector<int> mothers;
-      if (p.mother0Id() >= 0) {
-        mothers.push_back(p.mother0Id());
-      }
-      if (p.mother1Id() >= 0) {
-        mothers.push_back(p.mother1Id());
-      }
-
-      int daughters[2] = {-1, -1};
-      if (p.daughter0Id() >= 0 && p.daughter1Id() >= 0) {
-        daughters[0] = p.daughter0Id();
-        daughters[1] = p.daughter1Id();
-      } else if (p.daughter0Id() >= 0) {
-        daughters[0] = p.daughter0Id();
-        daughters[1] = p.daughter0Id();
-      }
+    for (const auto& p : mcParticles_000) {
+      o2::aod::converters::mothersFromIndices(p.mother0Id(), p.mother1Id(), mothers);
+      int daughters[2];
+      o2::aod::converters::daughterRangeFromIndices(p.daughter0Id(), p.daughter1Id(), daughters);
 
       mcParticles_001(p.mcCollisionId(), p.pdgCode(), p.statusCode(), p.flags(),
                       mothers, daughters, p.weight(), p.px(), p.py(), p.pz(), p.e(),
@@ -19,6 +19,8 @@
 
 /// \author F.Mazzaschi <fmazzasc@cern.ch>
 
+#include "Common/Core/ConverterHelpers.h"
+
 #include <Framework/AnalysisDataModel.h>
 #include <Framework/AnalysisHelpers.h>
 #include <Framework/AnalysisTask.h>
@@ -37,12 +39,7 @@ struct TracksExtraConverter {
 
     for (const auto& track0 : tracksExtra_000) {
 
-      uint32_t itsClusterSizes = 0;
-      for (int layer = 0; layer < 7; layer++) {
-        if (track0.itsClusterMap() & (1 << layer)) {
-          itsClusterSizes |= (0xf << (layer * 4));
-        }
-      }
+      const uint32_t itsClusterSizes = o2::aod::converters::itsClusterSizesFromClusterMap(track0.itsClusterMap());
 
       tracksExtra_001(track0.tpcInnerParam(),
                       track0.flags(),
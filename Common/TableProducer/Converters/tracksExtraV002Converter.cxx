@@ -9,6 +9,8 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 
+#include "Common/Core/ConverterHelpers.h"
+
 #include <Framework/AnalysisDataModel.h>
 #include <Framework/AnalysisHelpers.h>
 #include <Framework/AnalysisTask.h>
@@ -40,12 +42,7 @@ struct TracksExtraV002Converter {
 
     for (const auto& track0 : tracksExtra_000) {
 
-      uint32_t itsClusterSizes = 0;
-      for (int layer = 0; layer < 7; layer++) {
-        if (track0.itsClusterMap() & (1 << layer)) {
-          itsClusterSizes |= (0xf << (layer * 4));
-        }
-      }
+      const uint32_t itsClusterSizes = o2::aod::converters::itsClusterSizesFromClusterMap(track0.itsClusterMap());
 
       int8_t TPCNClsFindableMinusPID = 0;
 
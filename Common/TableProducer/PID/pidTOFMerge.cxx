@@ -52,6 +52,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -363,9 +364,40 @@ struct tofEventTime {
   Preslice<Run3TrksWtof> perCollision = aod::track::collisionId;
   template <o2::track::PID::ID pid>
   using ResponseImplementationEvTime = o2::pid::tof::ExpTimes<Run3TrksWtof::iterator, pid>;
+
+  // TOF event time of each collision, computed once per DF before the per-track tables are filled
+  std::vector<std::optional<o2::tof::eventTimeContainer>> evTimeTOFPerCollision;
+  // Running TOF event time of each collision, from which the bias of the tracks is removed one after the other
+  struct EvTimeBiasState {
+    int nGoodTracks = 0;
+    float eventTime = 0.f;
+    float eventTimeError = 999.f;
+  };
+  std::vector<EvTimeBiasState> evTimeBiasStatePerCollision;
+
+  /// Computes the TOF event time for all collisions of the DF.
+  /// Collisions without tracks, or not passing sel8 if requested, are left without event time.
+  void computeEvTimeTOFPerCollision(Run3TrksWtof const& tracks, EvTimeCollisionsFT0 const& collisions)
+  {
+    evTimeTOFPerCollision.clear();
+    evTimeTOFPerCollision.resize(collisions.size());
+    evTimeBiasStatePerCollision.assign(collisions.size(), EvTimeBiasState{});
+    for (auto const& collision : collisions) {
+      if ((sel8TOFEvTime.value == true) && !collision.sel8()) {
+        continue;
+      }
+      const auto& tracksInCollision = tracks.sliceBy(perCollision, collision.globalIndex());
+      if (tracksInCollision.size() == 0) {
+        continue;
+      }
+      auto& evTime = evTimeTOFPerCollision[collision.globalIndex()];
+      evTime.emplace(evTimeMakerForTracks<Run3TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, tofResponse->parameters, kDiamond));
+      evTimeBiasStatePerCollision[collision.globalIndex()] = {0, static_cast<float>(evTime->mEventTime), static_cast<float>(evTime->mEventTimeError)};
+    }
+  }
   void processRun3(Run3TrksWtof const& tracks,
                    aod::FT0s const&,
-                   EvTimeCollisionsFT0 const&,
+                   EvTimeCollisionsFT0 const& collisions,
                    aod::BCsWithTimestamps const& bcs)
   {
     if (!enableTableTOFEvTime) {
@@ -399,9 +431,9 @@ struct tofEventTime {
     LOG(debug) << "Running on " << CollisionSystemType::getCollisionSystemName(tofResponse->cfgCollisionType()) << " mComputeEvTimeWithTOF " << mComputeEvTimeWithTOF.value << " mComputeEvTimeWithFT0 " << mComputeEvTimeWithFT0.value;
 
     if (mComputeEvTimeWithTOF == 1 && mComputeEvTimeWithFT0 == 1) {
-      int lastCollisionId = -1;                                                                                       // Last collision ID analysed
-      for (auto const& t : tracks) {                                                                                  // Loop on collisions
-        if (!t.has_collision() || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisionsFT0>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
+      computeEvTimeTOFPerCollision(tracks, collisions);
+      for (auto const& trk : tracks) {                                                       // Loop on tracks, in the original order
+        if (!trk.has_collision() || !evTimeTOFPerCollision[trk.collisionId()].has_value()) { // Track was not assigned, cannot compute event time or event did not pass the event selection
           tableFlags(0);
           tableEvTime(0.f, 999.f);
           if (enableTableEvTimeTOFOnly) {
@@ -409,75 +441,57 @@ struct tofEventTime {
           }
           continue;
         }
-        if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
-          continue;
-        }
-        /// Create new table for the tracks in a collision
-        lastCollisionId = t.collisionId(); /// Cache last collision ID
-
-        const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
-        const auto& collision = t.collision_as<EvTimeCollisionsFT0>();
-
-        // Compute the TOF event time
-        const auto evTimeMakerTOF = evTimeMakerForTracks<Run3TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, tofResponse->parameters, kDiamond);
-        float t0AC[2] = {.0f, 999.f};                                                                                             // Value and error of T0A or T0C or T0AC
-        float t0TOF[2] = {static_cast<float_t>(evTimeMakerTOF.mEventTime), static_cast<float_t>(evTimeMakerTOF.mEventTimeError)}; // Value and error of TOF
+        const auto& evTimeMakerTOF = *evTimeTOFPerCollision[trk.collisionId()];
+        auto& t0TOF = evTimeBiasStatePerCollision[trk.collisionId()]; // Value and error of TOF, with the bias of the previous tracks of the collision removed
+        const auto& collision = trk.collision_as<EvTimeCollisionsFT0>();
+        float t0AC[2] = {.0f, 999.f}; // Value and error of T0A or T0C or T0AC
 
         uint8_t flags = 0;
-        int nGoodTracksForTOF = 0;
         float eventTime = 0.f;
         float sumOfWeights = 0.f;
         float weight = 0.f;
 
-        for (auto const& trk : tracksInCollision) { // Loop on Tracks
-          // Reset the flag
-          flags = 0;
-          // Reset the event time
-          eventTime = 0.f;
-          sumOfWeights = 0.f;
-          weight = 0.f;
-          // Remove the bias on TOF ev. time
-          if constexpr (kRemoveTOFEvTimeBias) {
-            evTimeMakerTOF.removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(trk, nGoodTracksForTOF, t0TOF[0], t0TOF[1], 2);
-          }
-          if (t0TOF[1] < kErrDiamond && (maxEvTimeTOF <= 0 || std::abs(t0TOF[0]) < maxEvTimeTOF)) {
-            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
+        // Remove the bias on TOF ev. time
+        if constexpr (kRemoveTOFEvTimeBias) {
+          evTimeMakerTOF.removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(trk, t0TOF.nGoodTracks, t0TOF.eventTime, t0TOF.eventTimeError, 2);
+        }
+        if (t0TOF.eventTimeError < kErrDiamond && (maxEvTimeTOF <= 0 || std::abs(t0TOF.eventTime) < maxEvTimeTOF)) {
+          flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
 
-            weight = 1.f / (t0TOF[1] * t0TOF[1]);
-            eventTime += t0TOF[0] * weight;
-            sumOfWeights += weight;
-          }
+          weight = 1.f / (t0TOF.eventTimeError * t0TOF.eventTimeError);
+          eventTime += t0TOF.eventTime * weight;
+          sumOfWeights += weight;
+        }
 
-          if (collision.has_foundFT0()) { // T0 measurement is available
-            // const auto& ft0 = collision.foundFT0();
-            if (collision.t0ACValid()) {
-              t0AC[0] = collision.t0AC() * 1000.f;
-              t0AC[1] = collision.t0resolution() * 1000.f;
-              flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeT0AC;
-            }
-
-            weight = 1.f / (t0AC[1] * t0AC[1]);
-            eventTime += t0AC[0] * weight;
-            sumOfWeights += weight;
+        if (collision.has_foundFT0()) { // T0 measurement is available
+          // const auto& ft0 = collision.foundFT0();
+          if (collision.t0ACValid()) {
+            t0AC[0] = collision.t0AC() * 1000.f;
+            t0AC[1] = collision.t0resolution() * 1000.f;
+            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeT0AC;
           }
 
-          if (sumOfWeights < kWeightDiamond) { // avoiding sumOfWeights = 0 or worse that kDiamond
-            eventTime = 0;
-            sumOfWeights = kWeightDiamond;
-            tableFlags(0);
-          } else {
-            tableFlags(flags);
-          }
-          tableEvTime(eventTime / sumOfWeights, std::sqrt(1. / sumOfWeights));
-          if (enableTableEvTimeTOFOnly) {
-            tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), t0TOF[0], t0TOF[1], evTimeMakerTOF.mEventTimeMultiplicity);
-          }
+          weight = 1.f / (t0AC[1] * t0AC[1]);
+          eventTime += t0AC[0] * weight;
+          sumOfWeights += weight;
+        }
+
+        if (sumOfWeights < kWeightDiamond) { // avoiding sumOfWeights = 0 or worse that kDiamond
+          eventTime = 0;
+          sumOfWeights = kWeightDiamond;
+          tableFlags(0);
+        } else {
+          tableFlags(flags);
+        }
+        tableEvTime(eventTime / sumOfWeights, std::sqrt(1. / sumOfWeights));
+        if (enableTableEvTimeTOFOnly) {
+          tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), t0TOF.eventTime, t0TOF.eventTimeError, evTimeMakerTOF.mEventTimeMultiplicity);
         }
       }
     } else if (mComputeEvTimeWithTOF == 1 && mComputeEvTimeWithFT0 == 0) {
-      int lastCollisionId = -1;                                                                                    // Last collision ID analysed
-      for (auto const& t : tracks) {                                                                               // Loop on collisions
-        if (!t.has_collision() || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisions>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
+      computeEvTimeTOFPerCollision(tracks, collisions);
+      for (auto const& trk : tracks) {                                                       // Loop on tracks, in the original order
+        if (!trk.has_collision() || !evTimeTOFPerCollision[trk.collisionId()].has_value()) { // Track was not assigned, cannot compute event time or event did not pass the event selection
           tableFlags(0);
           tableEvTime(0.f, 999.f);
           if (enableTableEvTimeTOFOnly) {
@@ -485,36 +499,25 @@ struct tofEventTime {
           }
           continue;
         }
-        if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
-          continue;
-        }
-        /// Create new table for the tracks in a collision
-        lastCollisionId = t.collisionId(); /// Cache last collision ID
-
-        const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
-
-        // First make table for event time
-        const auto evTimeMakerTOF = evTimeMakerForTracks<Run3TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, tofResponse->parameters, kDiamond);
-        int nGoodTracksForTOF = 0;
-        float et = evTimeMakerTOF.mEventTime;
-        float erret = evTimeMakerTOF.mEventTimeError;
+        const auto& evTimeMakerTOF = *evTimeTOFPerCollision[trk.collisionId()];
+        auto& state = evTimeBiasStatePerCollision[trk.collisionId()];
+        float& et = state.eventTime;
+        float& erret = state.eventTimeError;
 
-        for (auto const& trk : tracksInCollision) { // Loop on Tracks
-          if constexpr (kRemoveTOFEvTimeBias) {
-            evTimeMakerTOF.removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(trk, nGoodTracksForTOF, et, erret, 2);
-          }
-          uint8_t flags = 0;
-          if (erret < kErrDiamond && (maxEvTimeTOF <= 0.f || std::abs(et) < maxEvTimeTOF)) {
-            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
-          } else {
-            et = 0.f;
-            erret = kErrDiamond;
-          }
-          tableFlags(flags);
-          tableEvTime(et, erret);
-          if (enableTableEvTimeTOFOnly) {
-            tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), et, erret, evTimeMakerTOF.mEventTimeMultiplicity);
-          }
+        if constexpr (kRemoveTOFEvTimeBias) {
+          evTimeMakerTOF.removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(trk, state.nGoodTracks, et, erret, 2);
+        }
+        uint8_t flags = 0;
+        if (erret < kErrDiamond && (maxEvTimeTOF <= 0.f || std::abs(et) < maxEvTimeTOF)) {
+          flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
+        } else {
+          et = 0.f;
+          erret = kErrDiamond;
+        }
+        tableFlags(flags);
+        tableEvTime(et, erret);
+        if (enableTableEvTimeTOFOnly) {
+          tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), et, erret, evTimeMakerTOF.mEventTimeMultiplicity);
         }
       }
     } else if (mComputeEvTimeWithTOF == 0 && mComputeEvTimeWithFT0 == 1) {
@@ -0,0 +1,42 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file fitSummaryTable.cxx
+/// \brief Produces the per-BC FIT summary (amplitude sums, ring sums, channel counts, times and trigger masks)
+///        so that the consumers do not walk the FT0, FV0 and FDD amplitude arrays again
+
+#include "Common/DataModel/FITSummary.h"
+#include "Common/Tools/FITSummaryModule.h"
+
+#include <Framework/AnalysisDataModel.h>
+#include <Framework/AnalysisHelpers.h>
+#include <Framework/AnalysisTask.h>
+#include <Framework/runDataProcessing.h>
+
+using namespace o2;
+using namespace o2::framework;
+
+struct FitSummaryTable {
+  Produces<aod::FITSummaries> fitSummaries;
+
+  o2::common::fitsummary::FITSummaryModule module;
+
+  void process(aod::BCs const& bcs, aod::FT0s const& ft0s, aod::FV0As const& fv0s, aod::FDDs const& fdds)
+  {
+    module.process(ft0s, fv0s, fdds);
+    module.fillTable(fitSummaries, bcs.size());
+  }
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{adaptAnalysisTask<FitSummaryTable>(cfgc)};
+}
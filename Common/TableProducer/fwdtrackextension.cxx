@@ -11,11 +11,13 @@
 
 //
 // \file fwdtrackextension.cxx
-// \brief Task performing forward track DCA computation.
+// \brief Task performing forward track DCA computation and propagation to the standard points.
 // \author Maurice Coquet, maurice.louis.coquet@cern.ch
 //
 
+#include "Common/Core/TableHelper.h"
 #include "Common/Core/fwdtrackUtilities.h"
+#include "Common/DataModel/FwdTrackPropagationTables.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 
 #include <CCDB/BasicCCDBManager.h>
@@ -36,6 +38,7 @@
 #include <Math/MatrixRepresentationsStatic.h>
 #include <Math/SMatrix.h>
 
+#include <array>
 #include <numbers>
 #include <string>
 
@@ -50,35 +53,84 @@ using MuonsWithCov = soa::Join<aod::FwdTracks, aod::FwdTracksCov>;
 
 struct FwdTrackExtension {
   Produces<aod::FwdTracksDCA> fwdDCA;
+  // propagated states, filled only if requested in the workflow, so that the consumers do not propagate again
+  Produces<aod::FwdTrksAtVtx> fwdAtVtx;
+  Produces<aod::FwdTrksCovAtVtx> fwdCovAtVtx;
+  Produces<aod::FwdTrksAtDCA> fwdAtDCA;
+  Produces<aod::FwdTrksCovAtDCA> fwdCovAtDCA;
+  Produces<aod::FwdTrksAtRabs> fwdAtRabs;
+  Produces<aod::FwdTrksCovAtRabs> fwdCovAtRabs;
+  Produces<aod::FwdTrksAtMP> fwdAtMP;
+  Produces<aod::FwdTrksCovAtMP> fwdCovAtMP;
   Configurable<std::string> geoPath{"geoPath", "GLO/Config/GeometryAligned", "Path of the geometry file"};
   Configurable<std::string> grpmagPath{"grpmagPath", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object"};
   Configurable<std::string> configCcdbUrl{"configCcdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<bool> propInTheAbsorber{"propInTheAbsorber", false, "Propagate muon in the absober: false to minimize standalone muons DCA calculation"};
   Configurable<bool> refitGlobalMuon{"refitGlobalMuon", false, "Recompute parameters of global muons"};
+  Configurable<float> matchingZ{"matchingZ", -77.5, "z position of the MFT-MCH matching plane for the propagated tracks"};
 
   Service<o2::ccdb::BasicCCDBManager> fCCDB;
   o2::parameters::GRPMagField* grpmag = nullptr; // for run 3, we access GRPMagField from GLO/Config/GRPMagField
   int fCurrentRun;                               // needed to detect if the run changed and trigger update of magnetic field
 
-  void init(o2::framework::InitContext&)
+  static constexpr int NPoints = 4; // propagation points, indexed by fwdtrackutils::propagationPoint
+  std::array<bool, NPoints> fillAt{};
+  std::array<bool, NPoints> fillCovAt{};
+  bool propagateToPoints = false;
+
+  void init(o2::framework::InitContext& initContext)
   {
+    const std::array<std::string, NPoints> pointNames{"Vtx", "DCA", "Rabs", "MP"};
+    for (int i = 0; i < NPoints; i++) {
+      fillCovAt[i] = o2::common::core::isTableRequiredInWorkflow(initContext, "FwdTrksCovAt" + pointNames[i]);
+      fillAt[i] = fillCovAt[i] || o2::common::core::isTableRequiredInWorkflow(initContext, "FwdTrksAt" + pointNames[i]);
+      if (fillAt[i]) {
+        LOG(info) << "Will generate FwdTrksAt" << pointNames[i] << (fillCovAt[i] ? " with covariances" : "");
+      }
+      propagateToPoints = propagateToPoints || fillAt[i];
+    }
+
     // Load geometry
     fCCDB->setURL(configCcdbUrl);
     fCCDB->setCaching(true);
     fCCDB->setLocalObjectValidityChecking();
 
-    if (propInTheAbsorber && !o2::base::GeometryManager::isGeometryLoaded()) {
+    if ((propInTheAbsorber || propagateToPoints) && !o2::base::GeometryManager::isGeometryLoaded()) {
       LOGF(info, "Load geometry from CCDB");
       fCCDB->get<TGeoManager>(geoPath);
     }
   }
 
+  template <typename TCursor, typename TCovCursor>
+  void fillPropagated(o2::dataformats::GlobalFwdTrack const* propTrack, int point, TCursor& cursor, TCovCursor& covCursor)
+  {
+    if (!fillAt[point]) {
+      return;
+    }
+    if (propTrack == nullptr) { // track without collision
+      cursor(-999.f, -999.f, -999.f, -999.f, -999.f, -999.f);
+      if (fillCovAt[point]) {
+        covCursor(0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+      }
+      return;
+    }
+    cursor(propTrack->getX(), propTrack->getY(), propTrack->getZ(), propTrack->getPhi(), propTrack->getTgl(), propTrack->getInvQPt());
+    if (fillCovAt[point]) {
+      const auto& cov = propTrack->getCovariances();
+      covCursor(cov(0, 0), cov(0, 1), cov(1, 1), cov(2, 0), cov(2, 1), cov(2, 2), cov(3, 0), cov(3, 1), cov(3, 2), cov(3, 3), cov(4, 0), cov(4, 1), cov(4, 2), cov(4, 3), cov(4, 4));
+    }
+  }
+
   void process(MuonsWithCov const& tracks, aod::MFTTracks const& /*...*/, o2::aod::BCsWithTimestamps const& /*...*/, aod::Collisions const& /*...*/)
   {
+    using o2::aod::fwdtrackutils::propagationPoint;
+    std::array<o2::dataformats::GlobalFwdTrack, NPoints> propTracks;
+
     for (const auto& track : tracks) {
       const auto trackType = track.trackType();
       float dcaX = -999;
       float dcaY = -999;
+      bool isPropagated = false;
       if (track.has_collision()) {
         auto const& collision = track.collision();
         auto bc = collision.template bc_as<o2::aod::BCsWithTimestamps>();
@@ -88,7 +140,7 @@ struct FwdTrackExtension {
             LOGF(info, "Init field from GRP");
             o2::base::Propagator::initFieldFromGRP(grpmag);
           }
-          if (propInTheAbsorber) {
+          if (propInTheAbsorber || propagateToPoints) {
             LOGF(info, "Set field for muons");
             o2::mch::TrackExtrap::setField();
           }
@@ -96,6 +148,16 @@ struct FwdTrackExtension {
         }
         const float zField = grpmag->getNominalL3Field();
 
+        // each requested point is propagated once, the DCA below reuses the state at the DCA point
+        if (propagateToPoints) {
+          for (int i = 0; i < NPoints; i++) {
+            if (fillAt[i]) {
+              propTracks[i] = o2::aod::fwdtrackutils::propagateMuon(track, track, collision, static_cast<propagationPoint>(i), matchingZ, zField);
+            }
+          }
+          isPropagated = true;
+        }
+
         o2::track::TrackParCovFwd fwdtrack = o2::aod::fwdtrackutils::getTrackParCovFwdShift(track, 0.0);
         if (refitGlobalMuon && (trackType == o2::aod::fwdtrack::ForwardTrackTypeEnum::GlobalMuonTrack || trackType == o2::aod::fwdtrack::ForwardTrackTypeEnum::GlobalForwardTrack)) {
           auto muontrack = track.template matchMCHTrack_as<MuonsWithCov>();
@@ -109,6 +171,11 @@ struct FwdTrackExtension {
         if (!propInTheAbsorber && (trackType == o2::aod::fwdtrack::ForwardTrackTypeEnum::MuonStandaloneTrack || trackType == o2::aod::fwdtrack::ForwardTrackTypeEnum::MCHStandaloneTrack)) {
           dcaX = track.pDca() / std::numbers::sqrt2 / track.p();
           dcaY = dcaX;
+        } else if (fillAt[static_cast<int>(propagationPoint::kToDCA)] && !refitGlobalMuon) {
+          // the propagated parameters do not depend on the covariance
+          const auto& proptrack = propTracks[static_cast<int>(propagationPoint::kToDCA)];
+          dcaX = (proptrack.getX() - collision.posX());
+          dcaY = (proptrack.getY() - collision.posY());
         } else {
           auto proptrack = o2::aod::fwdtrackutils::propagateTrackParCovFwd(fwdtrack, trackType, collision, o2::aod::fwdtrackutils::propagationPoint::kToDCA, 0.f, zField);
           dcaX = (proptrack.getX() - collision.posX());
@@ -116,6 +183,12 @@ struct FwdTrackExtension {
         }
       }
       fwdDCA(dcaX, dcaY);
+      if (propagateToPoints) {
+        fillPropagated(isPropagated ? &propTracks[static_cast<int>(propagationPoint::kToVertex)] : nullptr, static_cast<int>(propagationPoint::kToVertex), fwdAtVtx, fwdCovAtVtx);
+        fillPropagated(isPropagated ? &propTracks[static_cast<int>(propagationPoint::kToDCA)] : nullptr, static_cast<int>(propagationPoint::kToDCA), fwdAtDCA, fwdCovAtDCA);
+        fillPropagated(isPropagated ? &propTracks[static_cast<int>(propagationPoint::kToRabs)] : nullptr, static_cast<int>(propagationPoint::kToRabs), fwdAtRabs, fwdCovAtRabs);
+        fillPropagated(isPropagated ? &propTracks[static_cast<int>(propagationPoint::kToMatchingPlane)] : nullptr, static_cast<int>(propagationPoint::kToMatchingPlane), fwdAtMP, fwdCovAtMP);
+      }
     }
   }
 };
@@ -25,6 +25,7 @@
 #include "Common/Core/MetadataHelper.h"
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
+#include "Common/Tools/FITSummaryModule.h"
 #include "Common/Tools/Multiplicity/MultModule.h"
 
 #include <CCDB/BasicCCDBManager.h>
@@ -49,6 +50,7 @@ struct MultCentTable {
   o2::common::multiplicity::standardConfigurables opts;
   o2::common::multiplicity::products products;
   o2::common::multiplicity::MultModule module;
+  o2::common::fitsummary::FITSummaryModule fitSummary;
 
   // CCDB boilerplate declarations
   o2::framework::Configurable<std::string> ccdburl{"ccdburl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
@@ -98,17 +100,18 @@ struct MultCentTable {
                    soa::Join<aod::TracksIU, aod::TracksExtra> const& tracks,
                    soa::Join<aod::BCs, aod::Timestamps, aod::Run3MatchedToBCSparse> const&,
                    aod::Zdcs const&,
-                   aod::FV0As const&,
-                   aod::FT0s const&,
-                   aod::FDDs const&)
+                   aod::FV0As const& fv0s,
+                   aod::FT0s const& ft0s,
+                   aod::FDDs const& fdds)
   {
     mults.clear();
+    fitSummary.process(ft0s, fv0s, fdds); // also read by the BC centralities
     for (auto const& collision : collisions) {
       o2::common::multiplicity::multEntry mult;
       const auto& bc = collision.bc_as<soa::Join<aod::BCs, aod::Timestamps, aod::Run3MatchedToBCSparse>>();
       const uint64_t collIdx = collision.globalIndex();
       auto tracksThisCollision = tracks.sliceBy(slicerTracksIU, collIdx);
-      mult = module.collisionProcessRun3(ccdb, metadataInfo, collision, tracksThisCollision, bc, products);
+      mult = module.collisionProcessRun3(ccdb, metadataInfo, collision, tracksThisCollision, bc, fitSummary, products);
       mults.push_back(mult);
     }
   }
@@ -117,17 +120,18 @@ struct MultCentTable {
                                      soa::Join<aod::TracksIU, aod::TracksExtra, aod::TrackSelection, aod::TrackSelectionExtension> const& tracks,
                                      soa::Join<aod::BCs, aod::Timestamps, aod::Run3MatchedToBCSparse> const&,
                                      aod::Zdcs const&,
-                                     aod::FV0As const&,
-                                     aod::FT0s const&,
-                                     aod::FDDs const&)
+                                     aod::FV0As const& fv0s,
+                                     aod::FT0s const& ft0s,
+                                     aod::FDDs const& fdds)
   {
     mults.clear();
+    fitSummary.process(ft0s, fv0s, fdds); // also read by the BC centralities
     for (auto const& collision : collisions) {
       o2::common::multiplicity::multEntry mult;
       const auto& bc = collision.bc_as<soa::Join<aod::BCs, aod::Timestamps, aod::Run3MatchedToBCSparse>>();
       const uint64_t collIdx = collision.globalIndex();
       auto tracksThisCollision = tracks.sliceBy(slicerTracksIUwithSelections, collIdx);
-      mult = module.collisionProcessRun3(ccdb, metadataInfo, collision, tracksThisCollision, bc, products);
+      mult = module.collisionProcessRun3(ccdb, metadataInfo, collision, tracksThisCollision, bc, fitSummary, products);
       mults.push_back(mult);
     }
   }
@@ -168,7 +172,7 @@ struct MultCentTable {
     }
     module.generateCentralitiesRun2(ccdb, metadataInfo, bcs, mults, products);
   }
-  void processCentralityRun3(aod::Collisions const& collisions, soa::Join<aod::BCs, aod::BcSels, aod::Timestamps> const& bcs, aod::FT0s const&)
+  void processCentralityRun3(aod::Collisions const& collisions, soa::Join<aod::BCs, aod::BcSels, aod::Timestamps> const& bcs)
   {
     // it is important that this function is at the end of the other process functions.
     // it requires `mults` to be properly set, which will only happen after the other process
@@ -181,7 +185,7 @@ struct MultCentTable {
     if (collisions.size() != static_cast<int64_t>(mults.size())) {
       LOGF(fatal, "Size of collisions doesn't match size of multiplicity buffer!");
     }
-    module.generateCentralitiesRun3(ccdb, metadataInfo, bcs, mults, products);
+    module.generateCentralitiesRun3(ccdb, metadataInfo, bcs, fitSummary, mults, products);
   }
 
   PROCESS_SWITCH(MultCentTable, processRun2, "Process Run 2", false);
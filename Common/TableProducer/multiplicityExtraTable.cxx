@@ -10,6 +10,7 @@
 // or submit itself to any jurisdiction.
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/Multiplicity.h"
+#include "Common/Tools/FITSummaryModule.h"
 
 #include <CCDB/BasicCCDBManager.h>
 #include <CCDB/CcdbApi.h>
@@ -74,6 +75,9 @@ struct MultiplicityExtraTable {
   int newRunNumber = -999;
   int oldRunNumber = -999;
 
+  // FIT amplitude sums, computed once per time frame for both BC loops
+  o2::common::fitsummary::FITSummaryModule fitSummary;
+
   void init(InitContext&)
   {
     randomSeed = static_cast<unsigned int>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
@@ -86,7 +90,7 @@ struct MultiplicityExtraTable {
 
   using BCsWithRun3Matchings = soa::Join<aod::BCs, aod::Timestamps, aod::Run3MatchedToBCSparse>;
 
-  void processBCs(soa::Join<BCsWithRun3Matchings, aod::BCFlags, aod::BcSels> const& bcs, aod::FV0As const&, aod::FT0s const&, aod::FDDs const&, aod::Zdcs const&, soa::Join<aod::Collisions, aod::EvSels> const& collisions)
+  void processBCs(soa::Join<BCsWithRun3Matchings, aod::BCFlags, aod::BcSels> const& bcs, aod::FV0As const& fv0s, aod::FT0s const& ft0s, aod::FDDs const& fdds, aod::Zdcs const&, soa::Join<aod::Collisions, aod::EvSels> const& collisions)
   {
     //+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+
     // determine saved BCs and corresponding new BC table index
@@ -94,6 +98,7 @@ struct MultiplicityExtraTable {
     std::vector<int> newBCindex(bcs.size());
     std::vector<int> bc2multArray(bcs.size());
     int atIndex = 0;
+    fitSummary.process(ft0s, fv0s, fdds);
     for (const auto& bc : bcs) {
       bcHasCollision[bc.globalIndex()] = false;
       newBCindex[bc.globalIndex()] = -1;
@@ -115,10 +120,7 @@ struct MultiplicityExtraTable {
 
       float multFT0C = 0.f;
       if (bc.has_ft0()) {
-        auto ft0 = bc.ft0();
-        for (auto amplitude : ft0.amplitudeC()) {
-          multFT0C += amplitude;
-        }
+        multFT0C = fitSummary.ft0(bc.ft0Id()).sumC;
       } else {
         multFT0C = -999.0f;
       }
@@ -196,16 +198,11 @@ struct MultiplicityExtraTable {
         Tvx = triggers[o2::fit::Triggers::bitVertex];
         multFT0TriggerBits = static_cast<uint8_t>(triggers.to_ulong());
 
-        // calculate T0 charge
-        for (size_t ii = 0; ii < ft0.amplitudeA().size(); ++ii) {
-          multFT0A += ft0.amplitudeA()[ii];
-          if (ft0.channelA()[ii] > 31) {
-            multFT0AOuter += ft0.amplitudeA()[ii];
-          }
-        }
-        for (auto amplitude : ft0.amplitudeC()) {
-          multFT0C += amplitude;
-        }
+        // T0 charge
+        const auto& ft0Summary = fitSummary.ft0(bc.ft0Id());
+        multFT0A = ft0Summary.sumA;
+        multFT0AOuter = ft0Summary.sumAOuter;
+        multFT0C = ft0Summary.sumC;
         posZFT0 = ft0.posZ();
         posZFT0valid = ft0.isValidTime();
       } else {
@@ -217,14 +214,9 @@ struct MultiplicityExtraTable {
         std::bitset<8> fV0Triggers = fv0.triggerMask();
         multFV0TriggerBits = static_cast<uint8_t>(fV0Triggers.to_ulong());
 
-        for (size_t ii = 0; ii < fv0.amplitude().size(); ii++) {
-          auto amplitude = fv0.amplitude()[ii];
-          auto channel = fv0.channel()[ii];
-          multFV0A += amplitude;
-          if (channel > 7) {
-            multFV0AOuter += amplitude;
-          }
-        }
+        const auto& fv0Summary = fitSummary.fv0(bc.fv0aId());
+        multFV0A = fv0Summary.sumA;
+        multFV0AOuter = fv0Summary.sumAOuter;
         isFV0OrA = fV0Triggers[o2::fit::Triggers::bitA];
       } else {
         multFV0A = -999.0f;
@@ -235,12 +227,9 @@ struct MultiplicityExtraTable {
         std::bitset<8> fFDDTriggers = fdd.triggerMask();
         multFDDTriggerBits = static_cast<uint8_t>(fFDDTriggers.to_ulong());
 
-        for (auto amplitude : fdd.chargeA()) {
-          multFDDA += amplitude;
-        }
-        for (auto amplitude : fdd.chargeC()) {
-          multFDDC += amplitude;
-        }
+        const auto& fddSummary = fitSummary.fdd(bc.fddId());
+        multFDDA = fddSummary.sumA;
+        multFDDC = fddSummary.sumC;
       } else {
         multFDDA = -999.0f;
         multFDDC = -999.0f;
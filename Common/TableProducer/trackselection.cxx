@@ -21,6 +21,7 @@
 
 #include "Common/Core/TableHelper.h"
 #include "Common/Core/TrackSelectionDefaults.h"
+#include "Common/Core/TrackSelectionMatrix.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 
 #include <Framework/AnalysisDataModel.h>
@@ -32,6 +33,7 @@
 #include <Framework/runDataProcessing.h>
 
 #include <cstdint>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -65,6 +67,17 @@ struct TrackSelectionTask {
   TrackSelection filtBit4;
   TrackSelection filtBit5;
 
+  // All the selections above evaluated together, each distinct cut once per track
+  TrackSelectionMatrix selectionMatrix;
+  int idxGlobalTracks = -1;
+  int idxGlobalTracksSDD = -1;
+  int idxFiltBit1 = -1;
+  int idxFiltBit2 = -1;
+  int idxFiltBit3 = -1;
+  int idxFiltBit4 = -1;
+  int idxFiltBit5 = -1;
+  std::vector<TrackSelectionMatrix::PredicateWord> predicateWords;
+
   void init(InitContext& initContext)
   {
     // Check which tables are used
@@ -142,6 +155,17 @@ struct TrackSelectionTask {
 
     LOG(info) << "setting up filtBit5 = getJEGlobalTrackSelectionRun2();";
     filtBit5 = getJEGlobalTrackSelectionRun2(); // Jet validation requires reduced set of cuts
+
+    idxGlobalTracks = selectionMatrix.add(globalTracks);
+    if (!isRun3) {
+      idxGlobalTracksSDD = selectionMatrix.add(globalTracksSDD);
+    }
+    idxFiltBit1 = selectionMatrix.add(filtBit1);
+    idxFiltBit2 = selectionMatrix.add(filtBit2);
+    idxFiltBit3 = selectionMatrix.add(filtBit3);
+    idxFiltBit4 = selectionMatrix.add(filtBit4);
+    idxFiltBit5 = selectionMatrix.add(filtBit5);
+    selectionMatrix.print();
   }
 
   void process(soa::Join<aod::FullTracks, aod::TracksDCA> const& tracks)
@@ -155,25 +179,26 @@ struct TrackSelectionTask {
     if (produceTable == 0 && produceFBextendedTable == 0) {
       return;
     }
+    selectionMatrix.evaluate(tracks, predicateWords);
     if (isRun3) {
-      for (const auto& track : tracks) {
+      for (const auto& word : predicateWords) {
+        o2::aod::track::TrackSelectionFlags::flagtype trackflagGlob = selectionMatrix.mask(word, idxGlobalTracks);
 
         if (produceTable == 1) {
           filterTable((uint8_t)0,
-                      globalTracks.IsSelectedMask(track),
-                      filtBit1.IsSelected(track),
-                      filtBit2.IsSelected(track),
-                      filtBit3.IsSelected(track),
-                      filtBit4.IsSelected(track),
-                      filtBit5.IsSelected(track));
+                      trackflagGlob,
+                      selectionMatrix.isSelected(word, idxFiltBit1),
+                      selectionMatrix.isSelected(word, idxFiltBit2),
+                      selectionMatrix.isSelected(word, idxFiltBit3),
+                      selectionMatrix.isSelected(word, idxFiltBit4),
+                      selectionMatrix.isSelected(word, idxFiltBit5));
         }
         if (produceFBextendedTable == 1) {
-          o2::aod::track::TrackSelectionFlags::flagtype trackflagGlob = globalTracks.IsSelectedMask(track);
-          o2::aod::track::TrackSelectionFlags::flagtype trackflagFB1 = filtBit1.IsSelectedMask(track);
-          o2::aod::track::TrackSelectionFlags::flagtype trackflagFB2 = filtBit2.IsSelectedMask(track);
-          // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB3 = filtBit3.IsSelectedMask(track); // only temporarily commented, will be used
-          // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB4 = filtBit4.IsSelectedMask(track);
-          // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB5 = filtBit5.IsSelectedMask(track);
+          o2::aod::track::TrackSelectionFlags::flagtype trackflagFB1 = selectionMatrix.mask(word, idxFiltBit1);
+          o2::aod::track::TrackSelectionFlags::flagtype trackflagFB2 = selectionMatrix.mask(word, idxFiltBit2);
+          // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB3 = selectionMatrix.mask(word, idxFiltBit3); // only temporarily commented, will be used
+          // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB4 = selectionMatrix.mask(word, idxFiltBit4);
+          // o2::aod::track::TrackSelectionFlags::flagtype trackflagFB5 = selectionMatrix.mask(word, idxFiltBit5);
 
           filterTableDetail(o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kTrackType),
                             o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kPtRange),
@@ -197,16 +222,16 @@ struct TrackSelectionTask {
       return;
     }
 
-    for (const auto& track : tracks) {
-      o2::aod::track::TrackSelectionFlags::flagtype trackflagGlob = globalTracks.IsSelectedMask(track);
+    for (const auto& word : predicateWords) {
+      o2::aod::track::TrackSelectionFlags::flagtype trackflagGlob = selectionMatrix.mask(word, idxGlobalTracks);
       if (produceTable == 1) {
-        filterTable((uint8_t)globalTracksSDD.IsSelected(track),
-                    globalTracks.IsSelectedMask(track),
-                    filtBit1.IsSelected(track),
-                    filtBit2.IsSelected(track),
-                    filtBit3.IsSelected(track),
-                    filtBit4.IsSelected(track),
-                    filtBit5.IsSelected(track));
+        filterTable((uint8_t)selectionMatrix.isSelected(word, idxGlobalTracksSDD),
+                    trackflagGlob,
+                    selectionMatrix.isSelected(word, idxFiltBit1),
+                    selectionMatrix.isSelected(word, idxFiltBit2),
+                    selectionMatrix.isSelected(word, idxFiltBit3),
+                    selectionMatrix.isSelected(word, idxFiltBit4),
+                    selectionMatrix.isSelected(word, idxFiltBit5));
       }
       if (produceFBextendedTable == 1) {
         filterTableDetail(o2::aod::track::TrackSelectionFlags::checkFlag(trackflagGlob, o2::aod::track::TrackSelectionFlags::kTrackType),
@@ -654,6 +654,82 @@ class EventSelectionModule
     return (dbc1 <= dbc2) ? index1 : index2;
   }
 
+  // flat lookup of TVX-fired bcs sorted in globalBC, used for the closest-TVX searches
+  struct TvxBcLookup {
+    std::vector<int64_t> globalBCs;
+    std::vector<int32_t> bcIndices;
+    std::vector<float> vtxZ;
+    std::vector<bool> isTaken; // bcs already matched to a collision are excluded from findBestGlobalBC
+
+    void clear()
+    {
+      globalBCs.clear();
+      bcIndices.clear();
+      vtxZ.clear();
+      isTaken.clear();
+    }
+
+    void add(int64_t globalBC, int32_t bcIndex, float zVtx)
+    {
+      globalBCs.push_back(globalBC);
+      bcIndices.push_back(bcIndex);
+      vtxZ.push_back(zVtx);
+    }
+
+    // sort by globalBC if needed; for duplicated globalBCs the last added entry is kept
+    void finalize()
+    {
+      if (!std::is_sorted(globalBCs.begin(), globalBCs.end()) || std::adjacent_find(globalBCs.begin(), globalBCs.end()) != globalBCs.end()) {
+        std::vector<size_t> order(globalBCs.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return globalBCs[a] < globalBCs[b]; });
+        std::vector<int64_t> sortedGlobalBCs;
+        std::vector<int32_t> sortedBcIndices;
+        std::vector<float> sortedVtxZ;
+        for (size_t i = 0; i < order.size(); i++) {
+          if (i + 1 < order.size() && globalBCs[order[i + 1]] == globalBCs[order[i]]) {
+            continue;
+          }
+          sortedGlobalBCs.push_back(globalBCs[order[i]]);
+          sortedBcIndices.push_back(bcIndices[order[i]]);
+          sortedVtxZ.push_back(vtxZ[order[i]]);
+        }
+        globalBCs.swap(sortedGlobalBCs);
+        bcIndices.swap(sortedBcIndices);
+        vtxZ.swap(sortedVtxZ);
+      }
+      isTaken.assign(globalBCs.size(), false);
+    }
+
+    size_t size() const { return globalBCs.size(); }
+
+    // position of a given globalBC, -1 if not found
+    int64_t find(int64_t globalBC) const
+    {
+      auto it = std::lower_bound(globalBCs.begin(), globalBCs.end(), globalBC);
+      if (it == globalBCs.end() || *it != globalBC) {
+        return -1;
+      }
+      return std::distance(globalBCs.begin(), it);
+    }
+
+    // bc index of a given globalBC, -1 if not found
+    int32_t bcIndex(int64_t globalBC) const
+    {
+      int64_t pos = find(globalBC);
+      return pos >= 0 ? bcIndices[pos] : -1;
+    }
+
+    void markTaken(int64_t globalBC)
+    {
+      int64_t pos = find(globalBC);
+      if (pos >= 0) {
+        isTaken[pos] = true;
+      }
+    }
+  };
+  TvxBcLookup tvxBCs;
+
   // helper function to find median time in the vector of TOF or TRD-track times
   float getMedian(std::vector<float> v)
   {
@@ -663,7 +739,7 @@ class EventSelectionModule
   }
 
   // helper function to find closest TVX signal in time and in zVtx
-  int64_t findBestGlobalBC(int64_t meanBC, int64_t sigmaBC, int32_t nContrib, float zVtxCol, std::map<int64_t, float>& mapGlobalBcVtxZ)
+  int64_t findBestGlobalBC(int64_t meanBC, int64_t sigmaBC, int32_t nContrib, float zVtxCol, TvxBcLookup const& lookup)
   {
     // protection against
     if (sigmaBC < 1)
@@ -676,16 +752,19 @@ class EventSelectionModule
     float zVtxSigma = 2.7 * std::pow(nContrib, -0.466) + 0.024;
     zVtxSigma += 1.0; // additional uncertainty due to imperfectections of FT0 time calibration
 
-    auto itMin = mapGlobalBcVtxZ.lower_bound(minBC);
-    auto itMax = mapGlobalBcVtxZ.upper_bound(maxBC);
+    size_t posMin = std::distance(lookup.globalBCs.begin(), std::lower_bound(lookup.globalBCs.begin(), lookup.globalBCs.end(), minBC));
+    size_t posMax = std::distance(lookup.globalBCs.begin(), std::upper_bound(lookup.globalBCs.begin(), lookup.globalBCs.end(), maxBC));
 
     float bestChi2 = 1e+10;
     int64_t bestGlobalBC = 0;
-    for (std::map<int64_t, float>::iterator it = itMin; it != itMax; ++it) {
-      float chi2 = std::pow((it->second - zVtxCol) / zVtxSigma, 2) + std::pow(static_cast<float>(it->first - meanBC) / sigmaBC, 2.);
+    for (size_t pos = posMin; pos < posMax; ++pos) {
+      if (lookup.isTaken[pos]) {
+        continue;
+      }
+      float chi2 = std::pow((lookup.vtxZ[pos] - zVtxCol) / zVtxSigma, 2) + std::pow(static_cast<float>(lookup.globalBCs[pos] - meanBC) / sigmaBC, 2.);
       if (chi2 < bestChi2) {
         bestChi2 = chi2;
-        bestGlobalBC = it->first;
+        bestGlobalBC = lookup.globalBCs[pos];
       }
     }
 
@@ -898,11 +977,9 @@ class EventSelectionModule
       return; // don't do anything in case configuration reported not ok
 
     int run = bcs.iteratorAt(0).runNumber();
-    // create maps from globalBC to bc index for TVX-fired bcs
+    // create a sorted lookup from globalBC to bc index for TVX-fired bcs
     // to be used for closest TVX searches
-    std::map<int64_t, int32_t> mapGlobalBcWithTVX;
-    std::map<int64_t, int32_t> mapGlobalBcWithOrInFT0;
-    std::map<int64_t, float> mapGlobalBcVtxZ;
+    tvxBCs.clear();
     for (const auto& bc : bcs) {
       int64_t globalBC = bc.globalBC();
       // skip non-colliding bcs for data and anchored runs
@@ -910,19 +987,15 @@ class EventSelectionModule
         continue;
       }
 
-      if (bc.has_ft0()) {
-        mapGlobalBcWithOrInFT0[globalBC] = bc.globalIndex();
-      }
-
       auto selection = bcselbuffer[bc.globalIndex()].selection;
       if (BITCHECK64(selection, aod::evsel::kIsTriggerTVX)) {
-        mapGlobalBcWithTVX[globalBC] = bc.globalIndex();
-        mapGlobalBcVtxZ[globalBC] = bc.has_ft0() ? bc.ft0().posZ() : 0;
+        tvxBCs.add(globalBC, bc.globalIndex(), bc.has_ft0() ? bc.ft0().posZ() : 0);
       }
     }
+    tvxBCs.finalize();
 
     // protection against empty FT0 maps
-    if (mapGlobalBcWithTVX.size() == 0) {
+    if (tvxBCs.size() == 0) {
       LOGP(error, "FT0 table is empty or corrupted. Filling evsel table with dummy values");
       for (const auto& col : cols) {
         auto bc = col.template bc_as<soa::Join<aod::BCs, aod::Run3MatchedToBCSparse>>();
@@ -1032,19 +1105,19 @@ class EventSelectionModule
 
         // matched with TOF --> precise time, match to TVX, but keep the nominal foundGlobalBC from pattern
         if (vIsVertexTOFmatched[colIndex]) {
-          std::map<int64_t, int32_t>::iterator it = mapGlobalBcWithTVX.find(foundGlobalBC);
-          if (it != mapGlobalBcWithTVX.end()) {
-            foundBCindex = it->second;                       // TVX at foundGlobalBC is found
-          } else {                                           // check if TVX is in nearby bcs
-            it = mapGlobalBcWithTVX.find(foundGlobalBC + 1); // next bc
-            if (it != mapGlobalBcWithTVX.end()) {
+          int32_t tvxBCindex = tvxBCs.bcIndex(foundGlobalBC);
+          if (tvxBCindex >= 0) {
+            foundBCindex = tvxBCindex;                      // TVX at foundGlobalBC is found
+          } else {                                          // check if TVX is in nearby bcs
+            tvxBCindex = tvxBCs.bcIndex(foundGlobalBC + 1); // next bc
+            if (tvxBCindex >= 0) {
               // foundGlobalBC += 1;
-              foundBCindex = it->second;
+              foundBCindex = tvxBCindex;
             } else {
-              it = mapGlobalBcWithTVX.find(foundGlobalBC - 1); // previous bc
-              if (it != mapGlobalBcWithTVX.end()) {
+              tvxBCindex = tvxBCs.bcIndex(foundGlobalBC - 1); // previous bc
+              if (tvxBCindex >= 0) {
                 // foundGlobalBC -= 1;
-                foundBCindex = it->second;
+                foundBCindex = tvxBCindex;
               } else {
                 foundBCindex = bc.globalIndex(); // keep original BC index
               }
@@ -1054,7 +1127,7 @@ class EventSelectionModule
         } else {
           // for non-TOF and low-mult vertices, consider nearby nominal bcs
           int64_t meanBC = globalBC + TMath::Nint(sumHighPtTime / sumHighPtW / bcNS);
-          int64_t bestGlobalBC = findBestGlobalBC(meanBC, evselOpts.confSigmaBCforHighPtTracks, vNcontributors[colIndex], col.posZ(), mapGlobalBcVtxZ);
+          int64_t bestGlobalBC = findBestGlobalBC(meanBC, evselOpts.confSigmaBCforHighPtTracks, vNcontributors[colIndex], col.posZ(), tvxBCs);
           if (bestGlobalBC > 0) {
             foundGlobalBC = bestGlobalBC;
             // find closest nominal bc in pattern
@@ -1066,7 +1139,7 @@ class EventSelectionModule
                 break; // the bc in pattern is found
               }
             }
-            foundBCindex = mapGlobalBcWithTVX[bestGlobalBC];
+            foundBCindex = tvxBCs.bcIndex(bestGlobalBC);
           } else {                           // failed to find a proper TVX with small vZ difference
             foundBCindex = bc.globalIndex(); // keep original BC index
           }
@@ -1081,28 +1154,28 @@ class EventSelectionModule
         // for collisions with TOF tracks:
         // take bc corresponding to TOF track with median time
         int64_t tofGlobalBC = globalBC + TMath::Nint(getMedian(vTrackTimesTOF) / bcNS);
-        std::map<int64_t, int32_t>::iterator it = mapGlobalBcWithTVX.find(tofGlobalBC);
-        if (it != mapGlobalBcWithTVX.end()) {
-          foundGlobalBC = it->first;
-          foundBCindex = it->second;
+        int32_t tvxBCindex = tvxBCs.bcIndex(tofGlobalBC);
+        if (tvxBCindex >= 0) {
+          foundGlobalBC = tofGlobalBC;
+          foundBCindex = tvxBCindex;
         }
       } else if (nPvTracksTPCnoTOFnoTRD == 0 && nPvTracksTRDnoTOF > 0) {
         // for collisions with TRD tracks but without TOF or ITSTPC-only tracks:
         // take bc corresponding to TRD track with median time
         int64_t trdGlobalBC = globalBC + TMath::Nint(getMedian(vTrackTimesTRDnoTOF) / bcNS);
-        std::map<int64_t, int32_t>::iterator it = mapGlobalBcWithTVX.find(trdGlobalBC);
-        if (it != mapGlobalBcWithTVX.end()) {
-          foundGlobalBC = it->first;
-          foundBCindex = it->second;
+        int32_t tvxBCindex = tvxBCs.bcIndex(trdGlobalBC);
+        if (tvxBCindex >= 0) {
+          foundGlobalBC = trdGlobalBC;
+          foundBCindex = tvxBCindex;
         }
       } else if (nPvTracksHighPtTPCnoTOFnoTRD > 0) {
         // for collisions with high-pt ITSTPC-nonTOF-nonTRD tracks
         // search in 3*confSigmaBCforHighPtTracks range (3*4 bcs by default)
         int64_t meanBC = globalBC + TMath::Nint(sumHighPtTime / sumHighPtW / bcNS);
-        int64_t bestGlobalBC = findBestGlobalBC(meanBC, evselOpts.confSigmaBCforHighPtTracks, vNcontributors[colIndex], col.posZ(), mapGlobalBcVtxZ);
+        int64_t bestGlobalBC = findBestGlobalBC(meanBC, evselOpts.confSigmaBCforHighPtTracks, vNcontributors[colIndex], col.posZ(), tvxBCs);
         if (bestGlobalBC > 0) {
           foundGlobalBC = bestGlobalBC;
-          foundBCindex = mapGlobalBcWithTVX[bestGlobalBC];
+          foundBCindex = tvxBCs.bcIndex(bestGlobalBC);
         }
       }
 
@@ -1113,18 +1186,16 @@ class EventSelectionModule
 
       // erase found global BC with TVX from the pool of bcs for the next loop over low-pt TPCnoTOFnoTRD collisions
       if (foundBCindex >= 0)
-        mapGlobalBcVtxZ.erase(foundGlobalBC);
+        tvxBCs.markTaken(foundGlobalBC);
     }
     // alternative matching: looking for collisions with the same nominal BC
     if (runLightIons >= 0) {
+      // group collisions by nominal BC: sort a copy once and count equal entries with a binary search
+      std::vector<int64_t> vSortedBCinPattern(vBCinPatternPerColl);
+      std::sort(vSortedBCinPattern.begin(), vSortedBCinPattern.end());
       for (uint32_t iCol = 0; iCol < vBCinPatternPerColl.size(); iCol++) {
-        int64_t foundNominalBC = vBCinPatternPerColl[iCol];
-        for (uint32_t jCol = 0; jCol < vBCinPatternPerColl.size(); jCol++) {
-          int64_t foundNominalBC2 = vBCinPatternPerColl[jCol];
-          if (foundNominalBC2 == foundNominalBC) {
-            vCollisionsPileupPerColl[iCol]++;
-          }
-        }
+        auto range = std::equal_range(vSortedBCinPattern.begin(), vSortedBCinPattern.end(), vBCinPatternPerColl[iCol]);
+        vCollisionsPileupPerColl[iCol] = std::distance(range.first, range.second);
       }
     } else { // continue standard matching: second loop to match remaining low-pt TPCnoTOFnoTRD collisions
       for (const auto& col : cols) {
@@ -1136,9 +1207,9 @@ class EventSelectionModule
           int64_t globalBC = bc.globalBC();
           int64_t meanBC = globalBC + TMath::Nint(weightedTime / bcNS);
           int64_t sigmaBC = TMath::CeilNint(weightedSigma / bcNS);
-          int64_t bestGlobalBC = findBestGlobalBC(meanBC, sigmaBC, vNcontributors[colIndex], col.posZ(), mapGlobalBcVtxZ);
+          int64_t bestGlobalBC = findBestGlobalBC(meanBC, sigmaBC, vNcontributors[colIndex], col.posZ(), tvxBCs);
           vFoundGlobalBC[colIndex] = bestGlobalBC > 0 ? bestGlobalBC : globalBC;
-          vFoundBCindex[colIndex] = bestGlobalBC > 0 ? mapGlobalBcWithTVX[bestGlobalBC] : bc.globalIndex();
+          vFoundBCindex[colIndex] = bestGlobalBC > 0 ? tvxBCs.bcIndex(bestGlobalBC) : bc.globalIndex();
         }
         // fill pileup counter
         vCollisionsPerBc[vFoundBCindex[colIndex]]++;
@@ -1180,6 +1251,10 @@ class EventSelectionModule
     std::vector<std::vector<int>> vCollsInPrevITSROF;
     std::vector<std::vector<int>> vCollsInTimeWin;
     std::vector<std::vector<float>> vTimeDeltaForColls; // delta time wrt a given collision
+    vCollsInSameITSROF.reserve(cols.size());
+    vCollsInPrevITSROF.reserve(cols.size());
+    vCollsInTimeWin.reserve(cols.size());
+    vTimeDeltaForColls.reserve(cols.size());
     for (const auto& col : cols) {
       int32_t colIndex = col.globalIndex();
       int64_t foundGlobalBC = vFoundGlobalBC[colIndex];
@@ -1225,7 +1300,7 @@ class EventSelectionModule
         vAssocCollInSameROF.push_back(maxColIndex);
         maxColIndex++;
       }
-      vCollsInSameITSROF.push_back(vAssocCollInSameROF);
+      vCollsInSameITSROF.push_back(std::move(vAssocCollInSameROF));
 
       // ### bookkeep collisions in previous ROF
       std::vector<int> vAssocCollInPrevROF;
@@ -1243,7 +1318,7 @@ class EventSelectionModule
           break;
         minColIndex--;
       }
-      vCollsInPrevITSROF.push_back(vAssocCollInPrevROF);
+      vCollsInPrevITSROF.push_back(std::move(vAssocCollInPrevROF));
 
       // ### for occupancy in time windows
       std::vector<int> vAssocToThisCol;
@@ -1281,7 +1356,7 @@ class EventSelectionModule
         vProxyNtracksAssocColls.push_back(vProxyForCollNtracks[maxColIndex]);
         maxColIndex++;
       }
-      vCollsInTimeWin.push_back(vAssocToThisCol);
+      vCollsInTimeWin.push_back(std::move(vAssocToThisCol));
       vTimeDeltaForColls.push_back(vCollsTimeDeltaWrtGivenColl);
 
       // calculation of the median time for the occupancy in a given time window
@@ -1323,7 +1398,7 @@ class EventSelectionModule
       float vZ = col.posZ();
 
       // ### in-ROF occupancy
-      std::vector<int> vAssocCollInSameROF = vCollsInSameITSROF[colIndex];
+      const auto& vAssocCollInSameROF = vCollsInSameITSROF[colIndex];
       int nITS567tracksForSameRofVetoStrict = 0;    // to veto events with other collisions in the same ITS ROF
       int nCollsInRofWithFT0CAboveVetoStandard = 0; // to veto events with other collisions in the same ITS ROF, with per-collision multiplicity above threshold
       int nITS567tracksForRofVetoOnCloseVz = 0;     // to veto events with nearby collisions with close vZ
@@ -1341,7 +1416,7 @@ class EventSelectionModule
       vNoCollInSameRofWithCloseVz[colIndex] = (nITS567tracksForRofVetoOnCloseVz == 0);
 
       // ### occupancy in previous ROF
-      std::vector<int> vAssocCollInPrevROF = vCollsInPrevITSROF[colIndex];
+      const auto& vAssocCollInPrevROF = vCollsInPrevITSROF[colIndex];
       float totalFT0amplInPrevROF = 0;
       for (uint32_t iCol = 0; iCol < vAssocCollInPrevROF.size(); iCol++) {
         int thisColIndex = vAssocCollInPrevROF[iCol];
@@ -1351,8 +1426,8 @@ class EventSelectionModule
       vNoHighMultCollInPrevRof[colIndex] = (totalFT0amplInPrevROF < evselOpts.confFT0CamplCutVetoOnCollInROF);
 
       // ### occupancy in time windows
-      std::vector<int> vAssocToThisCol = vCollsInTimeWin[colIndex];
-      std::vector<float> vCollsTimeDeltaWrtGivenColl = vTimeDeltaForColls[colIndex];
+      const auto& vAssocToThisCol = vCollsInTimeWin[colIndex];
+      const auto& vCollsTimeDeltaWrtGivenColl = vTimeDeltaForColls[colIndex];
       int nITS567tracksInFullTimeWindow = 0;
       float sumAmpFT0CInFullTimeWindow = 0;
       int nITS567tracksForVetoNarrow = 0;      // to veto events with nearby collisions (narrow range) with per-collision multiplicity above threshold
@@ -1396,10 +1471,9 @@ class EventSelectionModule
       if (vIsFullInfoForOccupancy[colIndex] && vCanHaveAssocCollsWithinLastDriftTime[colIndex] && colIndexFirstRejectedByTFborderCut >= 0) {
         int64_t foundGlobalBC = vFoundGlobalBC[colIndex];
         int64_t tfId = (foundGlobalBC - bcSOR) / nBCsPerTF;
-        std::map<int64_t, int32_t>::iterator it = mapGlobalBcWithTVX.find(vFoundGlobalBC[colIndexFirstRejectedByTFborderCut]);
-        while (it != mapGlobalBcWithTVX.end()) {
-          int64_t thisFoundGlobalBC = it->first;
-          int32_t thisFoundBCindex = it->second;
+        for (int64_t pos = tvxBCs.find(vFoundGlobalBC[colIndexFirstRejectedByTFborderCut]); pos >= 0 && pos < static_cast<int64_t>(tvxBCs.size()); pos++) {
+          int64_t thisFoundGlobalBC = tvxBCs.globalBCs[pos];
+          int32_t thisFoundBCindex = tvxBCs.bcIndices[pos];
           auto bc = bcs.iteratorAt(thisFoundBCindex);
           int64_t thisTFid = (bc.globalBC() - bcSOR) / nBCsPerTF;
           if (thisTFid != tfId)
@@ -1422,7 +1496,6 @@ class EventSelectionModule
               sumAmpFT0CInFullTimeWindow += wOccup * multT0C;
             }
           }
-          it++;
         }
       }
 
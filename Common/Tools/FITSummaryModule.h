@@ -0,0 +1,217 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FITSummaryModule.h
+/// \brief FIT summary module: sums the FT0, FV0 and FDD amplitudes once per time frame
+/// \author ALICE
+
+#ifndef COMMON_TOOLS_FITSUMMARYMODULE_H_
+#define COMMON_TOOLS_FITSUMMARYMODULE_H_
+
+#include "Common/DataModel/FITSummary.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//__________________________________________
+// FIT summary module
+//
+// walks the amplitude arrays of the FT0, FV0 and FDD tables once per
+// time frame and keeps the sums, ring subtotals, channel counts, times
+// and trigger masks per detector entry. Tasks that already subscribe to
+// the FIT tables read the sums from here (by FT0, FV0 or FDD index)
+// instead of walking the arrays again, and fit-summary-table publishes
+// them as the per-BC FITSummaries table for everyone else.
+
+namespace o2
+{
+namespace common
+{
+namespace fitsummary
+{
+
+// sums and times are -999, counts and masks 0, when the detector has no entry in the BC
+struct FT0Summary {
+  float sumA = -999.f;
+  float sumC = -999.f;
+  float sumAInner = -999.f;
+  float sumAOuter = -999.f;
+  float sumCInner = -999.f;
+  float sumCOuter = -999.f;
+  uint8_t nChannelsA = 0;
+  uint8_t nChannelsC = 0;
+  float timeA = -999.f;
+  float timeC = -999.f;
+  uint8_t triggerMask = 0;
+};
+
+struct FV0Summary {
+  float sumA = -999.f;
+  float sumAOuter = -999.f;
+  std::array<float, o2::aod::fitsummary::FV0NRings> ringSums = {-999.f, -999.f, -999.f, -999.f, -999.f};
+  uint8_t nChannels = 0;
+  float time = -999.f;
+  uint8_t triggerMask = 0;
+};
+
+struct FDDSummary {
+  float sumA = -999.f;
+  float sumC = -999.f;
+  uint8_t nChannelsA = 0;
+  uint8_t nChannelsC = 0;
+  float timeA = -999.f;
+  float timeC = -999.f;
+  uint8_t triggerMask = 0;
+};
+
+class FITSummaryModule
+{
+ public:
+  FITSummaryModule() = default;
+
+  // the sums run over the channels in the order in which they are stored, as the per-collision
+  // loops of the tasks did, so that the values are bitwise identical to theirs
+  template <typename TFT0s, typename TFV0s, typename TFDDs>
+  void process(TFT0s const& ft0s, TFV0s const& fv0s, TFDDs const& fdds)
+  {
+    using namespace o2::aod::fitsummary;
+
+    mFT0s.resize(ft0s.size());
+    mFT0BCIds.resize(ft0s.size());
+    for (const auto& ft0 : ft0s) {
+      auto& summary = mFT0s[ft0.globalIndex()];
+      summary = FT0Summary{0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0, 0, ft0.timeA(), ft0.timeC(), ft0.triggerMask()};
+      mFT0BCIds[ft0.globalIndex()] = ft0.bcId();
+      for (size_t ii = 0; ii < ft0.amplitudeA().size(); ii++) {
+        auto amplitude = ft0.amplitudeA()[ii];
+        summary.sumA += amplitude;
+        if (ft0.channelA()[ii] > FT0AInnerRingMaxChannel) {
+          summary.sumAOuter += amplitude;
+        } else {
+          summary.sumAInner += amplitude;
+        }
+        if (amplitude > 0.f) {
+          summary.nChannelsA++;
+        }
+      }
+      for (size_t ii = 0; ii < ft0.amplitudeC().size(); ii++) {
+        auto amplitude = ft0.amplitudeC()[ii];
+        summary.sumC += amplitude;
+        if (ft0.channelC()[ii] > FT0CInnerRingMaxChannel) {
+          summary.sumCOuter += amplitude;
+        } else {
+          summary.sumCInner += amplitude;
+        }
+        if (amplitude > 0.f) {
+          summary.nChannelsC++;
+        }
+      }
+    }
+
+    mFV0s.resize(fv0s.size());
+    mFV0BCIds.resize(fv0s.size());
+    for (const auto& fv0 : fv0s) {
+      auto& summary = mFV0s[fv0.globalIndex()];
+      summary = FV0Summary{0.f, 0.f, {0.f, 0.f, 0.f, 0.f, 0.f}, 0, fv0.time(), fv0.triggerMask()};
+      mFV0BCIds[fv0.globalIndex()] = fv0.bcId();
+      for (size_t ii = 0; ii < fv0.amplitude().size(); ii++) {
+        auto amplitude = fv0.amplitude()[ii];
+        auto channel = fv0.channel()[ii];
+        summary.sumA += amplitude;
+        if (channel > FV0InnerRingMaxChannel) {
+          summary.sumAOuter += amplitude;
+        }
+        summary.ringSums[fv0Ring(channel)] += amplitude;
+        if (amplitude > 0.f) {
+          summary.nChannels++;
+        }
+      }
+    }
+
+    mFDDs.resize(fdds.size());
+    mFDDBCIds.resize(fdds.size());
+    for (const auto& fdd : fdds) {
+      auto& summary = mFDDs[fdd.globalIndex()];
+      summary = FDDSummary{0.f, 0.f, 0, 0, fdd.timeA(), fdd.timeC(), fdd.triggerMask()};
+      mFDDBCIds[fdd.globalIndex()] = fdd.bcId();
+      for (const auto& amplitude : fdd.chargeA()) {
+        summary.sumA += amplitude;
+        if (amplitude > 0) {
+          summary.nChannelsA++;
+        }
+      }
+      for (const auto& amplitude : fdd.chargeC()) {
+        summary.sumC += amplitude;
+        if (amplitude > 0) {
+          summary.nChannelsC++;
+        }
+      }
+    }
+  }
+
+  // per detector entry, indexed like the FT0s, FV0As and FDDs tables of the last processed time frame
+  const FT0Summary& ft0(int64_t ft0Id) const { return mFT0s[ft0Id]; }
+  const FV0Summary& fv0(int64_t fv0Id) const { return mFV0s[fv0Id]; }
+  const FDDSummary& fdd(int64_t fddId) const { return mFDDs[fddId]; }
+
+  // fills the per-BC FITSummaries table, one row per BC
+  template <typename TCursor>
+  void fillTable(TCursor& cursor, int64_t nBCs)
+  {
+    mFT0PerBC.assign(nBCs, -1);
+    mFV0PerBC.assign(nBCs, -1);
+    mFDDPerBC.assign(nBCs, -1);
+    for (size_t ii = 0; ii < mFT0BCIds.size(); ii++) {
+      mFT0PerBC[mFT0BCIds[ii]] = ii;
+    }
+    for (size_t ii = 0; ii < mFV0BCIds.size(); ii++) {
+      mFV0PerBC[mFV0BCIds[ii]] = ii;
+    }
+    for (size_t ii = 0; ii < mFDDBCIds.size(); ii++) {
+      mFDDPerBC[mFDDBCIds[ii]] = ii;
+    }
+
+    const FT0Summary noFT0{};
+    const FV0Summary noFV0{};
+    const FDDSummary noFDD{};
+    cursor.reserve(nBCs);
+    for (int64_t ibc = 0; ibc < nBCs; ibc++) {
+      const auto& ft0 = mFT0PerBC[ibc] >= 0 ? mFT0s[mFT0PerBC[ibc]] : noFT0;
+      const auto& fv0 = mFV0PerBC[ibc] >= 0 ? mFV0s[mFV0PerBC[ibc]] : noFV0;
+      const auto& fdd = mFDDPerBC[ibc] >= 0 ? mFDDs[mFDDPerBC[ibc]] : noFDD;
+      cursor(ft0.sumA, ft0.sumC, ft0.sumAInner, ft0.sumAOuter, ft0.sumCInner, ft0.sumCOuter,
+             ft0.nChannelsA, ft0.nChannelsC, ft0.timeA, ft0.timeC, ft0.triggerMask,
+             fv0.sumA, fv0.sumAOuter, fv0.ringSums.data(), fv0.nChannels, fv0.time, fv0.triggerMask,
+             fdd.sumA, fdd.sumC, fdd.nChannelsA, fdd.nChannelsC, fdd.timeA, fdd.timeC, fdd.triggerMask);
+    }
+  }
+
+ private:
+  std::vector<FT0Summary> mFT0s;
+  std::vector<FV0Summary> mFV0s;
+  std::vector<FDDSummary> mFDDs;
+  std::vector<int64_t> mFT0BCIds;
+  std::vector<int64_t> mFV0BCIds;
+  std::vector<int64_t> mFDDBCIds;
+
+  // detector entry of each BC, for the table
+  std::vector<int64_t> mFT0PerBC;
+  std::vector<int64_t> mFV0PerBC;
+  std::vector<int64_t> mFDDPerBC;
+};
+
+} // namespace fitsummary
+} // namespace common
+} // namespace o2
+
+#endif // COMMON_TOOLS_FITSUMMARYMODULE_H_
@@ -18,6 +18,7 @@
 
 #include "Common/DataModel/Centrality.h"
 #include "Common/DataModel/Multiplicity.h"
+#include "Common/Tools/FITSummaryModule.h"
 
 #include <Framework/AnalysisDataModel.h>
 #include <Framework/AnalysisHelpers.h>
@@ -29,6 +30,7 @@
 #include <Framework/Logger.h>
 #include <Framework/RunningWorkflowInfo.h>
 
+#include <TAxis.h>
 #include <TFile.h>
 #include <TFormula.h>
 #include <TH1.h>
@@ -36,6 +38,7 @@
 #include <TProfile.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -373,6 +376,59 @@ class MultModule
   // (N.B.: will be invisible to the outside, create your own copies)
   o2::common::multiplicity::standardConfigurables internalOpts;
 
+  //_________________________________________________
+  // calibration histogram copied at run change into flat arrays:
+  // lookup(x) gives h->GetBinContent(h->FindFixBin(x)) without the virtual calls
+  struct CalibrationLookup {
+    int nBins = 0;
+    double xMin = 0.;
+    double xMax = 0.;
+    std::vector<double> edges;    // only for variable bin widths
+    std::vector<double> contents; // underflow, bins, overflow
+
+    void compile(TH1* h)
+    {
+      const TAxis* axis = h->GetXaxis();
+      nBins = axis->GetNbins();
+      xMin = axis->GetXmin();
+      xMax = axis->GetXmax();
+      edges.clear();
+      if (axis->GetXbins()->GetSize() > 0) {
+        edges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + nBins + 1);
+      }
+      contents.resize(nBins + 2);
+      for (int i = 0; i < nBins + 2; i++) {
+        contents[i] = h->GetBinContent(i);
+      }
+    }
+
+    // same bin finding as TAxis::FindFixBin
+    double lookup(double x) const
+    {
+      int bin;
+      if (x < xMin) {
+        bin = 0;
+      } else if (!(x < xMax)) { // also catches NaN
+        bin = nBins + 1;
+      } else if (edges.empty()) {
+        bin = 1 + static_cast<int>(nBins * (x - xMin) / (xMax - xMin));
+      } else {
+        bin = std::upper_bound(edges.begin(), edges.end(), x) - edges.begin();
+      }
+      return contents[bin];
+    }
+  };
+
+  // MC scaling of the multiplicity, pars as in the calibration TFormula
+  static float scaleMC(float x, const float pars[6])
+  {
+    float core = ((pars[0] + pars[1] * std::pow(x, pars[2])) - pars[3]) / pars[4];
+    if (core < 0.0f) {
+      return 0.0f; // this should be marked as low multiplicity and not mapped, core^pars[5] would be NaN
+    }
+    return std::pow(core, 1.0f / pars[5]);
+  }
+
   //_________________________________________________
   // centrality-related objects
   struct TagRun2V0MCalibration {
@@ -382,37 +438,44 @@ class MultModule
     TH1* mhVtxAmpCorrV0A = nullptr;
     TH1* mhVtxAmpCorrV0C = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorrV0A, mVtxAmpCorrV0C, mMultSelCalib;
   } Run2V0MInfo;
   struct TagRun2V0ACalibration {
     bool mCalibrationStored = false;
     TH1* mhVtxAmpCorrV0A = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorrV0A, mMultSelCalib;
   } Run2V0AInfo;
   struct TagRun2SPDTrackletsCalibration {
     bool mCalibrationStored = false;
     TH1* mhVtxAmpCorr = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorr, mMultSelCalib;
   } Run2SPDTksInfo;
   struct TagRun2SPDClustersCalibration {
     bool mCalibrationStored = false;
     TH1* mhVtxAmpCorrCL0 = nullptr;
     TH1* mhVtxAmpCorrCL1 = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorrCL0, mVtxAmpCorrCL1, mMultSelCalib;
   } Run2SPDClsInfo;
   struct TagRun2CL0Calibration {
     bool mCalibrationStored = false;
     TH1* mhVtxAmpCorr = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorr, mMultSelCalib;
   } Run2CL0Info;
   struct TagRun2CL1Calibration {
     bool mCalibrationStored = false;
     TH1* mhVtxAmpCorr = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorr, mMultSelCalib;
   } Run2CL1Info;
   struct CalibrationInfo {
     std::string name = "";
     bool mCalibrationStored = false;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mMultSelCalib;
     float mMCScalePars[6] = {0.0};
     TFormula* mMCScale = nullptr;
     explicit CalibrationInfo(std::string name)
@@ -645,7 +708,7 @@ class MultModule
 
   //__________________________________________________
   template <typename TCCDB, typename TMetadataInfo, typename TCollision, typename TTracks, typename TBC, typename TOutputGroup>
-  o2::common::multiplicity::multEntry collisionProcessRun3(TCCDB const& ccdb, TMetadataInfo const& metadataInfo, TCollision const& collision, TTracks const& tracks, TBC const& bc, TOutputGroup& cursors)
+  o2::common::multiplicity::multEntry collisionProcessRun3(TCCDB const& ccdb, TMetadataInfo const& metadataInfo, TCollision const& collision, TTracks const& tracks, TBC const& bc, o2::common::fitsummary::FITSummaryModule const& fitSummary, TOutputGroup& cursors)
   {
     // initialize properties
     o2::common::multiplicity::multEntry mults;
@@ -698,42 +761,28 @@ class MultModule
     }
 
     //_______________________________________________________________________
-    // forward detector signals, raw
+    // forward detector signals, raw (summed once per time frame by the FIT summary)
     if (collision.has_foundFV0()) {
-      const auto& fv0 = collision.foundFV0();
-      for (size_t ii = 0; ii < fv0.amplitude().size(); ii++) {
-        auto amplitude = fv0.amplitude()[ii];
-        auto channel = fv0.channel()[ii];
-        mults.multFV0A += amplitude;
-        if (channel > 7) {
-          mults.multFV0AOuter += amplitude;
-        }
-      }
+      const auto& fv0 = fitSummary.fv0(collision.foundFV0Id());
+      mults.multFV0A = fv0.sumA;
+      mults.multFV0AOuter = fv0.sumAOuter;
     } else {
       mults.multFV0A = -999.f;
       mults.multFV0AOuter = -999.f;
     }
     if (collision.has_foundFT0()) {
-      const auto& ft0 = collision.foundFT0();
-      mults.fitTriggerMask = ft0.triggerMask();
-      for (const auto& amplitude : ft0.amplitudeA()) {
-        mults.multFT0A += amplitude;
-      }
-      for (const auto& amplitude : ft0.amplitudeC()) {
-        mults.multFT0C += amplitude;
-      }
+      const auto& ft0 = fitSummary.ft0(collision.foundFT0Id());
+      mults.fitTriggerMask = ft0.triggerMask;
+      mults.multFT0A = ft0.sumA;
+      mults.multFT0C = ft0.sumC;
     } else {
       mults.multFT0A = -999.f;
       mults.multFT0C = -999.f;
     }
     if (collision.has_foundFDD()) {
-      const auto& fdd = collision.foundFDD();
-      for (const auto& amplitude : fdd.chargeA()) {
-        mults.multFDDA += amplitude;
-      }
-      for (const auto& amplitude : fdd.chargeC()) {
-        mults.multFDDC += amplitude;
-      }
+      const auto& fdd = fitSummary.fdd(collision.foundFDDId());
+      mults.multFDDA = fdd.sumA;
+      mults.multFDDC = fdd.sumC;
     } else {
       mults.multFDDA = -999.f;
       mults.multFDDC = -999.f;
@@ -1096,6 +1145,9 @@ class MultModule
                 LOGF(info, "MC Scale information from V0M for run %d not available", bc.runNumber());
               }
             }
+            Run2V0MInfo.mVtxAmpCorrV0A.compile(Run2V0MInfo.mhVtxAmpCorrV0A);
+            Run2V0MInfo.mVtxAmpCorrV0C.compile(Run2V0MInfo.mhVtxAmpCorrV0C);
+            Run2V0MInfo.mMultSelCalib.compile(Run2V0MInfo.mhMultSelCalib);
             Run2V0MInfo.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1107,6 +1159,8 @@ class MultModule
           Run2V0AInfo.mhVtxAmpCorrV0A = getccdb("hVtx_fAmplitude_V0A_Normalized");
           Run2V0AInfo.mhMultSelCalib = getccdb("hMultSelCalib_V0A");
           if ((Run2V0AInfo.mhVtxAmpCorrV0A != nullptr) && (Run2V0AInfo.mhMultSelCalib != nullptr)) {
+            Run2V0AInfo.mVtxAmpCorrV0A.compile(Run2V0AInfo.mhVtxAmpCorrV0A);
+            Run2V0AInfo.mMultSelCalib.compile(Run2V0AInfo.mhMultSelCalib);
             Run2V0AInfo.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1118,6 +1172,8 @@ class MultModule
           Run2SPDTksInfo.mhVtxAmpCorr = getccdb("hVtx_fnTracklets_Normalized");
           Run2SPDTksInfo.mhMultSelCalib = getccdb("hMultSelCalib_SPDTracklets");
           if ((Run2SPDTksInfo.mhVtxAmpCorr != nullptr) && (Run2SPDTksInfo.mhMultSelCalib != nullptr)) {
+            Run2SPDTksInfo.mVtxAmpCorr.compile(Run2SPDTksInfo.mhVtxAmpCorr);
+            Run2SPDTksInfo.mMultSelCalib.compile(Run2SPDTksInfo.mhMultSelCalib);
             Run2SPDTksInfo.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1130,6 +1186,9 @@ class MultModule
           Run2SPDClsInfo.mhVtxAmpCorrCL1 = getccdb("hVtx_fnSPDClusters1_Normalized");
           Run2SPDClsInfo.mhMultSelCalib = getccdb("hMultSelCalib_SPDClusters");
           if ((Run2SPDClsInfo.mhVtxAmpCorrCL0 != nullptr) && (Run2SPDClsInfo.mhVtxAmpCorrCL1 != nullptr) && (Run2SPDClsInfo.mhMultSelCalib != nullptr)) {
+            Run2SPDClsInfo.mVtxAmpCorrCL0.compile(Run2SPDClsInfo.mhVtxAmpCorrCL0);
+            Run2SPDClsInfo.mVtxAmpCorrCL1.compile(Run2SPDClsInfo.mhVtxAmpCorrCL1);
+            Run2SPDClsInfo.mMultSelCalib.compile(Run2SPDClsInfo.mhMultSelCalib);
             Run2SPDClsInfo.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1141,6 +1200,8 @@ class MultModule
           Run2CL0Info.mhVtxAmpCorr = getccdb("hVtx_fnSPDClusters0_Normalized");
           Run2CL0Info.mhMultSelCalib = getccdb("hMultSelCalib_CL0");
           if ((Run2CL0Info.mhVtxAmpCorr != nullptr) && (Run2CL0Info.mhMultSelCalib != nullptr)) {
+            Run2CL0Info.mVtxAmpCorr.compile(Run2CL0Info.mhVtxAmpCorr);
+            Run2CL0Info.mMultSelCalib.compile(Run2CL0Info.mhMultSelCalib);
             Run2CL0Info.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1152,6 +1213,8 @@ class MultModule
           Run2CL1Info.mhVtxAmpCorr = getccdb("hVtx_fnSPDClusters1_Normalized");
           Run2CL1Info.mhMultSelCalib = getccdb("hMultSelCalib_CL1");
           if ((Run2CL1Info.mhVtxAmpCorr != nullptr) && (Run2CL1Info.mhMultSelCalib != nullptr)) {
+            Run2CL1Info.mVtxAmpCorr.compile(Run2CL1Info.mhVtxAmpCorr);
+            Run2CL1Info.mMultSelCalib.compile(Run2CL1Info.mhMultSelCalib);
             Run2CL1Info.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1237,6 +1300,7 @@ class MultModule
                 LOGF(warning, "MC Scale information from %s for run %d not available", estimator.name.c_str(), bc.runNumber());
               }
             }
+            estimator.mMultSelCalib.compile(estimator.mhMultSelCalib);
             estimator.mCalibrationStored = true;
             estimator.isSane();
           } else {
@@ -1273,7 +1337,7 @@ class MultModule
 
   //__________________________________________________
   template <typename TCCDB, typename TMetadata, typename TBCs, typename TMultBuffer, typename TOutputGroup>
-  void generateCentralitiesRun3(TCCDB& ccdb, TMetadata const& metadataInfo, TBCs const& bcs, TMultBuffer const& mults, TOutputGroup& cursors)
+  void generateCentralitiesRun3(TCCDB& ccdb, TMetadata const& metadataInfo, TBCs const& bcs, o2::common::fitsummary::FITSummaryModule const& fitSummary, TMultBuffer const& mults, TOutputGroup& cursors)
   {
     // takes multiplicity buffer and generates the desirable centrality values (if any)
 
@@ -1301,13 +1365,6 @@ class MultModule
 
       auto populateTable = [&](auto& table, struct CalibrationInfo& estimator, float multiplicity, bool isInelGt0) {
         const bool assignOutOfRange = internalOpts.embedINELgtZEROselection && !isInelGt0;
-        auto scaleMC = [](float x, const float pars[6]) {
-          float core = ((pars[0] + pars[1] * std::pow(x, pars[2])) - pars[3]) / pars[4];
-          if (core < 0.0f) {
-            return 0.0f; // this should be marked as low multiplicity and not mapped, core^pars[5] would be NaN
-          }
-          return std::pow(((pars[0] + pars[1] * std::pow(x, pars[2])) - pars[3]) / pars[4], 1.0f / pars[5]);
-        };
 
         float percentile = 105.0f;
         float scaledMultiplicity = multiplicity;
@@ -1316,7 +1373,7 @@ class MultModule
             scaledMultiplicity = scaleMC(multiplicity, estimator.mMCScalePars);
             LOGF(debug, "Unscaled %s multiplicity: %f, scaled %s multiplicity: %f", estimator.name.c_str(), multiplicity, estimator.name.c_str(), scaledMultiplicity);
           }
-          percentile = estimator.mhMultSelCalib->GetBinContent(estimator.mhMultSelCalib->FindFixBin(scaledMultiplicity));
+          percentile = estimator.mMultSelCalib.lookup(scaledMultiplicity);
           if (assignOutOfRange)
             percentile = 100.5f;
         }
@@ -1351,30 +1408,28 @@ class MultModule
       }
 
       // populate centralities per BC
-      for (size_t ibc = 0; ibc < static_cast<size_t>(bcs.size()); ibc++) {
-        float bcMultFT0A = 0;
-        float bcMultFT0C = 0;
-
-        const auto& bc = bcs.rawIteratorAt(ibc);
-        if (bc.has_foundFT0()) {
-          const auto& ft0 = bc.foundFT0();
-          for (const auto& amplitude : ft0.amplitudeA()) {
-            bcMultFT0A += amplitude;
-          }
-          for (const auto& amplitude : ft0.amplitudeC()) {
-            bcMultFT0C += amplitude;
+      if (internalOpts.mEnabledTables[kBCCentFT0Ms] || internalOpts.mEnabledTables[kBCCentFT0As] || internalOpts.mEnabledTables[kBCCentFT0Cs]) {
+        for (size_t ibc = 0; ibc < static_cast<size_t>(bcs.size()); ibc++) {
+          float bcMultFT0A = 0;
+          float bcMultFT0C = 0;
+
+          const auto& bc = bcs.rawIteratorAt(ibc);
+          if (bc.has_foundFT0()) {
+            const auto& ft0 = fitSummary.ft0(bc.foundFT0Id());
+            bcMultFT0A = ft0.sumA;
+            bcMultFT0C = ft0.sumC;
+          } else {
+            bcMultFT0A = -999.f;
+            bcMultFT0C = -999.f;
           }
-        } else {
-          bcMultFT0A = -999.f;
-          bcMultFT0C = -999.f;
-        }
 
-        if (internalOpts.mEnabledTables[kBCCentFT0Ms])
-          populateTable(cursors.bcCentFT0M, ft0mInfo, bcMultFT0A + bcMultFT0C, true);
-        if (internalOpts.mEnabledTables[kBCCentFT0As])
-          populateTable(cursors.bcCentFT0A, ft0aInfo, bcMultFT0A, true);
-        if (internalOpts.mEnabledTables[kBCCentFT0Cs])
-          populateTable(cursors.bcCentFT0C, ft0cInfo, bcMultFT0C, true);
+          if (internalOpts.mEnabledTables[kBCCentFT0Ms])
+            populateTable(cursors.bcCentFT0M, ft0mInfo, bcMultFT0A + bcMultFT0C, true);
+          if (internalOpts.mEnabledTables[kBCCentFT0As])
+            populateTable(cursors.bcCentFT0A, ft0aInfo, bcMultFT0A, true);
+          if (internalOpts.mEnabledTables[kBCCentFT0Cs])
+            populateTable(cursors.bcCentFT0C, ft0cInfo, bcMultFT0C, true);
+        }
       }
     }
   }
@@ -1392,14 +1447,6 @@ class MultModule
       const auto& firstbc = bcs.begin();
       ConfigureCentralityRun2(ccdb, metadataInfo, firstbc);
 
-      auto scaleMC = [](float x, const float pars[6]) {
-        float core = ((pars[0] + pars[1] * std::pow(x, pars[2])) - pars[3]) / pars[4];
-        if (core < 0.0f) {
-          return 0.0f; // this should be marked as low multiplicity and not mapped, core^pars[5] would be NaN
-        }
-        return std::pow(((pars[0] + pars[1] * std::pow(x, pars[2])) - pars[3]) / pars[4], 1.0f / pars[5]);
-      };
-
       // populate centralities per event
       for (size_t iEv = 0; iEv < mults.size(); iEv++) {
         if (internalOpts.mEnabledTables[kCentRun2V0Ms]) {
@@ -1410,10 +1457,10 @@ class MultModule
               v0m = scaleMC(mults[iEv].multFV0A + mults[iEv].multFV0C, Run2V0MInfo.mMCScalePars);
               LOGF(debug, "Unscaled v0m: %f, scaled v0m: %f", mults[iEv].multFV0A + mults[iEv].multFV0C, v0m);
             } else {
-              v0m = mults[iEv].multFV0A * Run2V0MInfo.mhVtxAmpCorrV0A->GetBinContent(Run2V0MInfo.mhVtxAmpCorrV0A->FindFixBin(mults[iEv].posZ)) +
-                    mults[iEv].multFV0C * Run2V0MInfo.mhVtxAmpCorrV0C->GetBinContent(Run2V0MInfo.mhVtxAmpCorrV0C->FindFixBin(mults[iEv].posZ));
+              v0m = mults[iEv].multFV0A * Run2V0MInfo.mVtxAmpCorrV0A.lookup(mults[iEv].posZ) +
+                    mults[iEv].multFV0C * Run2V0MInfo.mVtxAmpCorrV0C.lookup(mults[iEv].posZ);
             }
-            cV0M = Run2V0MInfo.mhMultSelCalib->GetBinContent(Run2V0MInfo.mhMultSelCalib->FindFixBin(v0m));
+            cV0M = Run2V0MInfo.mMultSelCalib.lookup(v0m);
           }
           LOGF(debug, "centRun2V0M=%.0f", cV0M);
           // fill centrality columns
@@ -1422,8 +1469,8 @@ class MultModule
         if (internalOpts.mEnabledTables[kCentRun2V0As]) {
           float cV0A = 105.0f;
           if (Run2V0AInfo.mCalibrationStored) {
-            float v0a = mults[iEv].multFV0A * Run2V0AInfo.mhVtxAmpCorrV0A->GetBinContent(Run2V0AInfo.mhVtxAmpCorrV0A->FindFixBin(mults[iEv].posZ));
-            cV0A = Run2V0AInfo.mhMultSelCalib->GetBinContent(Run2V0AInfo.mhMultSelCalib->FindFixBin(v0a));
+            float v0a = mults[iEv].multFV0A * Run2V0AInfo.mVtxAmpCorrV0A.lookup(mults[iEv].posZ);
+            cV0A = Run2V0AInfo.mMultSelCalib.lookup(v0a);
           }
           LOGF(debug, "centRun2V0A=%.0f", cV0A);
           // fill centrality columns
@@ -1432,8 +1479,8 @@ class MultModule
         if (internalOpts.mEnabledTables[kCentRun2SPDTrks]) {
           float cSPD = 105.0f;
           if (Run2SPDTksInfo.mCalibrationStored) {
-            float spdm = mults[iEv].multTracklets * Run2SPDTksInfo.mhVtxAmpCorr->GetBinContent(Run2SPDTksInfo.mhVtxAmpCorr->FindFixBin(mults[iEv].posZ));
-            cSPD = Run2SPDTksInfo.mhMultSelCalib->GetBinContent(Run2SPDTksInfo.mhMultSelCalib->FindFixBin(spdm));
+            float spdm = mults[iEv].multTracklets * Run2SPDTksInfo.mVtxAmpCorr.lookup(mults[iEv].posZ);
+            cSPD = Run2SPDTksInfo.mMultSelCalib.lookup(spdm);
           }
           LOGF(debug, "centSPDTracklets=%.0f", cSPD);
           cursors.centRun2SPDTracklets(cSPD);
@@ -1441,9 +1488,9 @@ class MultModule
         if (internalOpts.mEnabledTables[kCentRun2SPDClss]) {
           float cSPD = 105.0f;
           if (Run2SPDClsInfo.mCalibrationStored) {
-            float spdm = mults[iEv].spdClustersL0 * Run2SPDClsInfo.mhVtxAmpCorrCL0->GetBinContent(Run2SPDClsInfo.mhVtxAmpCorrCL0->FindFixBin(mults[iEv].posZ)) +
-                         mults[iEv].spdClustersL1 * Run2SPDClsInfo.mhVtxAmpCorrCL1->GetBinContent(Run2SPDClsInfo.mhVtxAmpCorrCL1->FindFixBin(mults[iEv].posZ));
-            cSPD = Run2SPDClsInfo.mhMultSelCalib->GetBinContent(Run2SPDClsInfo.mhMultSelCalib->FindFixBin(spdm));
+            float spdm = mults[iEv].spdClustersL0 * Run2SPDClsInfo.mVtxAmpCorrCL0.lookup(mults[iEv].posZ) +
+                         mults[iEv].spdClustersL1 * Run2SPDClsInfo.mVtxAmpCorrCL1.lookup(mults[iEv].posZ);
+            cSPD = Run2SPDClsInfo.mMultSelCalib.lookup(spdm);
           }
           LOGF(debug, "centSPDClusters=%.0f", cSPD);
           cursors.centRun2SPDClusters(cSPD);
@@ -1451,8 +1498,8 @@ class MultModule
         if (internalOpts.mEnabledTables[kCentRun2CL0s]) {
           float cCL0 = 105.0f;
           if (Run2CL0Info.mCalibrationStored) {
-            float cl0m = mults[iEv].spdClustersL0 * Run2CL0Info.mhVtxAmpCorr->GetBinContent(Run2CL0Info.mhVtxAmpCorr->FindFixBin(mults[iEv].posZ));
-            cCL0 = Run2CL0Info.mhMultSelCalib->GetBinContent(Run2CL0Info.mhMultSelCalib->FindFixBin(cl0m));
+            float cl0m = mults[iEv].spdClustersL0 * Run2CL0Info.mVtxAmpCorr.lookup(mults[iEv].posZ);
+            cCL0 = Run2CL0Info.mMultSelCalib.lookup(cl0m);
           }
           LOGF(debug, "centCL0=%.0f", cCL0);
           cursors.centRun2CL0(cCL0);
@@ -1460,8 +1507,8 @@ class MultModule
         if (internalOpts.mEnabledTables[kCentRun2CL1s]) {
           float cCL1 = 105.0f;
           if (Run2CL1Info.mCalibrationStored) {
-            float cl1m = mults[iEv].spdClustersL1 * Run2CL1Info.mhVtxAmpCorr->GetBinContent(Run2CL1Info.mhVtxAmpCorr->FindFixBin(mults[iEv].posZ));
-            cCL1 = Run2CL1Info.mhMultSelCalib->GetBinContent(Run2CL1Info.mhMultSelCalib->FindFixBin(cl1m));
+            float cl1m = mults[iEv].spdClustersL1 * Run2CL1Info.mVtxAmpCorr.lookup(mults[iEv].posZ);
+            cCL1 = Run2CL1Info.mMultSelCalib.lookup(cl1m);
           }
           LOGF(debug, "centCL1=%.0f", cCL1);
           cursors.centRun2CL1(cCL1);
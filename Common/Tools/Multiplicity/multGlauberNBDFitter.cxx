@@ -27,6 +27,7 @@
 
 #include "multGlauberNBDFitter.h"
 
+#include <TAxis.h>
 #include <TF1.h>
 #include <TFile.h>
 #include <TFitResult.h>
@@ -45,7 +46,10 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream> // FIXME
+#include <vector>
 
 using namespace std;
 
@@ -58,6 +62,9 @@ multGlauberNBDFitter::multGlauberNBDFitter() : TNamed(),
                                                fhV0M(0x0),
                                                ffChanged(kTRUE),
                                                fCurrentf(-1),
+                                               fGridFirstBin(-1),
+                                               fGridValid(kFALSE),
+                                               fGridFailed(kFALSE),
                                                fAncestorMode(2),
                                                fNpart(0x0),
                                                fNcoll(0x0),
@@ -106,6 +113,9 @@ multGlauberNBDFitter::multGlauberNBDFitter(const char* name, const char* title)
                                                                                   fhV0M(0x0),
                                                                                   ffChanged(kTRUE),
                                                                                   fCurrentf(-1),
+                                                                                  fGridFirstBin(-1),
+                                                                                  fGridValid(kFALSE),
+                                                                                  fGridFailed(kFALSE),
                                                                                   fAncestorMode(2),
                                                                                   fNpart(0x0),
                                                                                   fNcoll(0x0),
@@ -186,32 +196,25 @@ Double_t multGlauberNBDFitter::ProbDistrib(Double_t* x, Double_t* par)
   // Recalculate the ancestor distribution in case f changed
   if (ffChanged) {
     fCurrentf = par[2];
-    fhNanc->Reset();
-
-    for (int ibin = 0; ibin < fNNpNcPairs; ibin++) {
-      Double_t lOption0 = (Int_t)(fNpart[ibin] * par[2] + fNcoll[ibin] * (1.0 - par[2]));
-      Double_t lOption1 = TMath::Floor(fNpart[ibin] * par[2] + fNcoll[ibin] * (1.0 - par[2]) + 0.5);
-      Double_t lOption2 = (fNpart[ibin] * par[2] + fNcoll[ibin] * (1.0 - par[2]));
-      if (fAncestorMode == 0)
-        fhNanc->Fill(lOption0, fContent[ibin]);
-      if (fAncestorMode == 1)
-        fhNanc->Fill(lOption1, fContent[ibin]);
-      if (fAncestorMode == 2)
-        fhNanc->Fill(lOption2, fContent[ibin]);
-    }
-    if (fhNanc->Integral() < 1) {
+    fGridValid = kFALSE;
+    fGridFailed = kFALSE;
+    if (!BuildAncestorDistribution(par[2])) {
       cout << "ERROR: ANCESTOR HISTOGRAM EMPTY" << endl;
       cout << "Will not do anything. Call InitializeNpNc if you want to plot without fitting" << endl;
       return 0;
     }
-    fhNanc->Scale(1. / fhNanc->Integral());
+  }
+  //______________________________________________________
+  // Points of the fitted histogram: use the tabulated values
+  Long_t lGridPoint = FindGridPoint(lMultValue);
+  if (lGridPoint >= 0 && ComputeLikelihoodGrid(par)) {
+    return par[3] * fGridProb[lGridPoint];
   }
   //______________________________________________________
   // Actually evaluate function
-  Int_t lStartBin = fhNanc->FindBin(0.0) + 1;
-  for (Long_t iNanc = lStartBin; iNanc < fhNanc->GetNbinsX() + 1; iNanc++) {
-    Double_t lNancestors = fhNanc->GetBinCenter(iNanc);
-    Double_t lNancestorCount = fhNanc->GetBinContent(iNanc);
+  for (size_t iNanc = 0; iNanc < fNancestors.size(); iNanc++) {
+    Double_t lNancestors = fNancestors[iNanc];
+    Double_t lNancestorCount = fNancestorCount[iNanc];
     // if(lNancestorCount<1e-12&&lNancestors>10) break;
 
     // allow for variable mu in case requested
@@ -229,6 +232,165 @@ Double_t multGlauberNBDFitter::ProbDistrib(Double_t* x, Double_t* par)
   return par[3] * lProbability;
 }
 
+//______________________________________________________
+Bool_t multGlauberNBDFitter::BuildAncestorDistribution(Double_t lf)
+{
+  // Bin the ancestors as the ancestor histogram would, but into a flat
+  // buffer; keep only the populated bins above zero for the evaluation
+  TAxis* lAxis = fhNanc->GetXaxis();
+  Int_t lNbins = lAxis->GetNbins();
+  fAncestorBuffer.assign(lNbins + 2, 0.0);
+  for (int ibin = 0; ibin < fNNpNcPairs; ibin++) {
+    Double_t lOption0 = (Int_t)(fNpart[ibin] * lf + fNcoll[ibin] * (1.0 - lf));
+    Double_t lOption1 = TMath::Floor(fNpart[ibin] * lf + fNcoll[ibin] * (1.0 - lf) + 0.5);
+    Double_t lOption2 = (fNpart[ibin] * lf + fNcoll[ibin] * (1.0 - lf));
+    Double_t lNancestors = lOption0;
+    if (fAncestorMode == 1)
+      lNancestors = lOption1;
+    if (fAncestorMode == 2)
+      lNancestors = lOption2;
+    if (fAncestorMode >= 0 && fAncestorMode <= 2)
+      fAncestorBuffer[lAxis->FindFixBin(lNancestors)] += fContent[ibin];
+  }
+  fNancestors.clear();
+  fNancestorCount.clear();
+
+  Double_t lIntegral = 0.0;
+  for (Int_t ibin = 1; ibin <= lNbins; ibin++)
+    lIntegral += fAncestorBuffer[ibin];
+
+  // keep the ancestor histogram available for inspection
+  fhNanc->Reset();
+  if (lIntegral < 1)
+    return kFALSE;
+  Double_t lScale = 1. / lIntegral;
+  for (Int_t ibin = 0; ibin <= lNbins + 1; ibin++) {
+    fAncestorBuffer[ibin] *= lScale;
+    fhNanc->SetBinContent(ibin, fAncestorBuffer[ibin]);
+  }
+
+  Int_t lStartBin = lAxis->FindFixBin(0.0) + 1;
+  for (Int_t ibin = lStartBin; ibin <= lNbins; ibin++) {
+    if (fAncestorBuffer[ibin] == 0)
+      continue; // would not contribute
+    fNancestors.push_back(lAxis->GetBinCenter(ibin));
+    fNancestorCount.push_back(fAncestorBuffer[ibin]);
+  }
+  return kTRUE;
+}
+
+//______________________________________________________
+void multGlauberNBDFitter::InitLikelihoodGrid()
+{
+  // The fit evaluates the function at the bin centers of the input
+  // histogram within the fit range: tabulate those
+  fGridMult.clear();
+  fGridProb.clear();
+  fGridFirstBin = -1;
+  fGridValid = kFALSE;
+  fGridFailed = kFALSE;
+  if (!fhV0M)
+    return;
+  Double_t lMin, lMax;
+  fGlauberNBD->GetRange(lMin, lMax);
+  for (Int_t ibin = 1; ibin <= fhV0M->GetNbinsX(); ibin++) {
+    Double_t lCenter = fhV0M->GetBinCenter(ibin);
+    if (lCenter < lMin || lCenter > lMax) {
+      if (fGridFirstBin < 0)
+        continue;
+      break;
+    }
+    if (fGridFirstBin < 0)
+      fGridFirstBin = ibin;
+    fGridMult.push_back(lCenter);
+  }
+  fGridProb.resize(fGridMult.size());
+}
+
+//______________________________________________________
+Long_t multGlauberNBDFitter::FindGridPoint(Double_t lMultValue) const
+{
+  if (fGridMult.empty())
+    return -1;
+  Long_t lPoint = fhV0M->GetXaxis()->FindFixBin(lMultValue) - fGridFirstBin;
+  if (lPoint < 0 || lPoint >= static_cast<Long_t>(fGridMult.size()) || fGridMult[lPoint] != lMultValue)
+    return -1;
+  return lPoint;
+}
+
+//______________________________________________________
+Bool_t multGlauberNBDFitter::ComputeLikelihoodGrid(const Double_t* par)
+{
+  // same parameters as the last call: reuse the grid, or the failure
+  if ((fGridValid || fGridFailed) && fGridPar[0] == par[0] && fGridPar[1] == par[1] && fGridPar[2] == par[2] && fGridPar[3] == par[4])
+    return fGridValid;
+  fGridPar[0] = par[0];
+  fGridPar[1] = par[1];
+  fGridPar[2] = par[2];
+  fGridPar[3] = par[4];
+  fGridValid = kFALSE;
+  fGridFailed = kFALSE;
+
+  // outside of the NBD domain for any ancestor count: leave it to the direct evaluation,
+  // checked before the grid is touched
+  for (size_t iNanc = 0; iNanc < fNancestors.size(); iNanc++) {
+    Double_t lNancestors = fNancestors[iNanc];
+    if (!(lNancestors * (par[0] + par[4] * lNancestors) > 0) || !(lNancestors * par[1] > 0)) {
+      fGridFailed = kTRUE;
+      return kFALSE;
+    }
+  }
+
+  // Values below this are negligible: stop once the NBD falls below it
+  const Double_t lTiny = 1.e-290;
+  // Longest step in multiplicity done with the recurrence
+  const Double_t lMaxStep = 16;
+
+  std::fill(fGridProb.begin(), fGridProb.end(), 0.0);
+  for (size_t iNanc = 0; iNanc < fNancestors.size(); iNanc++) {
+    Double_t lNancestors = fNancestors[iNanc];
+    Double_t lNancestorCount = fNancestorCount[iNanc];
+    Double_t lThisMu = lNancestors * (par[0] + par[4] * lNancestors);
+    Double_t lThisk = lNancestors * par[1];
+    Double_t lLogQ = TMath::Log(lThisMu / lThisk) - TMath::Log(1.0 + lThisMu / lThisk);
+
+    // Walk along the multiplicity with P(n+1) = P(n) (n+k)/(n+1) mu/(mu+k),
+    // restarting from the closed form only where the step is not integer
+    Double_t lN = -1;
+    Double_t lLogP = 0;
+    Double_t lP = 0;
+    for (size_t iPoint = 0; iPoint < fGridMult.size(); iPoint++) {
+      if (fGridMult[iPoint] <= 1e-6)
+        continue;
+      // integer multiplicity for the truncation and rounding modes, as in the NBD TF1
+      Double_t lThisN = fAncestorMode != 2 ? TMath::Floor(fGridMult[iPoint]) : fGridMult[iPoint];
+      Double_t lStep = std::round(lThisN - lN);
+      if (lN < 0 || lStep < 1 || lStep > lMaxStep || TMath::Abs(lThisN - lN - lStep) > 1e-9 * lThisN) {
+        lLogP = LogNBD(lThisN, lThisMu, lThisk);
+        lP = TMath::Exp(lLogP);
+      } else {
+        Double_t lRatio = TMath::Exp(lStep * lLogQ);
+        for (Int_t iStep = 0; iStep < lStep; iStep++)
+          lRatio *= (lN + iStep + lThisk) / (lN + iStep + 1.0);
+        if (lP < lTiny) {
+          if (lRatio < 1)
+            break; // already negligible and only decreasing from here on
+          lLogP += TMath::Log(lRatio);
+          lP = TMath::Exp(lLogP);
+        } else {
+          lP *= lRatio;
+          if (lP < lTiny && lRatio < 1)
+            break;
+        }
+      }
+      lN = lThisN;
+      fGridProb[iPoint] += lNancestorCount * lP;
+    }
+  }
+  fGridValid = kTRUE;
+  return kTRUE;
+}
+
 //________________________________________________________________
 Bool_t multGlauberNBDFitter::SetNpartNcollCorrelation(TH2* hNpNc)
 {
@@ -312,6 +474,7 @@ Bool_t multGlauberNBDFitter::DoFit()
   cout << "---> Now fitting, please wait..." << endl;
 
   fGlauberNBD->SetNpx(fFitNpx);
+  InitLikelihoodGrid();
   TFitResultPtr fitptr;
   fFitOptions.Append("S");
   fitptr = fhV0M->Fit("fGlauberNBD", fFitOptions.Data());
@@ -385,6 +548,13 @@ Double_t multGlauberNBDFitter::ContinuousNBD(Double_t n, Double_t mu, Double_t k
   return F;
 }
 
+//________________________________________________________________
+Double_t multGlauberNBDFitter::LogNBD(Double_t n, Double_t mu, Double_t k)
+{
+  // Same as the logarithm of ContinuousNBD
+  return TMath::LnGamma(n + k) - TMath::LnGamma(n + 1.) - TMath::LnGamma(k) + n * TMath::Log(mu / k) - (n + k) * TMath::Log(1.0 + mu / k);
+}
+
 void multGlauberNBDFitter::CalculateAvNpNc(TProfile* lNPartProf, TProfile* lNCollProf, TH2F* lNPart2DPlot, TH2F* lNColl2DPlot, TH1F* hPercentileMap, Double_t lLoRange, Double_t lHiRange, TH3D* lNpNcEcc, TH2F* lEcc2DPlot, TH3D* lNpNcB, TH2F* lB2DPlot, TH2F* lNancestor2DPlot, Double_t fProbabilityCutoff)
 {
   cout << "Calculating <Npart>, <Ncoll> in centrality bins..." << endl;
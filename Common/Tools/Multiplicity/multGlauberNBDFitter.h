@@ -23,6 +23,8 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <vector>
+
 class multGlauberNBDFitter : public TNamed
 {
 
@@ -77,6 +79,9 @@ class multGlauberNBDFitter : public TNamed
   // For ancestor mode 2
   Double_t ContinuousNBD(Double_t n, Double_t mu, Double_t k);
 
+  // Logarithm of the (continuous) NBD
+  Double_t LogNBD(Double_t n, Double_t mu, Double_t k);
+
   // For estimating Npart, Ncoll in multiplicity bins
   // also viable: eccentricity, impact parameter, ancestor cross-check plot
   void CalculateAvNpNc(TProfile* lNPartProf, TProfile* lNCollProf, TH2F* lNPart2DPlot, TH2F* lNColl2DPlot, TH1F* hPercentileMap, Double_t lLoRange = -1, Double_t lHiRange = -1, TH3D* lNpNcEcc = 0x0, TH2F* lEcc2DPlot = 0x0, TH3D* lNpNcB = 0x0, TH2F* lB2DPlot = 0x0, TH2F* lNancestor2DPlot = 0x0, Double_t fProbabilityCutoff = -1);
@@ -99,6 +104,24 @@ class multGlauberNBDFitter : public TNamed
   Bool_t ffChanged;
   Double_t fCurrentf;
 
+  // Populated ancestor bins as flat arrays, rebuilt whenever f changes
+  Bool_t BuildAncestorDistribution(Double_t lf);
+  std::vector<Double_t> fAncestorBuffer; //!
+  std::vector<Double_t> fNancestors;     //!
+  std::vector<Double_t> fNancestorCount; //!
+
+  // Glauber+NBD (without norm) tabulated at the bin centers of the fitted
+  // histogram, recomputed once per parameter set
+  void InitLikelihoodGrid();
+  Bool_t ComputeLikelihoodGrid(const Double_t* par);
+  Long_t FindGridPoint(Double_t lMultValue) const;
+  std::vector<Double_t> fGridMult; //!
+  std::vector<Double_t> fGridProb; //!
+  Long_t fGridFirstBin;            //!
+  Bool_t fGridValid;               //!
+  Bool_t fGridFailed;              //! fGridPar is outside of the NBD domain
+  Double_t fGridPar[4];            //! mu, k, f, dMu/dNanc of fGridProb
+
   // 0: truncation, 1: rounding, 2: analytical continuation
   Int_t fAncestorMode;
 
@@ -104,6 +104,8 @@ class TrackPropagationModule
   std::array<float, 2> mDcaInfo{};
   o2::dataformats::DCA mDcaInfoCov;
   o2::dataformats::VertexBase mVtx;
+  o2::dataformats::VertexBase mMeanVtx;
+  int mVtxCollisionId = -1; // collision currently loaded in mVtx, tracks come grouped by collision
   o2::track::TrackParametrization<float> mTrackPar;
   o2::track::TrackParametrizationWithError<float> mTrackParCov;
   bool autoDetectDcaCalib = false; // track tuner setting
@@ -254,6 +256,16 @@ class TrackPropagationModule
       cursors.tunertable.reserve(tracks.size());
     }
 
+    // vertex setup hoisted out of the track loop: the mean vertex is the same for
+    // all the tracks without collision and the collision vertex is only reloaded
+    // when the collision changes
+    auto* propagator = o2::base::Propagator::Instance();
+    if (ccdbLoader.mMeanVtx != nullptr) {
+      mMeanVtx.setPos({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()});
+      mMeanVtx.setCov(ccdbLoader.mMeanVtx->getSigmaX() * ccdbLoader.mMeanVtx->getSigmaX(), 0.0f, ccdbLoader.mMeanVtx->getSigmaY() * ccdbLoader.mMeanVtx->getSigmaY(), 0.0f, 0.0f, ccdbLoader.mMeanVtx->getSigmaZ() * ccdbLoader.mMeanVtx->getSigmaZ());
+    }
+    mVtxCollisionId = -1;
+
     for (const auto& track : tracks) {
       if (fillTracksCov) {
         if (fillTracksDCA || fillTracksDCACov) {
@@ -296,23 +308,17 @@ class TrackPropagationModule
         }
         bool isPropagationOK = true;
 
-        if (track.has_collision()) {
+        if (track.has_collision() && track.collisionId() != mVtxCollisionId) {
           auto const& collision = collisions.rawIteratorAt(track.collisionId());
-          if (fillTracksCov) {
-            mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
-            mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
+          mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
+          mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+          mVtxCollisionId = track.collisionId();
+        }
+        const auto& vtx = track.has_collision() ? mVtx : mMeanVtx;
+        if (fillTracksCov) {
+          isPropagationOK = propagator->propagateToDCABxByBz(vtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
         } else {
-          if (fillTracksCov) {
-            mVtx.setPos({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()});
-            mVtx.setCov(ccdbLoader.mMeanVtx->getSigmaX() * ccdbLoader.mMeanVtx->getSigmaX(), 0.0f, ccdbLoader.mMeanVtx->getSigmaY() * ccdbLoader.mMeanVtx->getSigmaY(), 0.0f, 0.0f, ccdbLoader.mMeanVtx->getSigmaZ() * ccdbLoader.mMeanVtx->getSigmaZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
+          isPropagationOK = propagator->propagateToDCABxByBz(vtx.getXYZ(), mTrackPar, 2.f, matCorr, &mDcaInfo);
         }
         if (isPropagationOK) {
           trackType = o2::aod::track::Track;
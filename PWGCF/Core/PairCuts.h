@@ -19,7 +19,12 @@
 
 #include <RtypesCore.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdlib>
+#include <span>
+#include <vector>
 
 // Functions which cut on particle pairs (decays, conversions, two-track cuts)
 //
@@ -51,6 +56,7 @@ class PairCuts
     LOGF(info, "Enabled two-track cut with distance %f and radius %f", distance, radius);
     mTwoTrackDistance = distance;
     mTwoTrackRadius = radius;
+    fillTwoTrackRadii();
 
     if (histogramRegistry != nullptr && histogramRegistry->contains(HIST("TwoTrackDistancePt_0")) == false) {
       histogramRegistry->add("TwoTrackDistancePt_0", "", {o2::framework::HistType::kTH3F, {{100, -0.15, 0.15, "#Delta#eta"}, {100, -0.05, 0.05, "#Delta#varphi^{*}_{min}"}, {20, 0, 10, "#Delta p_{T}"}}});
@@ -64,10 +70,27 @@ class PairCuts
   template <typename T>
   bool twoTrackCut(T const& track1, T const& track2, int magField);
 
+  // track quantities for the two-track cut of one trigger against many associated tracks
+  struct TwoTrackCutTrack {
+    float eta = 0;
+    float phi = 0;
+    float pt = 0;
+    int sign = 0;
+    double bending = 0; // 0.015 * magField / pt, asin argument of the bending in dphistar per unit radius
+  };
+
+  template <typename T>
+  static TwoTrackCutTrack twoTrackCutTrack(T const& track, int magField);
+
+  // sets removed[i] if the pair (trigger, associated[i]) is rejected by the two-track cut
+  // same decision as twoTrackCut(track1, track2, magField), up to the rounding of the bending terms
+  void twoTrackCut(TwoTrackCutTrack const& trigger, std::span<const TwoTrackCutTrack> associated, std::vector<bool>& removed);
+
  protected:
   float mCuts[ParticlesLastEntry] = {-1};
   float mTwoTrackDistance = -1; // distance below which the pair is flagged as to be removed
   float mTwoTrackRadius = 0.8f; // radius at which the two track cuts are applied
+  std::vector<float> mTwoTrackRadii; // radii at which the minimum dphistar is looked for, from mTwoTrackRadius to 2.5 m
 
   o2::framework::HistogramRegistry* histogramRegistry = nullptr; // if set, control histograms are stored here
 
@@ -82,6 +105,19 @@ class PairCuts
 
   template <typename T>
   float getDPhiStar(T const& track1, T const& track2, float radius, int magField);
+
+  template <typename T>
+  float getDPhiStarUnfolded(T const& track1, T const& track2, float radius, int magField);
+
+  static float foldDPhiStar(float dphistar);
+
+  void fillTwoTrackRadii();
+
+  template <typename F>
+  bool twoTrackCutDPhiStar(float deta, float dpt, bool monotonic, F const& dphistarAt);
+
+  template <typename F>
+  float getDPhiStarMin(bool monotonic, F const& dphistarAt);
 };
 
 template <typename T>
@@ -118,40 +154,55 @@ bool PairCuts::twoTrackCut(T const& track1, T const& track2, int magField)
   //   magField: B field in kG
 
   auto deta = track1.eta() - track2.eta();
+  bool monotonic = std::abs(track1.sign()) <= 1 && std::abs(track2.sign()) <= 1;
+
+  return twoTrackCutDPhiStar(deta, std::fabs(track1.pt() - track2.pt()), monotonic, [&](float radius) { return getDPhiStarUnfolded(track1, track2, radius, magField); });
+}
 
+template <typename T>
+PairCuts::TwoTrackCutTrack PairCuts::twoTrackCutTrack(T const& track, int magField)
+{
+  return {track.eta(), track.phi(), track.pt(), track.sign(), 0.015 * magField / track.pt()};
+}
+
+inline void PairCuts::twoTrackCut(TwoTrackCutTrack const& trigger, std::span<const TwoTrackCutTrack> associated, std::vector<bool>& removed)
+{
+  removed.assign(associated.size(), false);
+  for (size_t i = 0; i < associated.size(); i++) {
+    const auto& track = associated[i];
+    float deta = trigger.eta - track.eta;
+    bool monotonic = std::abs(trigger.sign) <= 1 && std::abs(track.sign) <= 1;
+    removed[i] = twoTrackCutDPhiStar(deta, std::fabs(trigger.pt - track.pt), monotonic, [&](float radius) -> float {
+      return trigger.phi - track.phi - trigger.sign * std::asin(trigger.bending * radius) + track.sign * std::asin(track.bending * radius);
+    });
+  }
+}
+
+template <typename F>
+bool PairCuts::twoTrackCutDPhiStar(float deta, float dpt, bool monotonic, F const& dphistarAt)
+{
   // optimization
   if (std::fabs(deta) < mTwoTrackDistance * 2.5 * 3) {
-    // check first boundaries to see if is worth to loop and find the minimum
-    float dphistar1 = getDPhiStar(track1, track2, mTwoTrackRadius, magField);
-    float dphistar2 = getDPhiStar(track1, track2, 2.5, magField);
+    // check first boundaries to see if is worth to look for the minimum
+    float dphistar1 = foldDPhiStar(dphistarAt(mTwoTrackRadius));
+    float dphistar2 = foldDPhiStar(dphistarAt(2.5));
 
     const float kLimit = mTwoTrackDistance * 3;
 
     if (std::fabs(dphistar1) < kLimit || std::fabs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0) {
-      float dphistarminabs = 1e5;
-      float dphistarmin = 1e5;
-      for (Double_t rad = mTwoTrackRadius; rad < 2.51; rad += 0.01) {
-        float dphistar = getDPhiStar(track1, track2, rad, magField);
-
-        float dphistarabs = std::fabs(dphistar);
-
-        if (dphistarabs < dphistarminabs) {
-          dphistarmin = dphistar;
-          dphistarminabs = dphistarabs;
-        }
-      }
+      float dphistarmin = getDPhiStarMin(monotonic, dphistarAt);
+      float dphistarminabs = std::fabs(dphistarmin);
 
       if (histogramRegistry != nullptr) {
-        histogramRegistry->fill(HIST("TwoTrackDistancePt_0"), deta, dphistarmin, std::fabs(track1.pt() - track2.pt()));
+        histogramRegistry->fill(HIST("TwoTrackDistancePt_0"), deta, dphistarmin, dpt);
       }
 
       if (dphistarminabs < mTwoTrackDistance && std::fabs(deta) < mTwoTrackDistance) {
-        // LOGF(debug, "Removed track pair %ld %ld with %f %f %f %f %d %f %f %d %d", track1.index(), track2.index(), deta, dphistarminabs, track1.phi2(), track1.pt(), track1.sign(), track2.phi2(), track2.pt(), track2.sign(), magField);
         return true;
       }
 
       if (histogramRegistry != nullptr) {
-        histogramRegistry->fill(HIST("TwoTrackDistancePt_1"), deta, dphistarmin, std::fabs(track1.pt() - track2.pt()));
+        histogramRegistry->fill(HIST("TwoTrackDistancePt_1"), deta, dphistarmin, dpt);
       }
     }
   }
@@ -159,6 +210,100 @@ bool PairCuts::twoTrackCut(T const& track1, T const& track2, int magField)
   return false;
 }
 
+inline void PairCuts::fillTwoTrackRadii()
+{
+  mTwoTrackRadii.clear();
+  for (Double_t rad = mTwoTrackRadius; rad < 2.51; rad += 0.01) {
+    mTwoTrackRadii.push_back(rad);
+  }
+}
+
+template <typename F>
+float PairCuts::getDPhiStarMin(bool monotonic, F const& dphistarAt)
+{
+  // dphistar with the smallest absolute value at the radii mTwoTrackRadii (first one in case of a tie)
+  //
+  // Before folding, dphistar = phi1 - phi2 - q1 asin(k r / pt1) + q2 asin(k r / pt2) is monotonic in r
+  // for |q1|, |q2| <= 1: the derivatives of the two bending terms cancel only for equal charge and pT,
+  // where dphistar is constant. Its absolute value after folding is then smallest at the first or last
+  // radius, or next to a crossing of 0 or +-2 pi, which are bracketed by bisection. The radii at which a
+  // track has curled up (asin argument above 1, dphistar NaN) form the end of the range and are ignored.
+
+  float dphistarminabs = 1e5;
+  float dphistarmin = 1e5;
+
+  auto checkRadius = [&](int i) {
+    float dphistar = foldDPhiStar(dphistarAt(mTwoTrackRadii[i]));
+    float dphistarabs = std::fabs(dphistar);
+    if (dphistarabs < dphistarminabs) {
+      dphistarmin = dphistar;
+      dphistarminabs = dphistarabs;
+    }
+  };
+
+  if (mTwoTrackRadii.empty()) {
+    fillTwoTrackRadii();
+  }
+  const int nRadii = mTwoTrackRadii.size();
+
+  if (!monotonic) {
+    for (int i = 0; i < nRadii; i++) {
+      checkRadius(i);
+    }
+    return dphistarmin;
+  }
+
+  const float first = dphistarAt(mTwoTrackRadii[0]);
+  if (std::isnan(first)) {
+    return dphistarmin;
+  }
+  int lastIndex = nRadii - 1;
+  float last = dphistarAt(mTwoTrackRadii[lastIndex]);
+  if (std::isnan(last)) {
+    int valid = 0;
+    while (lastIndex - valid > 1) {
+      int mid = (valid + lastIndex) / 2;
+      if (std::isnan(dphistarAt(mTwoTrackRadii[mid]))) {
+        lastIndex = mid;
+      } else {
+        valid = mid;
+      }
+    }
+    lastIndex = valid;
+    last = dphistarAt(mTwoTrackRadii[lastIndex]);
+  }
+
+  std::array<int, 8> candidates = {0, lastIndex};
+  int nCandidates = 2;
+  const bool increasing = last > first;
+  for (int k = -1; k <= 1; k++) {
+    const float crossing = k * o2::constants::math::TwoPI;
+    auto isAfter = [&](float dphistar) { return increasing ? dphistar >= crossing : dphistar <= crossing; };
+    if (isAfter(first) || !isAfter(last)) {
+      continue;
+    }
+    int before = 0;
+    int after = lastIndex;
+    while (after - before > 1) {
+      int mid = (before + after) / 2;
+      if (isAfter(dphistarAt(mTwoTrackRadii[mid]))) {
+        after = mid;
+      } else {
+        before = mid;
+      }
+    }
+    candidates[nCandidates++] = before;
+    candidates[nCandidates++] = after;
+  }
+
+  std::sort(candidates.begin(), candidates.begin() + nCandidates);
+  for (int i = 0; i < nCandidates; i++) {
+    checkRadius(candidates[i]);
+  }
+
+  return dphistarmin;
+}
+
 template <typename T>
 bool PairCuts::conversionCut(T const& track1, T const& track2, Particle conv, double cut)
 {
@@ -315,6 +460,12 @@ float PairCuts::getDPhiStar(T const& track1, T const& track2, float radius, int
   // calculates dphistar
   //
 
+  return foldDPhiStar(getDPhiStarUnfolded(track1, track2, radius, magField));
+}
+
+template <typename T>
+float PairCuts::getDPhiStarUnfolded(T const& track1, T const& track2, float radius, int magField)
+{
   auto phi1 = track1.phi();
   auto pt1 = track1.pt();
   auto charge1 = track1.sign();
@@ -323,8 +474,11 @@ float PairCuts::getDPhiStar(T const& track1, T const& track2, float radius, int
   auto pt2 = track2.pt();
   auto charge2 = track2.sign();
 
-  float dphistar = phi1 - phi2 - charge1 * std::asin(0.015 * magField * radius / pt1) + charge2 * std::asin(0.015 * magField * radius / pt2);
+  return phi1 - phi2 - charge1 * std::asin(0.015 * magField * radius / pt1) + charge2 * std::asin(0.015 * magField * radius / pt2);
+}
 
+inline float PairCuts::foldDPhiStar(float dphistar)
+{
   if (dphistar > o2::constants::math::PI) {
     dphistar = o2::constants::math::TwoPI - dphistar;
   }
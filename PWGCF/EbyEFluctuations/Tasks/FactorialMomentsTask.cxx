@@ -33,10 +33,9 @@
 #include <Framework/OutputObjHeader.h>
 #include <Framework/runDataProcessing.h>
 
+#include <TAxis.h>
 #include <TH1.h>
-#include <TH2.h>
 #include <TH3.h>
-#include <TMath.h>
 #include <TRandom.h>
 #include <TString.h>
 
@@ -183,7 +182,14 @@ struct FactorialMomentsTask {
   std::array<std::array<double, nBins>, 5> binConEvent;
   std::array<std::array<std::array<double, nBins>, 5>, 6> binConEventSampled;
   std::array<std::array<std::array<double, nBins>, 5>, 6> errorFq = {{{{{0, 0, 0, 0, 0}}}}};
-  std::vector<std::shared_ptr<TH2>> mHistArrReset;
+  // eta-phi cell counts of each (pT bin, M) granularity, with the list of occupied cells for the reset
+  struct Occupancy {
+    std::vector<int> counts;
+    std::vector<int> occupiedCells;
+  };
+  std::vector<Occupancy> mOccupancies;
+  std::vector<TAxis> mEtaAxes;
+  std::vector<TAxis> mPhiAxes;
   std::vector<std::shared_ptr<TH1>> mHistArrQA;
   std::vector<std::shared_ptr<TH3>> mHistArrEff;
   std::vector<std::shared_ptr<TH1>> mFqBinFinal;
@@ -225,6 +231,8 @@ struct FactorialMomentsTask {
     }
     for (int iM = 0; iM < nBins; ++iM) {
       binningM[iM] = 2 * (iM + 2);
+      mEtaAxes.emplace_back(binningM[iM], -0.8, 0.8);
+      mPhiAxes.emplace_back(binningM[iM], 0, o2::constants::math::TwoPI);
     }
     for (int iPt = 0; iPt < numPt; ++iPt) {
       mHistArrEff.push_back(std::get<std::shared_ptr<TH3>>(histos.add(Form("bin%i/m3DVtxZetaPhi", iPt + 1), Form("#eta #phi #vtxz for bin %.2f-%.2f;vz;#eta;#phi", ptCuts.value[2 * iPt], ptCuts.value[2 * iPt + 1]), HistType::kTH3F, {{20, -10, 10}, {16, -0.8, +0.8}, {100, 0., o2::constants::math::TwoPI}})));
@@ -233,8 +241,9 @@ struct FactorialMomentsTask {
       mHistArrQA.push_back(std::get<std::shared_ptr<TH1>>(histos.add(Form("bin%i/mPhi", iPt + 1), Form("#phi for bin %.2f-%.2f;#phi", ptCuts.value[2 * iPt], ptCuts.value[2 * iPt + 1]), HistType::kTH1F, {{1000, 0, o2::constants::math::TwoPI}})));
       mHistArrQA.push_back(std::get<std::shared_ptr<TH1>>(histos.add(Form("bin%i/mMultiplicity", iPt + 1), Form("Multiplicity for bin %.2f-%.2f;Multiplicity", ptCuts.value[2 * iPt], ptCuts.value[2 * iPt + 1]), HistType::kTH1F, {{1000, 0, 15000}})));
       for (int iM = 0; iM < nBins; ++iM) {
-        auto mHistsR = std::get<std::shared_ptr<TH2>>(histos.add(Form("bin%i/Reset/mEtaPhi%i", iPt + 1, iM), Form("#eta#phi_%i for bin %.2f-%.2f;#eta;#phi", iM, ptCuts.value[2 * iPt], ptCuts.value[2 * iPt + 1]), HistType::kTH2F, {{binningM[iM], -0.8, 0.8}, {binningM[iM], 0, o2::constants::math::TwoPI}}));
-        mHistArrReset.push_back(mHistsR);
+        Occupancy occupancy;
+        occupancy.counts.assign(binningM[iM] * binningM[iM], 0);
+        mOccupancies.push_back(occupancy);
         for (int iq = 0; iq < nfqOrder; ++iq) {
           tmpFqErr[iq][iPt][iM] = new TH1D(Form("tmpFqErr%i%i%i", iq, iPt, iM), Form("tmpFqErr%i%i%i", iq, iPt, iM), 100, 0, 10);
         }
@@ -267,13 +276,36 @@ struct FactorialMomentsTask {
         mHistArrQA[iPt * 4 + 1]->Fill(track.pt());
         mHistArrQA[iPt * 4 + 2]->Fill(iphi);
         countTracks[iPt]++;
-        for (auto iM = 0; iM < nBins; ++iM) {
-          mHistArrReset[iPt * nBins + iM]->Fill(track.eta(), iphi);
-        }
+        fillOccupancies(iPt, track.eta(), iphi);
+      }
+    }
+  }
+  void fillOccupancies(int iPt, float eta, float phi)
+  {
+    for (int iM = 0; iM < nBins; ++iM) {
+      // M x M eta-phi cells as binned by ROOT, under- and overflows do not enter the moments
+      int iEta = mEtaAxes[iM].FindFixBin(eta);
+      int iPhi = mPhiAxes[iM].FindFixBin(phi);
+      if (iEta < 1 || iEta > binningM[iM] || iPhi < 1 || iPhi > binningM[iM]) {
+        continue;
+      }
+      auto& occupancy = mOccupancies[iPt * nBins + iM];
+      int cell = (iEta - 1) * binningM[iM] + (iPhi - 1);
+      if (occupancy.counts[cell]++ == 0) {
+        occupancy.occupiedCells.push_back(cell);
       }
     }
   }
-  void calculateMoments(std::vector<std::shared_ptr<TH2>> hist)
+  void resetOccupancies()
+  {
+    for (auto& occupancy : mOccupancies) {
+      for (const auto& cell : occupancy.occupiedCells) {
+        occupancy.counts[cell] = 0;
+      }
+      occupancy.occupiedCells.clear();
+    }
+  }
+  void calculateMoments()
   {
     double binContent = 0;
     countSamples++;
@@ -288,21 +320,15 @@ struct FactorialMomentsTask {
         binContent = 0;
         double sumfqBin[6] = {0};
 
-        for (int iEta = 1; iEta <= hist[iPt * nBins + iM]->GetNbinsX(); ++iEta) {
-          for (int iPhi = 1; iPhi <= hist[iPt * nBins + iM]->GetNbinsY(); ++iPhi) {
-            double binconVal = 0;
-            binconVal = hist[iPt * nBins + iM]->GetBinContent(iEta, iPhi);
-            binContent += binconVal;
-            for (int iq = 0; iq < nfqOrder; ++iq) {
-              double fqBin = 0;
-              if (binconVal >= iq + 2) {
-                fqBin = TMath::Factorial(binconVal) / (TMath::Factorial(binconVal - (iq + 2)));
-              }
-              if (std::isnan(fqBin)) {
-                break;
-              }
-              sumfqBin[iq] += fqBin;
-            }
+        const auto& occupancy = mOccupancies[iPt * nBins + iM];
+        for (const auto& cell : occupancy.occupiedCells) {
+          int binconVal = occupancy.counts[cell];
+          binContent += binconVal;
+          // falling factorial n (n - 1) ... (n - q + 1) for q = iq + 2
+          double fqBin = binconVal;
+          for (int iq = 0; iq < nfqOrder && binconVal >= iq + 2; ++iq) {
+            fqBin *= binconVal - (iq + 1);
+            sumfqBin[iq] += fqBin;
           }
         }
         binConEvent[iPt][iM] = binContent / (std::pow(binningM[iM], 2));
@@ -375,9 +401,7 @@ struct FactorialMomentsTask {
     histos.fill(HIST("mCentFV0A"), coll.centFV0A());
     histos.fill(HIST("mCentFT0A"), coll.centFT0A());
     histos.fill(HIST("mCentFT0C"), coll.centFT0C());
-    for (auto const& h : mHistArrReset) {
-      h->Reset();
-    }
+    resetOccupancies();
     countTracks = {0, 0, 0, 0, 0};
     fqEvent = {{{{{0, 0, 0, 0, 0, 0}}}}};
     binConEvent = {{{0, 0, 0, 0, 0}}};
@@ -419,7 +443,7 @@ struct FactorialMomentsTask {
         mHistArrQA[iPt * 4 + 3]->Fill(countTracks[iPt]);
       }
     }
-    calculateMoments(mHistArrReset);
+    calculateMoments();
   }
   PROCESS_SWITCH(FactorialMomentsTask, processRun3, "main process function", false);
   using CollisionCandidateMCRec = soa::Join<aod::Collisions, aod::McCollisionLabels, aod::EvSels, aod::CentFT0Cs>;
@@ -455,9 +479,7 @@ struct FactorialMomentsTask {
     histos.fill(HIST("mVertexY"), coll.posY());
     histos.fill(HIST("mVertexZ"), coll.posZ());
     histos.fill(HIST("mCentFT0C"), coll.centFT0C());
-    for (auto const& h : mHistArrReset) {
-      h->Reset();
-    }
+    resetOccupancies();
     countTracks = {0, 0, 0, 0, 0};
     fqEvent = {{{{{0, 0, 0, 0, 0, 0}}}}};
     binConEvent = {{{0, 0, 0, 0, 0}}};
@@ -521,7 +543,7 @@ struct FactorialMomentsTask {
       }
     }
     histos.fill(HIST("mEventSelected"), 6);
-    calculateMoments(mHistArrReset);
+    calculateMoments();
   }
   PROCESS_SWITCH(FactorialMomentsTask, processMCRec, "main process function", false);
   using EventSelectionrun2 = soa::Join<aod::EvSels, aod::Mults, aod::CentRun2V0Ms, aod::CentRun2SPDTrks>;
@@ -546,9 +568,7 @@ struct FactorialMomentsTask {
     histos.fill(HIST("mVertexY"), coll.posY());
     histos.fill(HIST("mVertexZ"), coll.posZ());
     histos.fill(HIST("mCentFT0M"), coll.centRun2V0M());
-    for (auto const& h : mHistArrReset) {
-      h->Reset();
-    }
+    resetOccupancies();
     countTracks = {0, 0, 0, 0, 0};
     fqEvent = {{{{{0, 0, 0, 0, 0, 0}}}}};
     binConEvent = {{{0, 0, 0, 0, 0}}};
@@ -600,7 +620,7 @@ struct FactorialMomentsTask {
       }
     }
 
-    calculateMoments(mHistArrReset);
+    calculateMoments();
   }
 
   PROCESS_SWITCH(FactorialMomentsTask, processMcRun2, "process MC Run2", true);
@@ -617,9 +637,7 @@ struct FactorialMomentsTask {
     histos.fill(HIST("mVertexZ"), coll.posZ());
     histos.fill(HIST("mCentFT0M"), coll.centRun2V0M());
 
-    for (auto const& h : mHistArrReset) {
-      h->Reset();
-    }
+    resetOccupancies();
     countTracks = {0, 0, 0, 0, 0};
     fqEvent = {{{{{0, 0, 0, 0, 0, 0}}}}};
     binConEvent = {{{0, 0, 0, 0, 0}}};
@@ -655,7 +673,7 @@ struct FactorialMomentsTask {
       }
     }
     // Calculate the normalized factorial moments
-    calculateMoments(mHistArrReset);
+    calculateMoments();
   }
   PROCESS_SWITCH(FactorialMomentsTask, processRun2, "for RUN2", false);
 };
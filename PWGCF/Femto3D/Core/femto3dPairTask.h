@@ -29,6 +29,7 @@
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #define THETA(eta) 2.0 * std::atan(std::exp(-eta))
@@ -95,6 +96,11 @@ inline std::unique_ptr<double[]> calc_var_bins(const int& N, const float& xmax,
 
 namespace o2::aod::singletrackselector
 {
+inline int getSubBinDelimeter(int const& NsubBins)
+{
+  return NsubBins < 2 ? 1 : std::pow(10, std::to_string(NsubBins).size());
+}
+
 template <typename Type>
 Type getBinIndex(float const& value, std::vector<float> const& binning, int const& NsubBins = 1)
 {
@@ -107,7 +113,7 @@ Type getBinIndex(float const& value, std::vector<float> const& binning, int cons
       } else {
         float subBinWidth = (binning[i + 1] - binning[i]) / NsubBins;
         int subBin = std::floor((value - binning[i]) / subBinWidth);
-        int delimeter = std::pow(10, std::to_string(NsubBins).size());
+        int delimeter = getSubBinDelimeter(NsubBins);
 
         res = (Type)i + (Type)subBin / delimeter;
         break;
@@ -117,6 +123,25 @@ Type getBinIndex(float const& value, std::vector<float> const& binning, int cons
   return res;
 }
 
+// integer counterpart of getBinIndex<float> with sub-bins: bin * getSubBinDelimeter(NsubBins) + sub-bin, in the same order
+inline int getBinIndexWithSubBins(float const& value, std::vector<float> const& binning, int const& NsubBins)
+{
+  int res = 10e6;
+  for (unsigned int i = 0; i < binning.size() - 1; i++) {
+    if (value >= binning[i] && binning[i + 1] > value) {
+      if (NsubBins < 2) {
+        res = i;
+      } else {
+        float subBinWidth = (binning[i + 1] - binning[i]) / NsubBins;
+        int subBin = std::floor((value - binning[i]) / subBinWidth);
+        res = i * getSubBinDelimeter(NsubBins) + subBin;
+      }
+      break;
+    }
+  }
+  return res;
+}
+
 //====================================================================================
 
 float GetKstarFrom4vectors(TLorentzVector& first4momentum, TLorentzVector& second4momentum, bool isIdentical)
@@ -149,6 +174,132 @@ TVector3 GetQLCMSFrom4vectors(TLorentzVector& first4momentum, TLorentzVector& se
 
 //====================================================================================
 
+// components of a four-momentum as set by TLorentzVector::SetPtEtaPhiM
+struct FemtoFourMomentum {
+  double px = 0., py = 0., pz = 0., e = 0.;
+};
+
+inline FemtoFourMomentum GetFourMomentum(const double& pt, const double& eta, const double& phi, const double& mass)
+{
+  FemtoFourMomentum p;
+  p.px = pt * std::cos(phi);
+  p.py = pt * std::sin(phi);
+  p.pz = pt * std::sinh(eta);
+  p.e = std::sqrt(p.px * p.px + p.py * p.py + p.pz * p.pz + mass * mass);
+  return p;
+}
+
+// closed forms of GetKstarFrom4vectors and GetQLCMSFrom4vectors, without boosting and rotating TLorentzVectors:
+// with q = p1 - p2 and P = p1 + p2, 2k* is the modulus of q projected orthogonally to P, q_out and q_side are the
+// components of q along and perpendicular to the pair's kT, q_long is the longitudinal component in the LCMS
+inline float GetKstarFromFourMomenta(const FemtoFourMomentum& first, const FemtoFourMomentum& second, const bool& isIdentical)
+{
+  const double q0 = first.e - second.e, qx = first.px - second.px, qy = first.py - second.py, qz = first.pz - second.pz;
+  const double q2 = q0 * q0 - (qx * qx + qy * qy + qz * qz);
+  if (isIdentical)
+    return 0.5 * std::sqrt(std::fabs(q2));
+
+  const double e = first.e + second.e, px = first.px + second.px, py = first.py + second.py, pz = first.pz + second.pz;
+  const double qP = q0 * e - (qx * px + qy * py + qz * pz);
+  const double kstar2 = qP * qP / (e * e - (px * px + py * py + pz * pz)) - q2;
+  return 0.5 * std::sqrt(std::fabs(kstar2));
+}
+
+inline TVector3 GetQLCMSFromFourMomenta(const FemtoFourMomentum& first, const FemtoFourMomentum& second)
+{
+  const double q0 = first.e - second.e, qx = first.px - second.px, qy = first.py - second.py, qz = first.pz - second.pz;
+  const double e = first.e + second.e, px = first.px + second.px, py = first.py + second.py, pz = first.pz + second.pz;
+
+  const double qlong = (e * qz - pz * q0) / std::sqrt(e * e - pz * pz);
+  const double pt = std::sqrt(px * px + py * py);
+  if (pt == 0.)
+    return TVector3(qx, qy, qlong); // no rotation, as TVector3::Phi() is 0 for a pair with kT = 0
+
+  return TVector3((qx * px + qy * py) / pt, (qy * px - qx * py) / pt, qlong);
+}
+
+// 0.5 * transverse mass of the pair, see TLorentzVector::Mt()
+inline float GetMtFromFourMomenta(const FemtoFourMomentum& first, const FemtoFourMomentum& second)
+{
+  const double e = first.e + second.e, pz = first.pz + second.pz;
+  const double mt2 = e * e - pz * pz;
+  return 0.5 * (mt2 < 0.0 ? -std::sqrt(-mt2) : std::sqrt(mt2));
+}
+
+// Lorentz factor of the pair in the LCMS: ratio of the transverse mass to the invariant mass
+inline float GetGammaOutFromFourMomenta(const FemtoFourMomentum& first, const FemtoFourMomentum& second)
+{
+  const double e = first.e + second.e, px = first.px + second.px, py = first.py + second.py, pz = first.pz + second.pz;
+  return std::sqrt((e * e - pz * pz) / (e * e - (px * px + py * py + pz * pz)));
+}
+
+//====================================================================================
+
+// TPC radii (m) at which the average phi* difference and the average separation of a pair are evaluated
+constexpr std::array<float, 9> TPCradii = {0.85, 1.05, 1.25, 1.45, 1.65, 1.85, 2.05, 2.25, 2.45};
+
+// same as the dynamic column singletrackselector::PhiStar
+inline float GetPhiStar(const float& p, const float& eta, const float& sign, const float& phi, const float& magfield, const float& radius)
+{
+  if (magfield == 0.0)
+    return -1000.0;
+  return phi + std::asin(-0.3 * magfield * sign * radius / (2.0 * p / std::cosh(eta)));
+}
+
+// Selected track with the quantities used in the pair loops computed once, to be paired with FemtoPair<FemtoTrack const*>.
+// The four-momentum is computed for the given mass and phi* for the magnetic field of the track's collision,
+// at the TPCradii and at one additional radius; any other mass, field or radius is computed on the fly.
+class FemtoTrack
+{
+ public:
+  template <typename TrackType>
+  FemtoTrack(TrackType const& track, const double& mass, const float& magfield, const float& radius)
+    : _pt(track.pt()), _eta(track.eta()), _phi(track.phi()), _px(track.px()), _py(track.py()), _p(track.p()), _sign(track.sign()), _mass(mass), _magfield(magfield), _radius(radius)
+  {
+    _theta = THETA(_eta);
+    _fourMomentum = GetFourMomentum(_pt, _eta, _phi, _mass);
+    for (std::size_t i = 0; i < TPCradii.size(); i++)
+      _phiStarTPC[i] = GetPhiStar(_p, _eta, _sign, _phi, _magfield, TPCradii[i]);
+    _phiStarAtRadius = GetPhiStar(_p, _eta, _sign, _phi, _magfield, _radius);
+  }
+
+  float pt() const { return _pt; }
+  float eta() const { return _eta; }
+  float phi() const { return _phi; }
+  float px() const { return _px; }
+  float py() const { return _py; }
+  float p() const { return _p; }
+  float sign() const { return _sign; }
+  double mass() const { return _mass; }
+  double theta() const { return _theta; }
+  FemtoFourMomentum const& fourMomentum() const { return _fourMomentum; }
+
+  float phiStar(const float& magfield, const float& radius) const
+  {
+    if (magfield == _magfield) {
+      if (radius == _radius)
+        return _phiStarAtRadius;
+      for (std::size_t i = 0; i < TPCradii.size(); i++) {
+        if (radius == TPCradii[i])
+          return _phiStarTPC[i];
+      }
+    }
+    return GetPhiStar(_p, _eta, _sign, _phi, magfield, radius);
+  }
+  float phiStarTPC(const std::size_t& iRadius, const float& magfield) const { return magfield == _magfield ? _phiStarTPC[iRadius] : GetPhiStar(_p, _eta, _sign, _phi, magfield, TPCradii[iRadius]); }
+
+ private:
+  float _pt, _eta, _phi, _px, _py, _p, _sign;
+  double _mass;
+  float _magfield, _radius;
+  double _theta;
+  FemtoFourMomentum _fourMomentum;
+  std::array<float, TPCradii.size()> _phiStarTPC;
+  float _phiStarAtRadius;
+};
+
+//====================================================================================
+
 template <typename TrackType>
 class FemtoPair
 {
@@ -223,8 +374,7 @@ class FemtoPair
   float GetPhiStarDiff(const float& radius = 1.2) const
   {
     if (_first != NULL && _second != NULL) {
-      float dphi = _first->phiStar(_magfield1, radius) - _second->phiStar(_magfield2, radius);
-      return std::fabs(dphi) > o2::constants::math::PI ? (1.0 - 2.0 * o2::constants::math::PI / std::fabs(dphi)) * dphi : dphi;
+      return WrapPhiStarDiff(_first->phiStar(_magfield1, radius) - _second->phiStar(_magfield2, radius));
     } else {
       return 1000;
     }
@@ -243,7 +393,37 @@ class FemtoPair
   float _magfield1 = 0.0, _magfield2 = 0.0;
   int _PDG1 = 0, _PDG2 = 0;
   bool _isidentical = true;
-  std::array<float, 9> TPCradii = {0.85, 1.05, 1.25, 1.45, 1.65, 1.85, 2.05, 2.25, 2.45};
+
+  static constexpr bool _isFemtoTrack = std::is_same_v<TrackType, FemtoTrack const*>;
+
+  static float WrapPhiStarDiff(const float& dphi)
+  {
+    return std::fabs(dphi) > o2::constants::math::PI ? (1.0 - 2.0 * o2::constants::math::PI / std::fabs(dphi)) * dphi : dphi;
+  }
+  // phi* difference at TPCradii[iRadius], precomputed for FemtoTrack
+  float GetPhiStarDiffTPC(const std::size_t& iRadius) const
+  {
+    if constexpr (_isFemtoTrack)
+      return WrapPhiStarDiff(_first->phiStarTPC(iRadius, _magfield1) - _second->phiStarTPC(iRadius, _magfield2));
+    else
+      return GetPhiStarDiff(TPCradii[iRadius]);
+  }
+  static double GetTheta(TrackType const& track)
+  {
+    if constexpr (_isFemtoTrack)
+      return track->theta();
+    else
+      return THETA(track->eta());
+  }
+  static FemtoFourMomentum GetFourMomentum(TrackType const& track, const int& PDG)
+  {
+    const double mass = particle_mass(PDG);
+    if constexpr (_isFemtoTrack) {
+      if (track->mass() == mass)
+        return track->fourMomentum();
+    }
+    return o2::aod::singletrackselector::GetFourMomentum(track->pt(), track->eta(), track->phi(), mass);
+  }
 };
 
 template <typename TrackType>
@@ -306,12 +486,13 @@ float FemtoPair<TrackType>::GetAvgSep() const
   if (_magfield1 * _magfield2 == 0)
     return -100.f;
 
-  float dtheta = THETA(_first->eta()) - THETA(_second->eta());
+  float dtheta = GetTheta(_first) - GetTheta(_second);
+  const double sinHalfDtheta = std::sin(0.5 * dtheta);
   float res = 0.0;
 
-  for (const auto& radius : TPCradii) {
-    const float dRtrans = 2.0 * radius * std::sin(0.5 * GetPhiStarDiff(radius));
-    const float dRlong = 2.0 * radius * std::sin(0.5 * dtheta);
+  for (std::size_t i = 0; i < TPCradii.size(); i++) {
+    const float dRtrans = 2.0 * TPCradii[i] * std::sin(0.5 * GetPhiStarDiffTPC(i));
+    const float dRlong = 2.0 * TPCradii[i] * sinHalfDtheta;
     res += std::sqrt(dRtrans * dRtrans + dRlong * dRlong);
   }
 
@@ -328,8 +509,8 @@ float FemtoPair<TrackType>::GetAvgPhiStarDiff() const
 
   float res = 0.0;
 
-  for (const auto& radius : TPCradii) {
-    res += GetPhiStarDiff(radius);
+  for (std::size_t i = 0; i < TPCradii.size(); i++) {
+    res += GetPhiStarDiffTPC(i);
   }
 
   return res / TPCradii.size();
@@ -345,12 +526,7 @@ float FemtoPair<TrackType>::GetKstar() const
   if (_PDG1 * _PDG2 == 0)
     return -1000;
 
-  TLorentzVector first4momentum;
-  first4momentum.SetPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), particle_mass(_PDG1));
-  TLorentzVector second4momentum;
-  second4momentum.SetPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), particle_mass(_PDG2));
-
-  return GetKstarFrom4vectors(first4momentum, second4momentum, _isidentical);
+  return GetKstarFromFourMomenta(GetFourMomentum(_first, _PDG1), GetFourMomentum(_second, _PDG2), _isidentical);
 }
 
 template <typename TrackType>
@@ -363,12 +539,7 @@ TVector3 FemtoPair<TrackType>::GetQLCMS() const
   if (_PDG1 * _PDG2 == 0)
     return TVector3(-1000, -1000, -1000);
 
-  TLorentzVector first4momentum;
-  first4momentum.SetPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), particle_mass(_PDG1));
-  TLorentzVector second4momentum;
-  second4momentum.SetPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), particle_mass(_PDG2));
-
-  return GetQLCMSFrom4vectors(first4momentum, second4momentum);
+  return GetQLCMSFromFourMomenta(GetFourMomentum(_first, _PDG1), GetFourMomentum(_second, _PDG2));
 }
 
 template <typename TrackType>
@@ -395,14 +566,7 @@ float FemtoPair<TrackType>::GetMt() const
   if (_PDG1 * _PDG2 == 0)
     return -1000;
 
-  TLorentzVector first4momentum;
-  first4momentum.SetPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), particle_mass(_PDG1));
-  TLorentzVector second4momentum;
-  second4momentum.SetPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), particle_mass(_PDG2));
-
-  TLorentzVector fourmomentasum = first4momentum + second4momentum;
-
-  return 0.5 * fourmomentasum.Mt();
+  return GetMtFromFourMomenta(GetFourMomentum(_first, _PDG1), GetFourMomentum(_second, _PDG2));
 }
 
 template <typename TrackType>
@@ -420,17 +584,7 @@ float FemtoPair<TrackType>::GetGammaOut() const
   // double Qout_PRF = sqrt(Qinv * Qinv - QLCMS.Y() * QLCMS.Y() - QLCMS.Z() * QLCMS.Z());
   // return std::fabs(QLCMS.X() / Qout_PRF);
 
-  TLorentzVector first4momentum;
-  first4momentum.SetPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), particle_mass(_PDG1));
-  TLorentzVector second4momentum;
-  second4momentum.SetPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), particle_mass(_PDG2));
-
-  TLorentzVector fourmomentasum = first4momentum + second4momentum;
-
-  fourmomentasum.Boost(0.0, 0.0, (-1) * fourmomentasum.BoostVector().Z()); // boost to LCMS
-  fourmomentasum.RotateZ((-1) * fourmomentasum.Phi());                     // rotate so the X axis is along pair's kT
-
-  return fourmomentasum.Gamma();
+  return GetGammaOutFromFourMomenta(GetFourMomentum(_first, _PDG1), GetFourMomentum(_second, _PDG2));
 }
 } // namespace o2::aod::singletrackselector
 
@@ -134,12 +134,18 @@ struct FemtoCorrelations {
   // using FilteredTracks = soa::Join<aod::SingleTrackSels, aod::SinglePIDPis, aod::SinglePIDKas, aod::SinglePIDPrs, aod::SinglePIDDes, aod::SinglePIDTrs, aod::SinglePIDHes>; // main
   using FilteredTracks = soa::Join<aod::SingleTrackSels, aod::SinglePIDPrs, aod::SinglePIDDes>; // tmp solution till the HL is fixed
 
-  typedef std::shared_ptr<soa::Filtered<FilteredTracks>::iterator> trkType;
+  typedef o2::aod::singletrackselector::FemtoTrack const* trkType;
   typedef std::shared_ptr<soa::Filtered<FilteredCollisions>::iterator> colType;
 
-  std::map<int64_t, std::vector<trkType>> selectedtracks_1;
-  std::map<int64_t, std::vector<trkType>> selectedtracks_2;
-  std::map<std::pair<int, float>, std::vector<colType>> mixbins;
+  // selected tracks per collision, indexed with the collision index; the kinematics needed in the pair loops are computed once per track
+  std::vector<std::vector<o2::aod::singletrackselector::FemtoTrack>> selectedtracks_1;
+  std::vector<std::vector<o2::aod::singletrackselector::FemtoTrack>> selectedtracks_2;
+  const std::vector<o2::aod::singletrackselector::FemtoTrack> noSelectedTracks;
+  std::map<std::pair<int, int>, std::vector<colType>> mixbins; // {vertex bin, cent. bin * centSubBinsDelimiter + cent. sub-bin} <-> collisions
+
+  double mass_1 = 0.0, mass_2 = 0.0;
+  int centSubBinsDelimiter = 1;
+  std::mt19937 randomGen; // for the pair order in the 3D histos and the ME reduction
 
   std::unique_ptr<o2::aod::singletrackselector::FemtoPair<trkType>> Pair = std::make_unique<o2::aod::singletrackselector::FemtoPair<trkType>>();
 
@@ -193,6 +199,11 @@ struct FemtoCorrelations {
 
     IsIdentical = (_sign_1 * _particlePDG_1 == _sign_2 * _particlePDG_2);
 
+    mass_1 = particle_mass(_particlePDG_1);
+    mass_2 = particle_mass(_particlePDG_2);
+    centSubBinsDelimiter = o2::aod::singletrackselector::getSubBinDelimeter(_multNsubBins);
+    randomGen.seed(std::chrono::steady_clock::now().time_since_epoch().count());
+
     Pair->SetIdentical(IsIdentical);
     Pair->SetPDG1(_particlePDG_1);
     Pair->SetPDG2(_particlePDG_2);
@@ -300,6 +311,23 @@ struct FemtoCorrelations {
     }
   }
 
+  // selected tracks of a collision, empty if none was selected
+  std::vector<o2::aod::singletrackselector::FemtoTrack> const& getSelectedTracks(std::vector<std::vector<o2::aod::singletrackselector::FemtoTrack>> const& selectedtracks, int64_t collisionId) const
+  {
+    if (collisionId < 0 || collisionId >= static_cast<int64_t>(selectedtracks.size()))
+      return noSelectedTracks;
+    return selectedtracks[collisionId];
+  }
+
+  template <typename TrackType>
+  void addSelectedTrack(std::vector<std::vector<o2::aod::singletrackselector::FemtoTrack>>& selectedtracks, TrackType const& track, double mass)
+  {
+    const int64_t collisionId = track.singleCollSelId();
+    if (collisionId >= static_cast<int64_t>(selectedtracks.size()))
+      selectedtracks.resize(collisionId + 1);
+    selectedtracks[collisionId].emplace_back(track, mass, track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().magField(), _radiusTPC.value);
+  }
+
   template <typename Type>
   void mixTracks(Type const& tracks, unsigned int multBin)
   { // template for identical particles from the same collision
@@ -311,7 +339,7 @@ struct FemtoCorrelations {
     for (unsigned int ii = 0; ii < tracks.size(); ii++) { // nested loop for all the combinations
       for (unsigned int iii = ii + 1; iii < tracks.size(); iii++) {
 
-        Pair->SetPair(tracks[ii], tracks[iii]);
+        Pair->SetPair(&tracks[ii], &tracks[iii]);
         float pair_kT = Pair->GetKt();
 
         if (pair_kT < *_kTbins.value.begin() || pair_kT >= *(_kTbins.value.end() - 1))
@@ -339,8 +367,7 @@ struct FemtoCorrelations {
         SEhistos_1D[multBin][kTbin]->Fill(Pair->GetKstar()); // close pair rejection and fillig the SE histo
 
         if (_fill3dCF) {
-          std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-          TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
+          TVector3 qLCMS = std::pow(-1, (randomGen() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
           SEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
         }
         Pair->ResetPair();
@@ -356,10 +383,10 @@ struct FemtoCorrelations {
     if (_fill3dCF && multBin > SEhistos_3D.size())
       LOGF(fatal, "multBin value passed to the mixTracks function exceeds the configured number of Cent. bins (3D)");
 
-    for (auto ii : tracks1) {
-      for (auto iii : tracks2) {
+    for (const auto& ii : tracks1) {
+      for (const auto& iii : tracks2) {
 
-        Pair->SetPair(ii, iii);
+        Pair->SetPair(&ii, &iii);
         float pair_kT = Pair->GetKt();
 
         if (pair_kT < *_kTbins.value.begin() || pair_kT >= *(_kTbins.value.end() - 1))
@@ -396,16 +423,14 @@ struct FemtoCorrelations {
           mThistos[multBin][kTbin]->Fill(Pair->GetMt()); // test
 
           if (_fill3dCF) {
-            std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-            TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
+            TVector3 qLCMS = std::pow(-1, (randomGen() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
             SEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
           }
         } else {
           MEhistos_1D[multBin][kTbin]->Fill(Pair->GetKstar());
 
           if (_fill3dCF) {
-            std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-            TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
+            TVector3 qLCMS = std::pow(-1, (randomGen() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
             MEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
             if (_fill3dAddHistos == 1)
               Add3dHistos[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z(), Pair->GetKstar());
@@ -450,7 +475,7 @@ struct FemtoCorrelations {
         continue;
 
       if (track.sign() == _sign_1 && (track.p() < _PIDtrshld_1 ? o2::aod::singletrackselector::TPCselection<true>(track, TPCcuts_1, _itsNSigma_1.value) : o2::aod::singletrackselector::TOFselection(track, TOFcuts_1, _tpcNSigmaResidual_1.value))) { // filling the map: eventID <-> selected particles1
-        selectedtracks_1[track.singleCollSelId()].push_back(std::make_shared<soa::Filtered<FilteredTracks>::iterator>(track));
+        addSelectedTrack(selectedtracks_1, track, mass_1);
 
         pHisto_first->Fill(track.p());
         ITShisto_first->Fill(track.p(), o2::aod::singletrackselector::getITSNsigma(track, _particlePDG_1));
@@ -461,7 +486,7 @@ struct FemtoCorrelations {
       if (IsIdentical) {
         continue;
       } else if (track.sign() != _sign_2 && !TOFselection(track, std::make_pair(_particlePDGtoReject, _rejectWithinNsigmaTOF)) && (track.p() < _PIDtrshld_2 ? o2::aod::singletrackselector::TPCselection<true>(track, TPCcuts_2, _itsNSigma_2.value) : o2::aod::singletrackselector::TOFselection(track, TOFcuts_2, _tpcNSigmaResidual_2.value))) { // filling the map: eventID <-> selected particles2 if (see condition above ^)
-        selectedtracks_2[track.singleCollSelId()].push_back(std::make_shared<soa::Filtered<FilteredTracks>::iterator>(track));
+        addSelectedTrack(selectedtracks_2, track, mass_2);
 
         pHisto_second->Fill(track.p());
         ITShisto_second->Fill(track.p(), o2::aod::singletrackselector::getITSNsigma(track, _particlePDG_2));
@@ -490,16 +515,16 @@ struct FemtoCorrelations {
         continue;
       if (_requestIsGoodITSLayersAll && !collision.isGoodITSLayersAll())
         continue;
-      if (selectedtracks_1.find(collision.globalIndex()) == selectedtracks_1.end()) {
+      if (getSelectedTracks(selectedtracks_1, collision.globalIndex()).empty()) {
         if (IsIdentical)
           continue;
-        else if (selectedtracks_2.find(collision.globalIndex()) == selectedtracks_2.end())
+        else if (getSelectedTracks(selectedtracks_2, collision.globalIndex()).empty())
           continue;
       }
       int vertexBinToMix = std::floor((collision.posZ() + _vertexZ) / (2 * _vertexZ / _vertexNbinsToMix));
-      float centBinToMix = o2::aod::singletrackselector::getBinIndex<float>(collision.multPerc(), _centBins, _multNsubBins);
+      int centBinToMix = o2::aod::singletrackselector::getBinIndexWithSubBins(collision.multPerc(), _centBins, _multNsubBins);
 
-      mixbins[std::pair<int, float>{vertexBinToMix, centBinToMix}].push_back(std::make_shared<soa::Filtered<FilteredCollisions>::iterator>(collision));
+      mixbins[std::pair<int, int>{vertexBinToMix, centBinToMix}].push_back(std::make_shared<soa::Filtered<FilteredCollisions>::iterator>(collision));
     }
 
     //====================================== mixing starts here ======================================
@@ -516,26 +541,25 @@ struct FemtoCorrelations {
           Pair->SetMagField1(col1->magField());
           Pair->SetMagField2(col1->magField());
 
-          unsigned int centBin = std::floor((i->first).second);
+          unsigned int centBin = (i->first).second / centSubBinsDelimiter;
           MultHistos[centBin]->Fill(col1->mult());
 
-          if (selectedtracks_1[col1->index()].size() > 1) {
+          if (getSelectedTracks(selectedtracks_1, col1->index()).size() > 1) {
             MultHistos_pair[centBin]->Fill(col1->mult());
           }
 
-          mixTracks(selectedtracks_1[col1->index()], centBin); // mixing SE identical
+          mixTracks(getSelectedTracks(selectedtracks_1, col1->index()), centBin); // mixing SE identical
 
           for (unsigned int indx2 = indx1 + 1; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
             if (_MEreductionFactor.value > 1) {
-              std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-              if ((mt() % (_MEreductionFactor.value + 1)) < _MEreductionFactor.value)
+              if ((randomGen() % (_MEreductionFactor.value + 1)) < _MEreductionFactor.value)
                 continue;
             }
 
             auto col2 = (i->second)[indx2];
 
             Pair->SetMagField2(col2->magField());
-            mixTracks<1>(selectedtracks_1[col1->index()], selectedtracks_1[col2->index()], centBin); // mixing ME identical, in <> brackets: 0 -- SE; 1 -- ME
+            mixTracks<1>(getSelectedTracks(selectedtracks_1, col1->index()), getSelectedTracks(selectedtracks_1, col2->index()), centBin); // mixing ME identical, in <> brackets: 0 -- SE; 1 -- ME
           }
         }
       }
@@ -552,37 +576,34 @@ struct FemtoCorrelations {
           Pair->SetMagField1(col1->magField());
           Pair->SetMagField2(col1->magField());
 
-          unsigned int centBin = std::floor((i->first).second);
+          unsigned int centBin = (i->first).second / centSubBinsDelimiter;
           MultHistos[centBin]->Fill(col1->mult());
 
-          mixTracks<0>(selectedtracks_1[col1->index()], selectedtracks_2[col1->index()], centBin); // mixing SE non-identical, in <> brackets: 0 -- SE; 1 -- ME
+          mixTracks<0>(getSelectedTracks(selectedtracks_1, col1->index()), getSelectedTracks(selectedtracks_2, col1->index()), centBin); // mixing SE non-identical, in <> brackets: 0 -- SE; 1 -- ME
 
           for (unsigned int indx2 = indx1 + 1; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
             if (_MEreductionFactor.value > 1) {
-              std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-              if (mt() % (_MEreductionFactor.value + 1) < _MEreductionFactor.value)
+              if (randomGen() % (_MEreductionFactor.value + 1) < _MEreductionFactor.value)
                 continue;
             }
 
             auto col2 = (i->second)[indx2];
 
             Pair->SetMagField2(col2->magField());
-            mixTracks<1>(selectedtracks_1[col1->index()], selectedtracks_2[col2->index()], centBin); // mixing ME non-identical, in <> brackets: 0 -- SE; 1 -- ME
+            mixTracks<1>(getSelectedTracks(selectedtracks_1, col1->index()), getSelectedTracks(selectedtracks_2, col2->index()), centBin); // mixing ME non-identical, in <> brackets: 0 -- SE; 1 -- ME
           }
         }
       }
 
     } //====================================== end of mixing non-identical ======================================
 
-    // clearing up
-    for (auto i = selectedtracks_1.begin(); i != selectedtracks_1.end(); i++)
-      (i->second).clear();
-    selectedtracks_1.clear();
+    // clearing up, the per-collision buffers keep their capacity for the next DF
+    for (auto& tracksPerCol : selectedtracks_1)
+      tracksPerCol.clear();
 
     if (!IsIdentical) {
-      for (auto i = selectedtracks_2.begin(); i != selectedtracks_2.end(); i++)
-        (i->second).clear();
-      selectedtracks_2.clear();
+      for (auto& tracksPerCol : selectedtracks_2)
+        tracksPerCol.clear();
     }
 
     for (auto i = mixbins.begin(); i != mixbins.end(); i++)
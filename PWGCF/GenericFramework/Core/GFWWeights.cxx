@@ -25,7 +25,10 @@
 
 #include <RtypesCore.h>
 
+#include <algorithm>
 #include <cstdio>
+#include <span>
+#include <vector>
 
 GFWWeights::GFWWeights() : TNamed("", ""),
                            fDataFilled(kFALSE),
@@ -159,8 +162,14 @@ double GFWWeights::getWeight(double phi, double eta, double vz, double pt, doubl
 };
 double GFWWeights::getNUA(double phi, double eta, double vz)
 {
-  if (!fAccInt)
-    createNUA();
+  if (!fGridCompiled[kNUAGrid])
+    compileNUA();
+  if (!fGrid[kNUAGrid].empty()) {
+    double weight = fInterpolateNUA ? gridInterpolate(kNUAGrid, phi, eta, vz) : gridContent(kNUAGrid, phi, eta, vz);
+    if (weight != 0)
+      return 1. / weight;
+    return 1;
+  }
   int xind = fAccInt->GetXaxis()->FindBin(phi);
   int etaind = fAccInt->GetYaxis()->FindBin(eta);
   int vzind = fAccInt->GetZaxis()->FindBin(vz);
@@ -169,10 +178,33 @@ double GFWWeights::getNUA(double phi, double eta, double vz)
     return 1. / weight;
   return 1;
 }
+void GFWWeights::getNUA(std::span<const float> phi, std::span<const float> eta, double vz, std::span<double> weights)
+{
+  if (!fGridCompiled[kNUAGrid])
+    compileNUA();
+  if (fGrid[kNUAGrid].empty() || fInterpolateNUA) {
+    for (size_t i = 0; i < phi.size(); i++)
+      weights[i] = getNUA(phi[i], eta[i], vz);
+    return;
+  }
+  const int nx = fGridBins[kNUAGrid][0] + 2;
+  const int ny = fGridBins[kNUAGrid][1] + 2;
+  const double* vzSlice = fGrid[kNUAGrid].data() + static_cast<size_t>(nx) * ny * gridBin(kNUAGrid, 2, vz);
+  for (size_t i = 0; i < phi.size(); i++) {
+    double weight = vzSlice[gridBin(kNUAGrid, 0, phi[i]) + nx * gridBin(kNUAGrid, 1, eta[i])];
+    weights[i] = (weight != 0) ? 1. / weight : 1.;
+  }
+}
 double GFWWeights::getNUE(double pt, double eta, double vz)
 {
-  if (!fEffInt)
-    createNUE();
+  if (!fGridCompiled[kNUEGrid])
+    compileNUE();
+  if (!fGrid[kNUEGrid].empty()) {
+    double weight = gridContent(kNUEGrid, pt, eta, vz);
+    if (weight != 0)
+      return 1. / weight;
+    return 1;
+  }
   int xind = fEffInt->GetXaxis()->FindBin(pt);
   int etaind = fEffInt->GetYaxis()->FindBin(eta);
   int vzind = fEffInt->GetZaxis()->FindBin(vz);
@@ -253,6 +285,7 @@ void GFWWeights::createNUA(bool IntegrateOverCentAndPt)
       fAccInt->GetZaxis()->SetRange(1, fAccInt->GetNbinsZ());
     }
     fAccInt->GetYaxis()->SetRange(1, fAccInt->GetNbinsY());
+    resetGrid(kNUAGrid);
     return;
   }
 };
@@ -294,6 +327,7 @@ void GFWWeights::createNUE(bool IntegrateOverCentrality)
     den->RebinZ(5);
     fEffInt = reinterpret_cast<TH3D*>(num->Clone("Efficiency_Integrated"));
     fEffInt->Divide(den);
+    resetGrid(kNUEGrid);
     return;
   }
 };
@@ -378,6 +412,8 @@ void GFWWeights::overwriteNUA()
   delete trash;
   fW_data->Add(reinterpret_cast<TH3D*>(fAccInt->Clone(ts.Data())));
   delete fAccInt;
+  fAccInt = nullptr;
+  resetGrid(kNUAGrid);
 }
 Long64_t GFWWeights::Merge(TCollection* collist)
 {
@@ -510,3 +546,90 @@ void GFWWeights::setTH3D(TH3D* th3d)
   delete trash;
   fW_data->Add(reinterpret_cast<TH3D*>(th3d->Clone(ts.Data())));
 }
+void GFWWeights::compileNUA()
+{
+  if (!fAccInt)
+    createNUA();
+  compileGrid(kNUAGrid, fAccInt);
+}
+void GFWWeights::compileNUE()
+{
+  if (!fEffInt)
+    createNUE();
+  compileGrid(kNUEGrid, fEffInt);
+}
+void GFWWeights::resetGrid(GridType type)
+{
+  fGrid[type].clear();
+  fGridCompiled[type] = false;
+}
+bool GFWWeights::compileGrid(GridType type, TH3D* hist)
+{
+  resetGrid(type);
+  fGridCompiled[type] = true;
+  if (!hist)
+    return false;
+  const TAxis* axes[NGridAxes] = {hist->GetXaxis(), hist->GetYaxis(), hist->GetZaxis()};
+  for (int i = 0; i < NGridAxes; i++) {
+    if (axes[i]->IsVariableBinSize()) // keep the TH3 lookup for variable bins
+      return false;
+    fGridBins[type][i] = axes[i]->GetNbins();
+    fGridMin[type][i] = axes[i]->GetXmin();
+    fGridMax[type][i] = axes[i]->GetXmax();
+  }
+  // same layout as the TH3 global bin: ix + nx * (iy + ny * iz), incl. under- and overflow bins
+  fGrid[type].resize(hist->GetNcells());
+  for (int bin = 0; bin < hist->GetNcells(); bin++)
+    fGrid[type][bin] = hist->GetBinContent(bin);
+  return true;
+}
+int GFWWeights::gridBin(GridType type, int axis, double x) const
+{
+  // same as TAxis::FindBin for fixed bins, without axis extension
+  if (x < fGridMin[type][axis])
+    return 0;
+  if (!(x < fGridMax[type][axis]))
+    return fGridBins[type][axis] + 1;
+  return 1 + static_cast<int>(fGridBins[type][axis] * (x - fGridMin[type][axis]) / (fGridMax[type][axis] - fGridMin[type][axis]));
+}
+double GFWWeights::gridContent(GridType type, double x, double y, double z) const
+{
+  const int nx = fGridBins[type][0] + 2;
+  const int ny = fGridBins[type][1] + 2;
+  return fGrid[type][gridBin(type, 0, x) + nx * (gridBin(type, 1, y) + ny * gridBin(type, 2, z))];
+}
+double GFWWeights::gridInterpolate(GridType type, double x, double y, double z) const
+{
+  const double pos[NGridAxes] = {x, y, z};
+  int lowBin[NGridAxes];
+  int highBin[NGridAxes];
+  double frac[NGridAxes];
+  for (int i = 0; i < NGridAxes; i++) {
+    const int nBins = fGridBins[type][i];
+    // position in units of bins, relative to the centre of the first bin; constant beyond the outer bin centres
+    double u = (pos[i] - fGridMin[type][i]) / (fGridMax[type][i] - fGridMin[type][i]) * nBins - 0.5;
+    if (!(u > 0)) {
+      lowBin[i] = 0;
+      frac[i] = 0;
+    } else if (u >= nBins - 1) {
+      lowBin[i] = nBins - 1;
+      frac[i] = 0;
+    } else {
+      lowBin[i] = static_cast<int>(u);
+      frac[i] = u - lowBin[i];
+    }
+    highBin[i] = std::min(lowBin[i] + 1, nBins - 1) + 1;
+    lowBin[i] += 1;
+  }
+  const int nx = fGridBins[type][0] + 2;
+  const int ny = fGridBins[type][1] + 2;
+  const std::vector<double>& grid = fGrid[type];
+  auto content = [&](int ix, int iy, int iz) { return grid[ix + nx * (iy + ny * iz)]; };
+  double c00 = content(lowBin[0], lowBin[1], lowBin[2]) * (1 - frac[0]) + content(highBin[0], lowBin[1], lowBin[2]) * frac[0];
+  double c10 = content(lowBin[0], highBin[1], lowBin[2]) * (1 - frac[0]) + content(highBin[0], highBin[1], lowBin[2]) * frac[0];
+  double c01 = content(lowBin[0], lowBin[1], highBin[2]) * (1 - frac[0]) + content(highBin[0], lowBin[1], highBin[2]) * frac[0];
+  double c11 = content(lowBin[0], highBin[1], highBin[2]) * (1 - frac[0]) + content(highBin[0], highBin[1], highBin[2]) * frac[0];
+  double c0 = c00 * (1 - frac[1]) + c10 * frac[1];
+  double c1 = c01 * (1 - frac[1]) + c11 * frac[1];
+  return c0 * (1 - frac[2]) + c1 * frac[2];
+}
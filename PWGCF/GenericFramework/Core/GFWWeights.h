@@ -26,6 +26,9 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <span>
+#include <vector>
+
 class GFWWeights : public TNamed
 {
  public:
@@ -60,6 +63,13 @@ class GFWWeights : public TNamed
   TH1D* getEfficiency(double etamin, double etamax, double vzmin, double vzmax);
   void mergeWeights(GFWWeights* other);
   void setTH3D(TH3D* th3d);
+  // Batch version of getNUA for the tracks of one event, the vz bin is found once
+  void getNUA(std::span<const float> phi, std::span<const float> eta, double vz, std::span<double> weights);
+  // Compile the integrated NUA/NUE into flat grids. Done on first use, or explicitly after loading new weights
+  void compileNUA();
+  void compileNUE();
+  // Trilinear interpolation of the NUA between bin centres instead of taking the bin content
+  void setInterpolateNUA(bool newval) { fInterpolateNUA = newval; }
 
  private:
   bool fDataFilled;
@@ -73,6 +83,24 @@ class GFWWeights : public TNamed
   int fNbinsPt;    //! do not store
   double* fbinsPt; //! do not store
   void addArray(TObjArray* targ, TObjArray* sour);
+
+  // Integrated NUA and NUE compiled into flat arrays incl. under- and overflow bins,
+  // so that a lookup is an arithmetic bin index instead of three TAxis::FindBin and a GetBinContent
+  enum GridType { kNUAGrid = 0,
+                  kNUEGrid,
+                  kNGrids };
+  static constexpr int NGridAxes = 3;
+  std::vector<double> fGrid[kNGrids];           //! do not store
+  bool fGridCompiled[kNGrids] = {false, false}; //! do not store
+  int fGridBins[kNGrids][NGridAxes];            //! do not store
+  double fGridMin[kNGrids][NGridAxes];          //! do not store
+  double fGridMax[kNGrids][NGridAxes];          //! do not store
+  bool fInterpolateNUA = false;                 //! do not store
+  bool compileGrid(GridType type, TH3D* hist);
+  void resetGrid(GridType type);
+  int gridBin(GridType type, int axis, double x) const;
+  double gridContent(GridType type, double x, double y, double z) const;
+  double gridInterpolate(GridType type, double x, double y, double z) const;
   const char* getBinName(double /*ptv*/, double /*v0mv*/, const char* pf = "")
   {
     int ptind = 0;  // GetPtBin(ptv);
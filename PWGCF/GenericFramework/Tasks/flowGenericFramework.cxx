@@ -275,6 +275,30 @@ struct FlowGenericFramework {
     bool correctionsLoaded = false;
   } cfg;
 
+  // NUA weights of a track: ref from the reference acceptance (index 0), poi from the acceptance of its species (pidIndex + 1, only with cfgUsePID)
+  struct NUAWeights {
+    double ref = 1.;
+    double poi = 1.;
+  };
+
+  // Data track that passed the selection, with its position in the event's track loop
+  struct SelectedTrack {
+    int64_t row;
+    int pidIndex;
+    float phi;
+    float eta;
+    NUAWeights wacc;
+  };
+
+  // Selected tracks of the current event, and buffers for the batch GFWWeights::getNUA
+  struct EventNUA {
+    std::vector<SelectedTrack> selected;
+    std::vector<std::size_t> requesting;
+    std::vector<float> phi;
+    std::vector<float> eta;
+    std::vector<double> weights;
+  } eventNUA;
+
   // Define output
   OutputObj<FlowContainer> fFC{FlowContainer("FlowContainer")};
   OutputObj<FlowPtContainer> fFCpt{FlowPtContainer("FlowPtContainer")};
@@ -1042,6 +1066,11 @@ struct FlowGenericFramework {
       } else {
         cfg.mAcceptance.push_back(ccdb->getForTimeStamp<GFWWeights>(cfgAcceptance.value + runstr, timestamp));
       }
+      // compile the NUA grids once per run instead of on the first track
+      for (const auto& acceptance : cfg.mAcceptance) {
+        if (acceptance)
+          acceptance->compileNUA();
+      }
     }
     // Run-by-run efficiencies are not supported at the moment
     if (cfg.correctionsLoaded)
@@ -1072,6 +1101,12 @@ struct FlowGenericFramework {
     cfg.correctionsLoaded = true;
   }
 
+  template <typename TTrack>
+  static constexpr bool isDataTrack()
+  {
+    return !framework::has_type_v<aod::mctracklabel::McParticleId, typename TTrack::all_columns> && !framework::has_type_v<aod::mcparticle::McCollisionId, typename TTrack::all_columns>;
+  }
+
   template <typename TTrack>
   double getAcceptance(TTrack track, const double& vtxz, int index)
   { // 0 ref, 1 ch, 2 pi, 3 ka, 4 pr
@@ -1081,6 +1116,50 @@ struct FlowGenericFramework {
     return wacc;
   }
 
+  template <typename TTrack>
+  NUAWeights getNUAWeights(TTrack track, const double& vtxz, int pidIndex)
+  {
+    NUAWeights wacc;
+    wacc.ref = getAcceptance(track, vtxz, 0);
+    if (cfgUsePID)
+      wacc.poi = getAcceptance(track, vtxz, pidIndex + 1);
+    return wacc;
+  }
+
+  // NUA weights of the selected tracks of the event with the batch GFWWeights::getNUA, the vz bin is found once per
+  // acceptance object. Each acceptance object is only evaluated for the tracks that use it: all of them for the
+  // reference, the tracks of the species for the POIs
+  void fillEventNUA(const double& vtxz)
+  {
+    if (cfg.mAcceptance.empty() || eventNUA.selected.empty())
+      return;
+    const std::size_t nAcceptances = cfgUsePID ? cfg.mAcceptance.size() : 1;
+    for (std::size_t index = 0; index < nAcceptances; ++index) {
+      eventNUA.requesting.clear();
+      eventNUA.phi.clear();
+      eventNUA.eta.clear();
+      for (std::size_t i = 0; i < eventNUA.selected.size(); ++i) {
+        const auto& selected = eventNUA.selected[i];
+        if (index > 0 && static_cast<std::size_t>(selected.pidIndex) + 1 != index)
+          continue;
+        eventNUA.requesting.push_back(i);
+        eventNUA.phi.push_back(selected.phi);
+        eventNUA.eta.push_back(selected.eta);
+      }
+      if (eventNUA.requesting.empty())
+        continue;
+      eventNUA.weights.resize(eventNUA.requesting.size());
+      cfg.mAcceptance[index]->getNUA(eventNUA.phi, eventNUA.eta, vtxz, eventNUA.weights);
+      for (std::size_t i = 0; i < eventNUA.requesting.size(); ++i) {
+        auto& wacc = eventNUA.selected[eventNUA.requesting[i]].wacc;
+        if (index == 0)
+          wacc.ref = eventNUA.weights[i];
+        else
+          wacc.poi = eventNUA.weights[i];
+      }
+    }
+  }
+
   template <typename TTrack>
   double getEfficiency(TTrack track, const float& centrality, int pidIndex = 0)
   { //-1 ref, 0 ch, 1 pi, 2 ka, 3 pr, 4 k0, 5 lambda
@@ -1758,8 +1837,32 @@ struct FlowGenericFramework {
       for (const auto& h : vec)
         h->Reset("ICESM");
     }
-    for (const auto& track : tracks) {
-      processTrack(track, vtxz, field, run, densitycorrections, centrality, acceptedTracks);
+    if constexpr (dt != Gen && isDataTrack<typename TTracks::iterator>()) {
+      // Select the tracks first, so that the NUA weights of the selected tracks are looked up in one batch
+      eventNUA.selected.clear();
+      int64_t row = 0;
+      for (const auto& track : tracks) {
+        int pidIndex = 0;
+        if (selectTrack(track, vtxz, field, centrality, acceptedTracks, pidIndex))
+          eventNUA.selected.push_back({row, pidIndex, track.phi(), track.eta(), NUAWeights{}});
+        ++row;
+      }
+      // fillWeights does not use the NUA weights, the QA after the selection does
+      if (!cfgFill.cfgFillWeights || cfgFill.cfgFillQA)
+        fillEventNUA(vtxz);
+      row = 0;
+      auto selected = eventNUA.selected.cbegin();
+      for (const auto& track : tracks) {
+        if (selected != eventNUA.selected.cend() && selected->row == row) {
+          fillSelectedTrack(track, vtxz, run, densitycorrections, centrality, selected->pidIndex, selected->wacc);
+          ++selected;
+        }
+        ++row;
+      }
+    } else {
+      for (const auto& track : tracks) {
+        processTrack(track, vtxz, field, run, densitycorrections, centrality, acceptedTracks);
+      }
     }
     if (dt != Gen && cfgFill.cfgFillQA) {
       registryQA.fill(HIST("trackQA/after/Nch_corrected"), acceptedTracks.total);
@@ -1847,11 +1950,11 @@ struct FlowGenericFramework {
       if (cfgFill.cfgFillWeights) {
         fillWeights(mcParticle, vtxz, 0, run);
       } else {
-        fillPtSums<Reco>(track, centrality, vtxz);
-        fillGFW<Reco>(mcParticle, centrality, vtxz, pidIndex, densitycorrections);
+        fillPtSums<Reco>(track, centrality, getAcceptance(track, vtxz, 0));
+        fillGFW<Reco>(mcParticle, centrality, getNUAWeights(mcParticle, vtxz, pidIndex), pidIndex, densitycorrections);
       }
       if (cfgFill.cfgFillQA) {
-        fillTrackQA<Reco, After>(track, vtxz);
+        fillTrackQA<Reco, After>(track, vtxz, getAcceptance(track, vtxz, 0));
         if (cfgFill.cfgFillRunByRunQA) {
           th1sList[run][Phi]->Fill(track.phi());
           th1sList[run][Eta]->Fill(track.eta());
@@ -1880,45 +1983,56 @@ struct FlowGenericFramework {
       }
       fillNptHistosForEta(track.eta(), track.pt(), pidIndex, 1.0, 1.0);
 
-      fillPtSums<Gen>(track, centrality, vtxz);
-      fillGFW<Gen>(track, centrality, vtxz, pidIndex, densitycorrections);
+      fillPtSums<Gen>(track, centrality, 1.);
+      fillGFW<Gen>(track, centrality, NUAWeights{}, pidIndex, densitycorrections);
       if (cfgFill.cfgFillQA)
         fillTrackQA<Gen, After>(track, vtxz);
 
-    } else {
-      if (cfgFill.cfgFillQA)
-        fillTrackQA<Reco, Before>(track, vtxz);
-      // Select tracks with nominal cuts always
-      if (!nchSelected(track))
-        return;
-      double weffCh = getEfficiency(track, centrality, 0);
-      if (track.eta() > cfgKinematics.cfgEtaNch->first && track.eta() < cfgKinematics.cfgEtaNch->second) {
-        if (weffCh > 0)
-          acceptedTracks.total += (cfgUseNchCorrection) ? weffCh : 1.0;
-        ++acceptedTracks.totaluncorr;
-      }
-      if (!trackSelected(track, field))
-        return;
-      // int pidIndex = 0;
-      // if (cfgUsePID) Need PID for v02
-      int pidIndex = getNsigmaPID(track);
+    }
+  }
 
-      double weff = getEfficiency(track, centrality, pidIndex);
-      double nptWeightCh = (weffCh > 0) ? ((cfgUseNchCorrection) ? weffCh : 1.0) : -1.0;
-      double nptWeightPid = (weff > 0) ? ((cfgUseNchCorrection) ? weff : 1.0) : -1.0;
-      fillNptHistosForEta(track.eta(), track.pt(), pidIndex, nptWeightCh, nptWeightPid);
-      if (cfgFill.cfgFillWeights) {
-        fillWeights(track, vtxz, pidIndex, run);
-      } else {
-        fillPtSums<Reco>(track, centrality, vtxz);
-        fillGFW<Reco>(track, centrality, vtxz, pidIndex, densitycorrections);
-      }
-      if (cfgFill.cfgFillQA) {
-        fillTrackQA<Reco, After>(track, vtxz);
-        if (cfgFill.cfgFillRunByRunQA) {
-          th1sList[run][Phi]->Fill(track.phi());
-          th1sList[run][Eta]->Fill(track.eta());
-        }
+  // Data tracks are processed in two passes, see processCollision: the selection, then the filling with the NUA weights of the selected tracks
+  template <typename TTrack>
+  inline bool selectTrack(TTrack const& track, const float& vtxz, const int field, const float& centrality, AcceptedTracks& acceptedTracks, int& pidIndex)
+  {
+    if (cfgFill.cfgFillQA)
+      fillTrackQA<Reco, Before>(track, vtxz);
+    // Select tracks with nominal cuts always
+    if (!nchSelected(track))
+      return false;
+    double weffCh = getEfficiency(track, centrality, 0);
+    if (track.eta() > cfgKinematics.cfgEtaNch->first && track.eta() < cfgKinematics.cfgEtaNch->second) {
+      if (weffCh > 0)
+        acceptedTracks.total += (cfgUseNchCorrection) ? weffCh : 1.0;
+      ++acceptedTracks.totaluncorr;
+    }
+    if (!trackSelected(track, field))
+      return false;
+    // int pidIndex = 0;
+    // if (cfgUsePID) Need PID for v02
+    pidIndex = getNsigmaPID(track);
+
+    double weff = getEfficiency(track, centrality, pidIndex);
+    double nptWeightCh = (weffCh > 0) ? ((cfgUseNchCorrection) ? weffCh : 1.0) : -1.0;
+    double nptWeightPid = (weff > 0) ? ((cfgUseNchCorrection) ? weff : 1.0) : -1.0;
+    fillNptHistosForEta(track.eta(), track.pt(), pidIndex, nptWeightCh, nptWeightPid);
+    return true;
+  }
+
+  template <typename TTrack>
+  inline void fillSelectedTrack(TTrack const& track, const float& vtxz, const int run, DensityCorr densitycorrections, const float& centrality, int pidIndex, const NUAWeights& wacc)
+  {
+    if (cfgFill.cfgFillWeights) {
+      fillWeights(track, vtxz, pidIndex, run);
+    } else {
+      fillPtSums<Reco>(track, centrality, wacc.ref);
+      fillGFW<Reco>(track, centrality, wacc, pidIndex, densitycorrections);
+    }
+    if (cfgFill.cfgFillQA) {
+      fillTrackQA<Reco, After>(track, vtxz, wacc.ref);
+      if (cfgFill.cfgFillRunByRunQA) {
+        th1sList[run][Phi]->Fill(track.phi());
+        th1sList[run][Eta]->Fill(track.eta());
       }
     }
   }
@@ -2242,9 +2356,8 @@ struct FlowGenericFramework {
   }
 
   template <DataType dt, typename TTrack>
-  inline void fillPtSums(TTrack track, const float& centrality, const double& vtxz)
+  inline void fillPtSums(TTrack track, const float& centrality, const double wacc)
   {
-    double wacc = (dt == Gen) ? 1. : getAcceptance(track, vtxz, 0);
     double weff = (dt == Gen) ? 1. : getEfficiency(track, centrality);
     if (weff < 0)
       return;
@@ -2270,7 +2383,7 @@ struct FlowGenericFramework {
   }
 
   template <DataType dt, typename TTrack>
-  inline void fillGFW(TTrack track, const float& centrality, const double& vtxz, int pid_index, DensityCorr densitycorrections)
+  inline void fillGFW(TTrack track, const float& centrality, const NUAWeights& nua, int pid_index, DensityCorr densitycorrections)
   {
     if (cfgUsePID) { // Analysing POI flow with id'ed particles
       double ptmins[] = {o2::analysis::gfw::ptpoilow, o2::analysis::gfw::ptpoilow, 0.3, 0.5};
@@ -2281,9 +2394,8 @@ struct FlowGenericFramework {
       if (!withinPtPOI && !withinPtRef)
         return;
 
-      double waccRef = (dt == Gen) ? 1. : getAcceptance(track, vtxz, 0);
-      double waccPOI = (dt == Gen) ? 1. : withinPtPOI ? getAcceptance(track, vtxz, pid_index + 1)
-                                                      : getAcceptance(track, vtxz, 0); //
+      double waccRef = nua.ref;
+      double waccPOI = withinPtPOI ? nua.poi : nua.ref;
       if (withinPtRef && withinPtPOI && pid_index)
         waccRef = waccPOI; // if particle is both (then it's overlap), override ref with POI
       if (withinPtRef)
@@ -2316,7 +2428,7 @@ struct FlowGenericFramework {
           }
         }
       }
-      double wacc = (dt == Gen) ? 1. : getAcceptance(track, vtxz, 0);
+      double wacc = nua.ref;
       if (withinPtRef)
         fGFW->Fill(track.eta(), fPtAxis->FindBin(track.pt()) - 1, track.phi(), weff * wacc, 1);
       if (withinPtPOI)
@@ -2328,13 +2440,12 @@ struct FlowGenericFramework {
   }
 
   template <DataType dt, QAFillTime ft, typename TTrack>
-  inline void fillTrackQA(TTrack track, const float vtxz)
+  inline void fillTrackQA(TTrack track, const float vtxz, const double wacc = 1.)
   {
     if constexpr (dt == Gen) {
       registryQA.fill(HIST("MCGen/") + HIST(FillTimeName[ft]) + HIST("phi_eta_vtxZ_gen"), track.phi(), track.eta(), vtxz);
       registryQA.fill(HIST("MCGen/") + HIST(FillTimeName[ft]) + HIST("pt_gen"), track.pt());
     } else {
-      double wacc = getAcceptance(track, vtxz, 0);
       registryQA.fill(HIST("trackQA/") + HIST(FillTimeName[ft]) + HIST("phi_eta_vtxZ"), track.phi(), track.eta(), vtxz, (ft == After) ? wacc : 1.0);
       registryQA.fill(HIST("trackQA/") + HIST(FillTimeName[ft]) + HIST("pt_dcaXY_dcaZ"), track.pt(), track.dcaXY(), track.dcaZ());
 
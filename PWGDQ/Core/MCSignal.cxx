@@ -33,7 +33,10 @@ MCSignal::MCSignal() : TNamed("", ""),
                        fDecayChannelIsExclusive(false),
                        fDecayChannelIsNotExclusive(false),
                        fNAncestorDirectProngs(0),
-                       fTempAncestorLabel(-1)
+                       fTempAncestorLabel(-1),
+                       fUseParticleCache(false),
+                       fParticleCache({}),
+                       fParticleCacheAncestors({})
 {
 }
 
@@ -46,7 +49,10 @@ MCSignal::MCSignal(int nProngs, const char* name /*= ""*/, const char* title /*=
                                                                                          fDecayChannelIsExclusive(false),
                                                                                          fDecayChannelIsNotExclusive(false),
                                                                                          fNAncestorDirectProngs(0),
-                                                                                         fTempAncestorLabel(-1)
+                                                                                         fTempAncestorLabel(-1),
+                                                                                         fUseParticleCache(false),
+                                                                                         fParticleCache({}),
+                                                                                         fParticleCacheAncestors({})
 {
   fProngs.reserve(nProngs);
 }
@@ -60,7 +66,10 @@ MCSignal::MCSignal(const char* name, const char* title, std::vector<MCProng> pro
                                                                                                                                                         fDecayChannelIsExclusive(false),
                                                                                                                                                         fDecayChannelIsNotExclusive(false),
                                                                                                                                                         fNAncestorDirectProngs(0),
-                                                                                                                                                        fTempAncestorLabel(-1)
+                                                                                                                                                        fTempAncestorLabel(-1),
+                                                                                                                                                        fUseParticleCache(false),
+                                                                                                                                                        fParticleCache({}),
+                                                                                                                                                        fParticleCacheAncestors({})
 {
 }
 
@@ -70,6 +79,7 @@ void MCSignal::SetProngs(std::vector<MCProng> prongs, std::vector<int8_t> common
   fProngs = prongs;
   fNProngs = fProngs.size();
   fCommonAncestorIdxs = commonAncestors;
+  ResetParticleCache();
 }
 
 //________________________________________________________________________________________________
@@ -78,11 +88,31 @@ void MCSignal::AddProng(MCProng prong, int8_t commonAncestor)
   if (fProngs.size() < fNProngs) {
     fProngs.push_back(prong);
     fCommonAncestorIdxs.push_back(commonAncestor);
+    ResetParticleCache();
   } else { // TODO: there should be an error message here
     return;
   }
 }
 
+//________________________________________________________________________________________________
+bool MCSignal::CheckCommonAncestor(int i, int ancestorLabel)
+{
+  // the label of prong 0 at its common ancestor generation is kept and compared to the ones of the following prongs
+  if (fNProngs < 2 || fCommonAncestorIdxs[i] < 0 || fCommonAncestorIdxs[i] >= fProngs[i].fNGenerations) {
+    return true;
+  }
+  if (i == 0) {
+    fTempAncestorLabel = ancestorLabel;
+  } else {
+    if (ancestorLabel != fTempAncestorLabel && !fExcludeCommonAncestor) {
+      return false;
+    } else if (ancestorLabel == fTempAncestorLabel && fExcludeCommonAncestor) {
+      return false;
+    }
+  }
+  return true;
+}
+
 //________________________________________________________________________________________________
 void MCSignal::PrintConfig()
 {
@@ -117,6 +117,20 @@ class MCSignal : public TNamed
     return CheckMC(0, checkSources, args...);
   };
 
+  // The prong decisions can be cached per MC particle (indexed by globalIndex), so that a particle entering many
+  //   pairs or triplets has its history walked only once per prong. The cache has to be reset whenever the MC particle
+  //   table changes (e.g. at the beginning of every data frame)
+  void SetUseParticleCache(bool option = true)
+  {
+    fUseParticleCache = option;
+    ResetParticleCache();
+  }
+  void ResetParticleCache()
+  {
+    fParticleCache.clear();
+    fParticleCacheAncestors.clear();
+  }
+
   void PrintConfig();
 
  private:
@@ -128,9 +142,19 @@ class MCSignal : public TNamed
   bool fDecayChannelIsNotExclusive;        // if true, then the indicated mother particle has a number of daughters which is larger than the number of direct prongs defined in this MC signal
   int fNAncestorDirectProngs;              // number of direct prongs belonging to the common ancestor specified by this signal
   int fTempAncestorLabel;
+  bool fUseParticleCache;                   // use the prong decisions cached per MC particle
+  std::vector<uint16_t> fParticleCache;     // per MC particle: bit 2*i (2*i+1) if prong i was evaluated (matched), upper 8 bits the same when checking the sources
+  std::vector<int> fParticleCacheAncestors; // per MC particle and prong: label of the particle at the common ancestor generation (only for multi-prong signals)
+
+  static constexpr unsigned int NMaxCachedProngs = 4;
 
   template <typename T>
   bool CheckProng(int i, bool checkSources, const T& track);
+  template <typename T>
+  bool CheckProngCached(int i, bool checkSources, const T& track, int& ancestorLabel);
+  template <typename T>
+  bool EvaluateProng(int i, bool checkSources, const T& track, int& ancestorLabel);
+  bool CheckCommonAncestor(int i, int ancestorLabel);
 
   bool CheckMC(int, bool)
   {
@@ -152,19 +176,63 @@ class MCSignal : public TNamed
 template <typename T>
 bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
 {
+  int ancestorLabel = -1;
+  if (fUseParticleCache && fNProngs <= NMaxCachedProngs) {
+    if (!CheckProngCached(i, checkSources, track, ancestorLabel)) {
+      return false;
+    }
+  } else if (!EvaluateProng(i, checkSources, track, ancestorLabel)) {
+    return false;
+  }
+  return CheckCommonAncestor(i, ancestorLabel);
+}
+
+template <typename T>
+bool MCSignal::CheckProngCached(int i, bool checkSources, const T& track, int& ancestorLabel)
+{
+  const auto index = static_cast<size_t>(track.globalIndex());
+  if (index >= fParticleCache.size()) {
+    fParticleCache.resize(index + 1, 0);
+    if (fNProngs > 1) {
+      fParticleCacheAncestors.resize((index + 1) * fNProngs, -1);
+    }
+  }
+
+  const uint16_t evaluatedBit = static_cast<uint16_t>(1) << (2 * i + (checkSources ? 8 : 0));
+  const uint16_t matchedBit = evaluatedBit << 1;
+  if (fParticleCache[index] & evaluatedBit) {
+    if (fNProngs > 1) {
+      ancestorLabel = fParticleCacheAncestors[index * fNProngs + i];
+    }
+    return fParticleCache[index] & matchedBit;
+  }
+
+  bool matched = EvaluateProng(i, checkSources, track, ancestorLabel);
+  fParticleCache[index] |= evaluatedBit | (matched ? matchedBit : 0);
+  if (fNProngs > 1) {
+    fParticleCacheAncestors[index * fNProngs + i] = ancestorLabel;
+  }
+  return matched;
+}
+
+template <typename T>
+bool MCSignal::EvaluateProng(int i, bool checkSources, const T& track, int& ancestorLabel)
+{
+  // Checks the prong i independently of the other prongs. The label of the particle at the common ancestor generation
+  //   (if specified) is returned in ancestorLabel and compared between prongs in CheckCommonAncestor()
   using P = typename T::parent_t;
   auto currentMCParticle = track;
 
-  // loop over the generations specified for this prong
+  // loop over the generations specified for this prong, checking the PDG codes and the various specified sources
   for (int j = 0; j < fProngs[i].fNGenerations; j++) {
     // check the PDG code
     if (!fProngs[i].TestPDG(j, currentMCParticle.pdgCode())) {
       return false;
     }
-    // check the common ancestor (if specified)
+    // keep the common ancestor (if specified)
     if (fNProngs > 1 && fCommonAncestorIdxs[i] == j) {
+      ancestorLabel = currentMCParticle.globalIndex();
       if (i == 0) {
-        fTempAncestorLabel = currentMCParticle.globalIndex();
         // In the case of decay channels marked as being "exclusive", check how many decay daughters this mother has registered
         //   in the stack and compare to the number of prongs defined for this MCSignal.
         //  If these numbers are equal, it means this decay MCSignal match is exclusive (there are no additional prongs for this mother besides the
@@ -177,14 +245,59 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
             return false;
           }
         }
-      } else {
-        if (currentMCParticle.globalIndex() != fTempAncestorLabel && !fExcludeCommonAncestor)
-          return false;
-        else if (currentMCParticle.globalIndex() == fTempAncestorLabel && fExcludeCommonAncestor)
-          return false;
       }
     }
 
+    // check whether sources are required for this generation
+    if (checkSources && fProngs[i].fSourceBits[j]) {
+      // check each source
+      uint64_t sourcesDecision = 0;
+      // Check kPhysicalPrimary
+      if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kPhysicalPrimary)) {
+        if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kPhysicalPrimary)) != currentMCParticle.isPhysicalPrimary()) {
+          sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kPhysicalPrimary);
+        }
+      }
+      // Check kProducedInTransport
+      if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kProducedInTransport)) {
+        if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kProducedInTransport)) != (!currentMCParticle.producedByGenerator())) {
+          sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kProducedInTransport);
+        }
+      }
+      // Check kProducedByGenerator
+      if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kProducedByGenerator)) {
+        if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kProducedByGenerator)) != currentMCParticle.producedByGenerator()) {
+          sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kProducedByGenerator);
+        }
+      }
+      // Check kFromBackgroundEvent
+      if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kFromBackgroundEvent)) {
+        if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kFromBackgroundEvent)) != currentMCParticle.fromBackgroundEvent()) {
+          sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kFromBackgroundEvent);
+        }
+      }
+      // Check HEPMC code 11 (final state)
+      if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kHEPMCFinalState)) {
+        if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kHEPMCFinalState)) != (currentMCParticle.getHepMCStatusCode() == 11)) {
+          sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kHEPMCFinalState);
+        }
+      }
+      // Check kIsPowhegDYMuon
+      if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kIsPowhegDYMuon)) {
+        if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kIsPowhegDYMuon)) != (currentMCParticle.getGenStatusCode() == 23)) {
+          sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kIsPowhegDYMuon);
+        }
+      }
+      // no source bit is fulfilled
+      if (!sourcesDecision) {
+        return false;
+      }
+      // if fUseANDonSourceBitMap is on, request all bits
+      if (fProngs[i].fUseANDonSourceBitMap[j] && (sourcesDecision != fProngs[i].fSourceBits[j])) {
+        return false;
+      }
+    } // end if(hasSources)
+
     // Update the currentMCParticle by moving either back in time (towards mothers, grandmothers, etc)
     // or in time (towards daughters) depending on how this was configured in the MC Signal
     if (!fProngs[i].fCheckGenerationsInTime) {
@@ -196,6 +309,7 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
         currentMCParticle = currentMCParticle.template mothers_first_as<P>();
       }
     } else {
+      // prong history will be moved to the branch of the first daughter that matches the PDG requirement
       // make sure that a daughter exists in the stack before moving one generation younger
       if (!currentMCParticle.has_daughters() && j < fProngs[i].fNGenerations - 1) {
         return false;
@@ -210,99 +324,13 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
         }
       }
     }
-  }
-
-  // check the various specified sources
-  if (checkSources) {
-    currentMCParticle = track;
-    for (int j = 0; j < fProngs[i].fNGenerations; j++) {
-      // check whether sources are required for this generation
-      bool hasSources = false;
-      if (fProngs[i].fSourceBits[j]) {
-        hasSources = true;
-      }
-      // check each source
-      uint64_t sourcesDecision = 0;
-      if (hasSources) {
-        // Check kPhysicalPrimary
-        if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kPhysicalPrimary)) {
-          if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kPhysicalPrimary)) != currentMCParticle.isPhysicalPrimary()) {
-            sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kPhysicalPrimary);
-          }
-        }
-        // Check kProducedInTransport
-        if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kProducedInTransport)) {
-          if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kProducedInTransport)) != (!currentMCParticle.producedByGenerator())) {
-            sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kProducedInTransport);
-          }
-        }
-        // Check kProducedByGenerator
-        if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kProducedByGenerator)) {
-          if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kProducedByGenerator)) != currentMCParticle.producedByGenerator()) {
-            sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kProducedByGenerator);
-          }
-        }
-        // Check kFromBackgroundEvent
-        if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kFromBackgroundEvent)) {
-          if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kFromBackgroundEvent)) != currentMCParticle.fromBackgroundEvent()) {
-            sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kFromBackgroundEvent);
-          }
-        }
-        // Check HEPMC code 11 (final state)
-        if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kHEPMCFinalState)) {
-          if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kHEPMCFinalState)) != (currentMCParticle.getHepMCStatusCode() == 11)) {
-            sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kHEPMCFinalState);
-          }
-        }
-        // Check kIsPowhegDYMuon
-        if (fProngs[i].fSourceBits[j] & (static_cast<uint64_t>(1) << MCProng::kIsPowhegDYMuon)) {
-          if ((fProngs[i].fExcludeSource[j] & (static_cast<uint64_t>(1) << MCProng::kIsPowhegDYMuon)) != (currentMCParticle.getGenStatusCode() == 23)) {
-            sourcesDecision |= (static_cast<uint64_t>(1) << MCProng::kIsPowhegDYMuon);
-          }
-        }
-      } // end if(hasSources)
-      // no source bit is fulfilled
-      if (hasSources && !sourcesDecision) {
-        return false;
-      }
-      // if fUseANDonSourceBitMap is on, request all bits
-      if (hasSources && (fProngs[i].fUseANDonSourceBitMap[j] && (sourcesDecision != fProngs[i].fSourceBits[j]))) {
-        return false;
-      }
-
-      // Update the currentMCParticle by moving either back in time (towards mothers, grandmothers, etc)
-      //    or in time (towards daughters) depending on how this was configured in the MSignal
-      if (!fProngs[i].fCheckGenerationsInTime) {
-        // make sure that a mother exists in the stack before moving one generation further in history
-        if (!currentMCParticle.has_mothers() && j < fProngs[i].fNGenerations - 1) {
-          return false;
-        }
-        if (currentMCParticle.has_mothers() && j < fProngs[i].fNGenerations - 1) {
-          currentMCParticle = currentMCParticle.template mothers_first_as<P>();
-        }
-      } else {
-        // prong history will be moved to the branch of the first daughter that matches the PDG requirement
-        // make sure that a daughter exists in the stack before moving one generation younger
-        if (!currentMCParticle.has_daughters() && j < fProngs[i].fNGenerations - 1) {
-          return false;
-        }
-        if (currentMCParticle.has_daughters() && j < fProngs[i].fNGenerations - 1) {
-          const auto& daughtersSlice = currentMCParticle.template daughters_as<P>();
-          for (auto& d : daughtersSlice) {
-            if (fProngs[i].TestPDG(j + 1, d.pdgCode())) {
-              currentMCParticle = d;
-              break;
-            }
-          }
-        }
-      }
-    } // end loop over generations
-  } // end if(checkSources)
+  } // end loop over generations
 
   if (fProngs[i].fPDGInHistory.size() == 0) {
     return true;
   } else { // check if mother pdg is in history
-    std::vector<int> pdgInHistory;
+    // number of included PDG codes found in the history
+    unsigned int nFoundPDG = 0;
 
     // while find mothers, check if the provided PDG codes are included or excluded in the particle decay history
     unsigned int nIncludedPDG = 0;
@@ -319,7 +347,7 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
         while (currentMCParticle.has_mothers()) {
           auto mother = currentMCParticle.template mothers_first_as<P>();
           if (!fProngs[i].fExcludePDGInHistory[k] && fProngs[i].ComparePDG(mother.pdgCode(), fProngs[i].fPDGInHistory[k], true, fProngs[i].fExcludePDGInHistory[k])) {
-            pdgInHistory.emplace_back(mother.pdgCode());
+            nFoundPDG++;
             break;
           }
           if (fProngs[i].fExcludePDGInHistory[k] && !fProngs[i].ComparePDG(mother.pdgCode(), fProngs[i].fPDGInHistory[k], true, fProngs[i].fExcludePDGInHistory[k])) {
@@ -351,7 +379,7 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
         }
       }*/
     }
-    if (pdgInHistory.size() != nIncludedPDG) { // vector has as many entries as mothers (daughters) defined for prong
+    if (nFoundPDG != nIncludedPDG) { // as many found as mothers (daughters) defined for prong
       return false;
     }
   }
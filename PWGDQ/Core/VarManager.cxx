@@ -33,6 +33,7 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -62,6 +63,9 @@ uint64_t VarManager::fgSOR = 0;
 uint64_t VarManager::fgEOR = 0;
 ROOT::Math::PxPyPzEVector VarManager::fgBeamA(0, 0, 6799.99, 6800);  // GeV, beam from A-side 4-momentum vector
 ROOT::Math::PxPyPzEVector VarManager::fgBeamC(0, 0, -6799.99, 6800); // GeV, beam from C-side 4-momentum vector
+std::vector<float> VarManager::fgDCAzValues;
+std::vector<int> VarManager::fgDCAzCounts;
+std::vector<int> VarManager::fgDCAzTrimmedCounts;
 o2::vertexing::DCAFitterN<2> VarManager::fgFitterTwoProngBarrel;
 o2::vertexing::DCAFitterN<3> VarManager::fgFitterThreeProngBarrel;
 o2::vertexing::DCAFitterN<4> VarManager::fgFitterFourProngBarrel;
@@ -488,6 +492,7 @@ std::tuple<float, float, float, float, float> VarManager::BimodalityCoefficientU
   return std::make_tuple((skewness * skewness + 1.0) / kurtosis, mean, stddev, skewness, kurtosis);
 }
 
+//__________________________________________________________________
 std::tuple<float, float, float, float, float, int> VarManager::BimodalityCoefficientAndNPeaks(const std::vector<float>& data, float binWidth, int trim, float min, float max)
 {
   // Bimodality coefficient = (skewness^2 + 1) / kurtosis
@@ -501,8 +506,23 @@ std::tuple<float, float, float, float, float, int> VarManager::BimodalityCoeffic
   }
 
   // bin the data and put it in a vector
+  std::vector<int> counts;
+  int firstBin, lastBin;
+  FillBinCounts(data, binWidth, min, max, counts, firstBin, lastBin);
+  return BimodalityCoefficientAndNPeaksFromCounts(counts, firstBin, lastBin, data.size(), binWidth, trim, min);
+}
+
+//__________________________________________________________________
+void VarManager::FillBinCounts(const std::vector<float>& data, float binWidth, float min, float max, std::vector<int>& counts, int& firstBin, int& lastBin)
+{
+  // bin the data in [min, max); the counts are expected to be all zero on input and the vector is enlarged if needed
+  // the first and last non-empty bins are returned (firstBin > lastBin if all the values are out of range)
   int nBins = static_cast<int>((max - min) / binWidth);
-  std::vector<int> counts(nBins, 0.0);
+  if (static_cast<int>(counts.size()) < nBins) {
+    counts.resize(nBins, 0);
+  }
+  firstBin = nBins;
+  lastBin = -1;
 
   for (float x : data) {
     if (x < min || x >= max) {
@@ -511,12 +531,23 @@ std::tuple<float, float, float, float, float, int> VarManager::BimodalityCoeffic
     int bin = static_cast<int>((x - min) / binWidth);
     if (bin >= 0 && bin < nBins) {
       counts[bin]++;
+      firstBin = std::min(firstBin, bin);
+      lastBin = std::max(lastBin, bin);
     }
   }
+}
+
+//__________________________________________________________________
+std::tuple<float, float, float, float, float, int> VarManager::BimodalityCoefficientAndNPeaksFromCounts(std::vector<int>& counts, int firstBin, int lastBin, size_t nEntries, float binWidth, int trim, float min)
+{
+  // Bimodality coefficient = (skewness^2 + 1) / kurtosis, from the bin counts filled by FillBinCounts()
+  // return a tuple including the coefficient, mean, RMS, skewness, kurtosis and number of peaks
+  // The counts are trimmed in place. All the bins outside [firstBin, lastBin] are empty, so only this range is scanned.
+  int nBins = static_cast<int>(counts.size());
 
   // trim the distribution if requested, by requiring a minimum of "trim" counts in each bin
   if (trim > 0) {
-    for (int i = 0; i < nBins; ++i) {
+    for (int i = firstBin; i <= lastBin; ++i) {
       // if the count in the bin is less than the trim value, set it to zero
       if (counts[i] < trim) {
         // set the count to zero only if this is an isolated bin,
@@ -544,47 +575,29 @@ std::tuple<float, float, float, float, float, int> VarManager::BimodalityCoeffic
   }
   if (trim < 0) {
     // if trim is negative, then we remove all counts belonging to local peaks with an integrated count below 1/abs(trim)
-    for (int i = 0; i < nBins; ++i) {
+    // removing a peak does not change the other ones, so each peak is integrated once
+    for (int i = firstBin; i <= lastBin; ++i) {
       if (counts[i] == 0) {
         continue; // skip empty bins
       }
-      // check the previous bins until we find an empty bin or we reach the beginning of the histogram
-      int localPeakCount = counts[i];
-      for (int j = i - 1; j >= 0; --j) {
-        if (counts[j] == 0) {
-          break;
-        }
-        localPeakCount += counts[j];
-      }
-      // check the next bins until we find an empty bin or we reach the end of the histogram
-      for (int j = i + 1; j < nBins; ++j) {
-        if (counts[j] == 0) {
-          break;
-        }
-        localPeakCount += counts[j];
+      // integrate the peak starting at this bin, until we find an empty bin or we reach the end of the histogram
+      int peakEnd = i;
+      int localPeakCount = 0;
+      for (; peakEnd < nBins && counts[peakEnd] != 0; ++peakEnd) {
+        localPeakCount += counts[peakEnd];
       }
-      if (localPeakCount < (1.0 / std::abs(trim)) * data.size()) {
+      if (localPeakCount < (1.0 / std::abs(trim)) * nEntries) {
         // set all bins belonging to this local peak to zero
-        for (int j = i; j >= 0; --j) {
-          if (counts[j] == 0) {
-            break;
-          }
-          counts[j] = 0;
-        }
-        for (int j = i + 1; j < nBins; ++j) {
-          if (counts[j] == 0) {
-            break;
-          }
-          counts[j] = 0;
-        }
+        std::fill(counts.begin() + i, counts.begin() + peakEnd, 0);
       }
+      i = peakEnd;
     }
   }
 
   // count the number of peaks
   int nPeaks = 0;
   bool inPeak = false;
-  for (int i = 0; i < nBins; ++i) {
+  for (int i = firstBin; i <= lastBin; ++i) {
     if (counts[i] > 0) {
       if (!inPeak) {
         inPeak = true;
@@ -598,7 +611,7 @@ std::tuple<float, float, float, float, float, int> VarManager::BimodalityCoeffic
   // first compute the mean
   float mean = 0.0;
   float totalCounts = 0.0;
-  for (int i = 0; i < nBins; ++i) {
+  for (int i = firstBin; i <= lastBin; ++i) {
     float binCenter = min + (i + 0.5) * binWidth;
     mean += counts[i] * binCenter;
     totalCounts += counts[i];
@@ -612,7 +625,7 @@ std::tuple<float, float, float, float, float, int> VarManager::BimodalityCoeffic
   // then compute the second, third, and fourth central moments
   float m2 = 0.0, m3 = 0.0, m4 = 0.0;
   float diff, diff2, binCenter;
-  for (int i = 0; i < nBins; ++i) {
+  for (int i = firstBin; i <= lastBin; ++i) {
     if (counts[i] == 0) {
       continue; // skip empty bins
     }
@@ -75,9 +75,11 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <complex>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <numbers>
@@ -1367,6 +1369,8 @@ class VarManager : public TObject
 
   static std::tuple<float, float, float, float, float> BimodalityCoefficientUnbinned(const std::vector<float>& data);
   static std::tuple<float, float, float, float, float, int> BimodalityCoefficientAndNPeaks(const std::vector<float>& data, float binWidth, int trim = 0, float min = -15.0, float max = 15.0);
+  static void FillBinCounts(const std::vector<float>& data, float binWidth, float min, float max, std::vector<int>& counts, int& firstBin, int& lastBin);
+  static std::tuple<float, float, float, float, float, int> BimodalityCoefficientAndNPeaksFromCounts(std::vector<int>& counts, int firstBin, int lastBin, size_t nEntries, float binWidth, int trim = 0, float min = -15.0);
 
   template <typename T, typename C>
   static o2::track::TrackParCovFwd FwdToTrackPar(const T& track, const C& cov);
@@ -1578,6 +1582,10 @@ class VarManager : public TObject
   static ROOT::Math::PxPyPzEVector fgBeamA; // beam from A-side 4-momentum vector
   static ROOT::Math::PxPyPzEVector fgBeamC; // beam from C-side 4-momentum vector
 
+  static std::vector<float> fgDCAzValues;      // scratch for the DCAz values of the tracks of one collision, see FillEventTracks()
+  static std::vector<int> fgDCAzCounts;        // scratch for the binned DCAz distribution
+  static std::vector<int> fgDCAzTrimmedCounts; // scratch for the trimmed versions of the binned DCAz distribution
+
   // static void FillEventDerived(float* values = nullptr);
   static void FillTrackDerived(float* values = nullptr);
   template <typename T, typename U, typename V>
@@ -2628,7 +2636,17 @@ void VarManager::FillEventTracks(T const& tracks, float* values)
   }
 
   // compute event properties based on DCAz of the tracks
-  std::vector<float> dcazValues;
+  // the DCAz values and the counts of the binned distribution are kept in static scratch vectors, reused for all the collisions
+  std::vector<float>& dcazValues = fgDCAzValues;
+  dcazValues.clear();
+  // count the tracks with |DCAz| > 100um, 200um, 500um, 1mm, 2mm, 5mm, 10mm in the same loop
+  int counter100um = 0;
+  int counter200um = 0;
+  int counter500um = 0;
+  int counter1mm = 0;
+  int counter2mm = 0;
+  int counter5mm = 0;
+  int counter10mm = 0;
   for (const auto& track : tracks) {
     if (!track.hasITS()) {
       continue; // skip tracks without ITS information
@@ -2636,10 +2654,19 @@ void VarManager::FillEventTracks(T const& tracks, float* values)
     if (!track.hasTPC()) {
       continue; // skip tracks without TPC information
     }
-    if (track.dcaZ() > 998) {
+    float dcaZ = track.dcaZ();
+    if (dcaZ > 998) {
       continue; // skip tracks without valid DCAz
     }
-    dcazValues.push_back(track.dcaZ());
+    dcazValues.push_back(dcaZ);
+    double absD = std::abs(dcaZ);
+    counter100um += (absD > 0.01);
+    counter200um += (absD > 0.02);
+    counter500um += (absD > 0.05);
+    counter1mm += (absD > 0.1);
+    counter2mm += (absD > 0.2);
+    counter5mm += (absD > 0.5);
+    counter10mm += (absD > 1.0);
   }
 
   if (dcazValues.empty()) {
@@ -2663,8 +2690,24 @@ void VarManager::FillEventTracks(T const& tracks, float* values)
     values[kDCAzKurtosis] = -9999.0;
     values[kDCAzNPeaks] = -9999.0;
   }
-  // compute the binned bimodality coefficient and related statistics with a bin width of 50um
-  auto [bimodalityCoefficientBin, meanBin, stddevBin, skewnessBin, kurtosisBin, nPeaksBin] = BimodalityCoefficientAndNPeaks(dcazValues, 0.005);
+
+  // bin the DCAz values once with a bin width of 50um; the untrimmed and trimmed statistics are all computed from this histogram
+  const float binWidth = 0.005;
+  int firstBin, lastBin;
+  FillBinCounts(dcazValues, binWidth, -15.0, 15.0, fgDCAzCounts, firstBin, lastBin);
+  if (fgDCAzTrimmedCounts.size() < fgDCAzCounts.size()) {
+    fgDCAzTrimmedCounts.resize(fgDCAzCounts.size(), 0);
+  }
+  // the trimming only removes counts, so copying the range of non-empty bins is enough to restore the histogram
+  auto trimmedStatistics = [&](int trim) {
+    if (firstBin <= lastBin) {
+      std::copy(fgDCAzCounts.begin() + firstBin, fgDCAzCounts.begin() + lastBin + 1, fgDCAzTrimmedCounts.begin() + firstBin);
+    }
+    return BimodalityCoefficientAndNPeaksFromCounts(fgDCAzTrimmedCounts, firstBin, lastBin, dcazValues.size(), binWidth, trim);
+  };
+
+  // compute the binned bimodality coefficient and related statistics
+  auto [bimodalityCoefficientBin, meanBin, stddevBin, skewnessBin, kurtosisBin, nPeaksBin] = BimodalityCoefficientAndNPeaksFromCounts(fgDCAzCounts, firstBin, lastBin, dcazValues.size(), binWidth);
   if (stddevBin > -1.0) {
     values[kDCAzBimodalityCoefficientBinned] = bimodalityCoefficientBin;
   } else {
@@ -2672,9 +2715,9 @@ void VarManager::FillEventTracks(T const& tracks, float* values)
   }
   values[kDCAzNPeaks] = nPeaksBin;
   // cout << "Bimodality coefficient binned: " << bimodalityCoefficientBin << ", mean: " << mean << ", stddev: " << stddev << ", skewness: " << skewness << ", kurtosis: " << kurtosis << ", nPeaks: " << nPeaksBin << endl;
-  // compute the binned bimodality coefficient and related statistics with a bin width of 50um and different trimming versions
+  // compute the binned bimodality coefficient and related statistics with different trimming versions
   // more then 3 counts per bin
-  auto [bimodalityCoefficientBinTrimmed1, meanBinTrimmed1, stddevBinTrimmed1, skewnessBinTrimmed1, kurtosisBinTrimmed1, nPeaksBinTrimmed1] = BimodalityCoefficientAndNPeaks(dcazValues, 0.005, 4);
+  auto [bimodalityCoefficientBinTrimmed1, meanBinTrimmed1, stddevBinTrimmed1, skewnessBinTrimmed1, kurtosisBinTrimmed1, nPeaksBinTrimmed1] = trimmedStatistics(4);
   if (stddevBinTrimmed1 > -1.0) {
     values[kDCAzBimodalityCoefficientBinnedTrimmed1] = bimodalityCoefficientBinTrimmed1;
     values[kDCAzMeanBinnedTrimmed1] = meanBinTrimmed1;
@@ -2687,7 +2730,7 @@ void VarManager::FillEventTracks(T const& tracks, float* values)
   values[kDCAzNPeaksTrimmed1] = nPeaksBinTrimmed1;
   // cout << "Bimodality coefficient (trimmed 1): " << bimodalityCoefficientBinTrimmed1 << ", mean: " << meanBinTrimmed1 << ", stddev: " << stddevBinTrimmed1 << ", skewness: " << skewnessBinTrimmed1 << ", kurtosis: " << kurtosisBinTrimmed1 << ", nPeaks: " << nPeaksBinTrimmed1 << endl;
   // more than 3% of the entries per peak
-  auto [bimodalityCoefficientBinTrimmed2, meanBinTrimmed2, stddevBinTrimmed2, skewnessBinTrimmed2, kurtosisBinTrimmed2, nPeaksBinTrimmed2] = BimodalityCoefficientAndNPeaks(dcazValues, 0.005, -100);
+  auto [bimodalityCoefficientBinTrimmed2, meanBinTrimmed2, stddevBinTrimmed2, skewnessBinTrimmed2, kurtosisBinTrimmed2, nPeaksBinTrimmed2] = trimmedStatistics(-100);
   if (stddevBinTrimmed2 > -1.0) {
     values[kDCAzBimodalityCoefficientBinnedTrimmed2] = bimodalityCoefficientBinTrimmed2;
     values[kDCAzMeanBinnedTrimmed2] = meanBinTrimmed2;
@@ -2700,7 +2743,7 @@ void VarManager::FillEventTracks(T const& tracks, float* values)
   values[kDCAzNPeaksTrimmed2] = nPeaksBinTrimmed2;
   // cout << "Bimodality coefficient (trimmed 2): " << bimodalityCoefficientBinTrimmed2 << ", mean: " << meanBinTrimmed2 << ", stddev: " << stddevBinTrimmed2 << ", skewness: " << skewnessBinTrimmed2 << ", kurtosis: " << kurtosisBinTrimmed2 << ", nPeaks: " << nPeaksBinTrimmed2 << endl;
   // more than 5% of the entries per peak
-  auto [bimodalityCoefficientBinTrimmed3, meanBinTrimmed3, stddevBinTrimmed3, skewnessBinTrimmed3, kurtosisBinTrimmed3, nPeaksBinTrimmed3] = BimodalityCoefficientAndNPeaks(dcazValues, 0.005, -20);
+  auto [bimodalityCoefficientBinTrimmed3, meanBinTrimmed3, stddevBinTrimmed3, skewnessBinTrimmed3, kurtosisBinTrimmed3, nPeaksBinTrimmed3] = trimmedStatistics(-20);
   if (stddevBinTrimmed3 > -1.0) {
     values[kDCAzBimodalityCoefficientBinnedTrimmed3] = bimodalityCoefficientBinTrimmed3;
     values[kDCAzMeanBinnedTrimmed3] = meanBinTrimmed3;
@@ -2713,39 +2756,13 @@ void VarManager::FillEventTracks(T const& tracks, float* values)
   values[kDCAzNPeaksTrimmed3] = nPeaksBinTrimmed3;
   // cout << "Bimodality coefficient (trimmed 3): " << bimodalityCoefficientBinTrimmed3 << ", mean: " << meanBinTrimmed3 << ", stddev: " << stddevBinTrimmed3 << ", skewness: " << skewnessBinTrimmed3 << ", kurtosis: " << kurtosisBinTrimmed3 << ", nPeaks: " << nPeaksBinTrimmed3 << endl;
 
-  // compute fraction of tracks with |DCAz| > 100um, 200um, 500um, 1mm, 2mm, 5mm, 10mm
-  // make a loop over the DCAz values and count how many are above each threshold
-  int counter100um = 0;
-  int counter200um = 0;
-  int counter500um = 0;
-  int counter1mm = 0;
-  int counter2mm = 0;
-  int counter5mm = 0;
-  int counter10mm = 0;
-  for (auto& d : dcazValues) {
-    double absD = std::abs(d);
-    if (absD > 0.01) {
-      counter100um++;
-      if (absD > 0.02) {
-        counter200um++;
-        if (absD > 0.05) {
-          counter500um++;
-          if (absD > 0.1) {
-            counter1mm++;
-            if (absD > 0.2) {
-              counter2mm++;
-              if (absD > 0.5) {
-                counter5mm++;
-                if (absD > 1.0) {
-                  counter10mm++;
-                }
-              }
-            }
-          }
-        }
-      }
-    }
+  // leave the scratch histograms empty for the next collision
+  if (firstBin <= lastBin) {
+    std::fill(fgDCAzCounts.begin() + firstBin, fgDCAzCounts.begin() + lastBin + 1, 0);
+    std::fill(fgDCAzTrimmedCounts.begin() + firstBin, fgDCAzTrimmedCounts.begin() + lastBin + 1, 0);
   }
+
+  // fraction of tracks with |DCAz| > 100um, 200um, 500um, 1mm, 2mm, 5mm, 10mm
   int totalTracks = static_cast<int>(dcazValues.size());
   values[kDCAzFracAbove100um] = static_cast<float>(counter100um) / totalTracks;
   values[kDCAzFracAbove200um] = static_cast<float>(counter200um) / totalTracks;
@@ -29,6 +29,7 @@
 
 #include "Common/CCDB/EventSelectionParams.h"
 #include "Common/CCDB/RCTSelectionFlags.h"
+#include "Common/Core/IndexRemapper.h"
 #include "Common/DataModel/Centrality.h"
 #include "Common/DataModel/CollisionAssociationTables.h"
 #include "Common/DataModel/EventSelection.h"
@@ -268,14 +269,12 @@ struct TableMakerMC {
   std::map<uint64_t, int> fLabelsMap;
   std::map<uint64_t, int> fLabelsMapReversed;
   std::map<uint64_t, uint16_t> fMCFlags;
-  std::map<uint32_t, uint32_t> fCollIndexMap;             // key: old collision index, value: skimmed collision index
-  std::map<uint32_t, uint32_t> fTrackIndexMap;            // key: old track global index, value: new track global index
-  std::map<uint32_t, uint32_t> fFwdTrackIndexMap;         // key: fwd-track global index, value: new fwd-track global index
-  std::map<uint32_t, uint32_t> fFwdTrackIndexMapReversed; // key: new fwd-track global index, value: fwd-track global index
-  std::map<uint32_t, uint8_t> fFwdTrackFilterMap;         // key: fwd-track global index, value: fwd-track filter map
-  std::map<uint32_t, uint32_t> fMftIndexMap;              // key: MFT tracklet global index, value: new MFT tracklet global index
-
-  std::map<uint32_t, bool> fBestMatch;
+  IndexRemapper fCollIndexMap;     // old collision index -> skimmed collision index
+  IndexRemapper fTrackIndexMap;    // old track global index -> new track global index
+  IndexRemapper fFwdTrackIndexMap; // fwd-track global index -> new fwd-track global index, with the fwd-track filter map as filter word
+  IndexRemapper fMftIndexMap;      // MFT tracklet global index -> new MFT tracklet global index
+
+  std::vector<bool> fBestMatch; // fwd-tracks selected as best MFT-MCH match, indexed by the fwd-track global index
   std::unordered_map<int64_t, int32_t> map_mfttrackcovs;
 
   o2::analysis::MlResponseMFTMuonMatch<float> matchingMlResponse;
@@ -403,6 +402,8 @@ struct TableMakerMC {
     }
 
     for (auto& mcIt : fMCSignals) {
+      // the same MC particles are checked for the MC truth skimming and again for the matched reconstructed tracks
+      mcIt->SetUseParticleCache(true);
       if (fConfigHistOutput.fConfigQA) {
         histClasses += Form("MCTruth_%s;", mcIt->GetName());
       }
@@ -548,6 +549,10 @@ struct TableMakerMC {
     fLabelsMap.clear();
     fLabelsMapReversed.clear();
     fMCFlags.clear();
+    // Clear the MC signal decisions cached for the MC particles of the previous data frame
+    for (auto& sig : fMCSignals) {
+      sig->ResetParticleCache();
+    }
 
     uint16_t mcflags = static_cast<uint16_t>(0); // flags which will hold the decisions for each MC signal
     int trackCounter = 0;
@@ -699,7 +704,7 @@ struct TableMakerMC {
     // Skim reconstructed collisions which are selected by the user specified cuts
 
     // Create a collision index map to relate between the "old" AO2D indices and the skimmed ones
-    fCollIndexMap.clear();
+    fCollIndexMap.reset(collisions.size());
     int multTPC = -1.0;
     float multFV0A = -1.0;
     float multFV0C = -1.0;
@@ -821,7 +826,7 @@ struct TableMakerMC {
                    fCollMergingTag.nPeaksDCAzTrimmed2[collision.globalIndex()], fCollMergingTag.nPeaksDCAzTrimmed3[collision.globalIndex()]);
 
       // add an element for this collision into the map
-      fCollIndexMap[collision.globalIndex()] = event.lastIndex();
+      fCollIndexMap.set(collision.globalIndex(), event.lastIndex());
     }
   }
 
@@ -848,7 +853,7 @@ struct TableMakerMC {
       // If the original collision of this track was not selected for skimming, then we skip this track.
       //  Normally, the filter-pp is selecting all collisions which contain the tracks which contributed to the triggering
       //    of an event, so this is rejecting possibly a few tracks unrelated to the trigger, originally associated with collisions distant in time.
-      if (fCollIndexMap.find(track.collisionId()) == fCollIndexMap.end()) {
+      if (!fCollIndexMap.isKept(track.collisionId())) {
         continue;
       }
 
@@ -881,7 +886,7 @@ struct TableMakerMC {
 
       // If this track is already present in the index map, it means it was already skimmed,
       // so we just store the association and we skip the track
-      if (fTrackIndexMap.find(track.globalIndex()) != fTrackIndexMap.end()) {
+      if (fTrackIndexMap.isKept(track.globalIndex())) {
         trackBarrelAssoc(fCollIndexMap[collision.globalIndex()], fTrackIndexMap[track.globalIndex()]);
         continue;
       }
@@ -928,7 +933,7 @@ struct TableMakerMC {
                        track.beta(), track.tofNSigmaEl(), track.tofNSigmaMu(), track.tofNSigmaPi(), track.tofNSigmaKa(), track.tofNSigmaPr(),
                        track.trdSignal());
       }
-      fTrackIndexMap[track.globalIndex()] = trackBasic.lastIndex();
+      fTrackIndexMap.set(track.globalIndex(), trackBasic.lastIndex());
 
       // Check whether the MCParticle corresponding to this reconstructed track was already selected for skimming
       // If not, add it to the skimming map
@@ -991,13 +996,13 @@ struct TableMakerMC {
       }
 
       // write the MFT track global index in the map for skimming (to make sure we have it just once)
-      if (fMftIndexMap.find(track.globalIndex()) == fMftIndexMap.end()) {
+      if (!fMftIndexMap.isKept(track.globalIndex())) {
         uint32_t reducedEventIdx = fCollIndexMap[collision.globalIndex()];
         mftTrack(reducedEventIdx, static_cast<uint64_t>(0), track.pt(), track.eta(), track.phi());
         // TODO: We are not writing the DCA at the moment, because this depends on the collision association
         mftTrackExtra(track.mftClusterSizesAndTrackFlags(), track.sign(), 0.0, 0.0, track.nClusters());
 
-        fMftIndexMap[track.globalIndex()] = mftTrack.lastIndex();
+        fMftIndexMap.set(track.globalIndex(), mftTrack.lastIndex());
         if (!track.has_mcParticle()) {
           mftLabels(-1, 0, 0); // this is the case when there is no matched MCParticle
         } else {
@@ -1098,7 +1103,7 @@ struct TableMakerMC {
     //         which means that in the case of multiple associations, the track parameters are wrong and should be computed again at analysis time.
     uint8_t trackFilteringTag = static_cast<uint8_t>(0);
     uint8_t trackTempFilterMap = static_cast<uint8_t>(0);
-    fFwdTrackIndexMapReversed.clear();
+    const size_t firstKeptMuon = fFwdTrackIndexMap.size(); // muons kept before this collision are already written
     uint16_t mcflags = static_cast<uint16_t>(0);
     int trackCounter = fLabelsMap.size();
 
@@ -1108,7 +1113,7 @@ struct TableMakerMC {
       // get the muon
       auto muon = muons.rawIteratorAt(assoc.fwdtrackId());
       if (fConfigVariousOptions.fKeepBestMatch && static_cast<int>(muon.trackType()) < 2) {
-        if (fBestMatch.find(muon.globalIndex()) == fBestMatch.end()) {
+        if (!fBestMatch[muon.globalIndex()]) {
           continue;
         }
       }
@@ -1169,16 +1174,14 @@ struct TableMakerMC {
       trackFilteringTag = trackTempFilterMap; // BIT0-7:  user selection cuts
 
       // update the index map if this is a new muon (it can already exist in the map from a different collision association)
-      if (fFwdTrackIndexMap.find(muon.globalIndex()) == fFwdTrackIndexMap.end()) {
+      if (!fFwdTrackIndexMap.isKept(muon.globalIndex())) {
         counter++;
-        fFwdTrackIndexMap[muon.globalIndex()] = offset + counter;
-        fFwdTrackIndexMapReversed[offset + counter] = muon.globalIndex();
-        fFwdTrackFilterMap[muon.globalIndex()] = trackFilteringTag;                                                    // store here the filtering tag so we don't repeat the cuts in the second iteration
-        if (muon.has_matchMCHTrack() && (fFwdTrackIndexMap.find(muon.matchMCHTrackId()) == fFwdTrackIndexMap.end())) { // write also the matched MCH track
+        fFwdTrackIndexMap.set(muon.globalIndex(), offset + counter);
+        fFwdTrackIndexMap.addFilter(muon.globalIndex(), trackFilteringTag);                  // store here the filtering tag so we don't repeat the cuts in the second iteration
+        if (muon.has_matchMCHTrack() && !fFwdTrackIndexMap.isKept(muon.matchMCHTrackId())) { // write also the matched MCH track
           counter++;
-          fFwdTrackIndexMap[muon.matchMCHTrackId()] = offset + counter;
-          fFwdTrackIndexMapReversed[offset + counter] = muon.matchMCHTrackId();
-          fFwdTrackFilterMap[muon.matchMCHTrackId()] = trackFilteringTag; // store here the filtering tag so we don't repeat the cuts in the second iteration
+          fFwdTrackIndexMap.set(muon.matchMCHTrackId(), offset + counter);
+          fFwdTrackIndexMap.addFilter(muon.matchMCHTrackId(), trackFilteringTag); // store here the filtering tag so we don't repeat the cuts in the second iteration
         }
 
         if (muon.has_mcParticle()) {
@@ -1216,7 +1219,7 @@ struct TableMakerMC {
 
         } // end if (has_mcParticle)
       } else { // if muon already in the map, make a bitwise OR with previous existing cuts
-        fFwdTrackFilterMap[muon.globalIndex()] |= trackFilteringTag;
+        fFwdTrackIndexMap.addFilter(muon.globalIndex(), trackFilteringTag);
       }
       // write the association table
       muonAssoc(fCollIndexMap[collision.globalIndex()], fFwdTrackIndexMap[muon.globalIndex()]);
@@ -1224,12 +1227,13 @@ struct TableMakerMC {
 
     // Now we have the full index map of selected muons so we can proceed with writing the muon tables
     // Special care needed for the MCH and MFT indices
-    for (const auto& [skimIdx, origIdx] : fFwdTrackIndexMapReversed) {
+    for (size_t iKept = firstKeptMuon; iKept < fFwdTrackIndexMap.size(); iKept++) {
       // get the muon
+      auto origIdx = fFwdTrackIndexMap.keptRows()[iKept];
       auto muon = muons.rawIteratorAt(origIdx);
       uint32_t reducedEventIdx = -1;
       if (muon.has_collision() &&
-          fCollIndexMap.find(muon.collisionId()) != fCollIndexMap.end()) { // if the collisionId of this muon was not skimmed, leave the skimmed event index to -1
+          fCollIndexMap.isKept(muon.collisionId())) { // if the collisionId of this muon was not skimmed, leave the skimmed event index to -1
         reducedEventIdx = fCollIndexMap[muon.collisionId()];
       }
       // NOTE: Currently, one writes the original AO2D momentum-vector (pt, eta and phi) in the tables because we write only one instance of the muon track,
@@ -1239,10 +1243,10 @@ struct TableMakerMC {
       uint32_t mchIdx = -1;
       uint32_t mftIdx = -1;
       if (muon.trackType() == uint8_t(0) || muon.trackType() == uint8_t(2)) { // MCH-MID (2) or global (0)
-        if (fFwdTrackIndexMap.find(muon.matchMCHTrackId()) != fFwdTrackIndexMap.end()) {
+        if (fFwdTrackIndexMap.isKept(muon.matchMCHTrackId())) {
           mchIdx = fFwdTrackIndexMap[muon.matchMCHTrackId()];
         }
-        if (fMftIndexMap.find(muon.matchMFTTrackId()) != fMftIndexMap.end()) {
+        if (fMftIndexMap.isKept(muon.matchMFTTrackId())) {
           mftIdx = fMftIndexMap[muon.matchMFTTrackId()];
         }
       }
@@ -1274,7 +1278,7 @@ struct TableMakerMC {
       } else {
         VarManager::FillTrackCollision<TMuonFillMap>(muon, collision);
       }
-      muonBasic(reducedEventIdx, mchIdx, mftIdx, fFwdTrackFilterMap[muon.globalIndex()], VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], muon.sign(), 0);
+      muonBasic(reducedEventIdx, mchIdx, mftIdx, static_cast<uint8_t>(fFwdTrackIndexMap.filter(muon.globalIndex())), VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], muon.sign(), 0);
       muonExtra(globalClusters, VarManager::fgValues[VarManager::kMuonPDca], VarManager::fgValues[VarManager::kMuonRAtAbsorberEnd],
                 VarManager::fgValues[VarManager::kMuonChi2], muon.chi2MatchMCHMID(), muon.chi2MatchMCHMFT(),
                 muon.matchScoreMCHMFT(),
@@ -1362,7 +1366,7 @@ struct TableMakerMC {
 
     // Clear index map and reserve memory for barrel tables
     if constexpr (static_cast<bool>(TTrackFillMap)) {
-      fTrackIndexMap.clear();
+      fTrackIndexMap.reset(tracksBarrel.size());
       trackBarrelInfo.reserve(tracksBarrel.size());
       trackBasic.reserve(tracksBarrel.size());
       trackBarrel.reserve(tracksBarrel.size());
@@ -1374,7 +1378,7 @@ struct TableMakerMC {
 
     // Clear index map and reserve memory for MFT tables
     if constexpr (static_cast<bool>(TMFTFillMap)) {
-      fMftIndexMap.clear();
+      fMftIndexMap.reset(mftTracks.size());
       map_mfttrackcovs.clear();
       mftTrack.reserve(mftTracks.size());
       mftTrackExtra.reserve(mftTracks.size());
@@ -1384,9 +1388,8 @@ struct TableMakerMC {
 
     // Clear index map and reserve memory for muon tables
     if constexpr (static_cast<bool>(TMuonFillMap)) {
-      fFwdTrackIndexMap.clear();
-      fFwdTrackFilterMap.clear();
-      fBestMatch.clear();
+      fFwdTrackIndexMap.reset(muons.size(), true);
+      fBestMatch.assign(muons.size(), false);
       muonBasic.reserve(muons.size());
       muonExtra.reserve(muons.size());
       muonCov.reserve(muons.size());
@@ -1402,7 +1405,7 @@ struct TableMakerMC {
 
     // loop over selected collisions and select the tracks and fwd tracks to be skimmed
     if (fCollIndexMap.size() > 0) {
-      for (auto const& [origIdx, skimIdx] : fCollIndexMap) {
+      for (auto const& origIdx : fCollIndexMap.keptRows()) {
         auto collision = collisions.rawIteratorAt(origIdx);
         // group the tracks and muons for this collision
         if constexpr (static_cast<bool>(TTrackFillMap)) {
@@ -30,6 +30,7 @@
 #include "Common/CCDB/EventSelectionParams.h"
 #include "Common/CCDB/RCTSelectionFlags.h"
 #include "Common/CCDB/ctpRateFetcher.h"
+#include "Common/Core/IndexRemapper.h"
 #include "Common/Core/Zorro.h"
 #include "Common/DataModel/Centrality.h"
 #include "Common/DataModel/CollisionAssociationTables.h"
@@ -333,15 +334,13 @@ struct TableMaker {
   bool fDoDetailedQA = false; // Bool to set detailed QA true, if QA is set true
   int fCurrentRun;            // needed to detect if the run changed and trigger update of calibrations etc.
 
-  // maps used to store index info; NOTE: std::map are sorted in ascending order by default (needed for track to collision indices)
-  std::map<uint32_t, uint32_t> fCollIndexMap;             // key: old collision index, value: skimmed collision index
-  std::map<uint32_t, uint32_t> fTrackIndexMap;            // key: old track global index, value: new track global index
-  std::map<uint32_t, uint32_t> fFwdTrackIndexMap;         // key: fwd-track global index, value: new fwd-track global index
-  std::map<uint32_t, uint32_t> fFwdTrackIndexMapReversed; // key: new fwd-track global index, value: fwd-track global index
-  std::map<uint32_t, uint8_t> fFwdTrackFilterMap;         // key: fwd-track global index, value: fwd-track filter map
-  std::map<uint32_t, uint32_t> fMftIndexMap;              // key: MFT tracklet global index, value: new MFT tracklet global index
+  // maps used to store index info; NOTE: the kept rows are listed in the order in which they were kept, i.e. in ascending order of the collision indices
+  IndexRemapper fCollIndexMap;     // old collision index -> skimmed collision index
+  IndexRemapper fTrackIndexMap;    // old track global index -> new track global index
+  IndexRemapper fFwdTrackIndexMap; // fwd-track global index -> new fwd-track global index, with the fwd-track filter map as filter word
+  IndexRemapper fMftIndexMap;      // MFT tracklet global index -> new MFT tracklet global index
 
-  std::map<uint32_t, bool> fBestMatch;
+  std::vector<bool> fBestMatch; // fwd-tracks selected as best MFT-MCH match, indexed by the fwd-track global index
   std::unordered_map<int64_t, int32_t> map_mfttrackcovs;
 
   o2::analysis::MlResponseMFTMuonMatch<float> matchingMlResponse;
@@ -401,34 +400,49 @@ struct TableMaker {
     std::map<int32_t, int> oContribLongC;
   } fOccup;
 
-  // variables to store quantities needed for tagging collision merging candidates
+  // variables to store quantities needed for tagging collision merging candidates, indexed by the collision index in the time frame
   struct {
-    std::map<int32_t, float> bimodalityCoeffDCAz;               // Bimodality coefficient of the DCAz distribution of tracks associated to a collision
-    std::map<int32_t, float> bimodalityCoeffDCAzBinned;         // Bimodality coefficient of the DCAz distribution of tracks associated to a collision, binned
-    std::map<int32_t, float> bimodalityCoeffDCAzBinnedTrimmed1; // Bimodality coefficient of the DCAz distribution of tracks associated to a collision, binned and trimmed 1
-    std::map<int32_t, float> bimodalityCoeffDCAzBinnedTrimmed2; // Bimodality coefficient of the DCAz distribution of tracks associated to a collision, binned and trimmed 2
-    std::map<int32_t, float> bimodalityCoeffDCAzBinnedTrimmed3; // Bimodality coefficient of the DCAz distribution of tracks associated to a collision, binned and trimmed 3
-    std::map<int32_t, float> meanDCAz;
-    std::map<int32_t, float> meanDCAzBinnedTrimmed1;
-    std::map<int32_t, float> meanDCAzBinnedTrimmed2;
-    std::map<int32_t, float> meanDCAzBinnedTrimmed3;
-    std::map<int32_t, float> rmsDCAz;
-    std::map<int32_t, float> rmsDCAzBinnedTrimmed1;
-    std::map<int32_t, float> rmsDCAzBinnedTrimmed2;
-    std::map<int32_t, float> rmsDCAzBinnedTrimmed3;
-    std::map<int32_t, float> skewnessDCAz;
-    std::map<int32_t, float> kurtosisDCAz;
-    std::map<int32_t, float> fraction100umDCAz; // fraction of tracks with |DCAz|>100um
-    std::map<int32_t, float> fraction200umDCAz; // fraction of tracks with |DCAz|>200um
-    std::map<int32_t, float> fraction500umDCAz; // fraction of tracks with |DCAz|>500um
-    std::map<int32_t, float> fraction1mmDCAz;   // fraction of tracks with |DCAz|>1mm
-    std::map<int32_t, float> fraction2mmDCAz;   // fraction of tracks with |DCAz|>2mm
-    std::map<int32_t, float> fraction5mmDCAz;   // fraction of tracks with |DCAz|>5mm
-    std::map<int32_t, float> fraction10mmDCAz;  // fraction of tracks with |DCAz|>10mm
-    std::map<int32_t, int> nPeaksDCAz;          // number of peaks in the DCAz distribution of tracks associated to a collision
-    std::map<int32_t, int> nPeaksDCAzTrimmed1;  // number of peaks in the binned DCAz distribution (trimmed 1)
-    std::map<int32_t, int> nPeaksDCAzTrimmed2;  // number of peaks in the binned DCAz distribution (trimmed 2)
-    std::map<int32_t, int> nPeaksDCAzTrimmed3;  // number of peaks in the binned DCAz distribution (trimmed 3)
+    std::vector<float> bimodalityCoeffDCAz;               // Bimodality coefficient of the DCAz distribution of tracks associated to a collision
+    std::vector<float> bimodalityCoeffDCAzBinned;         // Bimodality coefficient of the DCAz distribution of tracks associated to a collision, binned
+    std::vector<float> bimodalityCoeffDCAzBinnedTrimmed1; // Bimodality coefficient of the DCAz distribution of tracks associated to a collision, binned and trimmed 1
+    std::vector<float> bimodalityCoeffDCAzBinnedTrimmed2; // Bimodality coefficient of the DCAz distribution of tracks associated to a collision, binned and trimmed 2
+    std::vector<float> bimodalityCoeffDCAzBinnedTrimmed3; // Bimodality coefficient of the DCAz distribution of tracks associated to a collision, binned and trimmed 3
+    std::vector<float> meanDCAz;
+    std::vector<float> meanDCAzBinnedTrimmed1;
+    std::vector<float> meanDCAzBinnedTrimmed2;
+    std::vector<float> meanDCAzBinnedTrimmed3;
+    std::vector<float> rmsDCAz;
+    std::vector<float> rmsDCAzBinnedTrimmed1;
+    std::vector<float> rmsDCAzBinnedTrimmed2;
+    std::vector<float> rmsDCAzBinnedTrimmed3;
+    std::vector<float> skewnessDCAz;
+    std::vector<float> kurtosisDCAz;
+    std::vector<float> fraction100umDCAz; // fraction of tracks with |DCAz|>100um
+    std::vector<float> fraction200umDCAz; // fraction of tracks with |DCAz|>200um
+    std::vector<float> fraction500umDCAz; // fraction of tracks with |DCAz|>500um
+    std::vector<float> fraction1mmDCAz;   // fraction of tracks with |DCAz|>1mm
+    std::vector<float> fraction2mmDCAz;   // fraction of tracks with |DCAz|>2mm
+    std::vector<float> fraction5mmDCAz;   // fraction of tracks with |DCAz|>5mm
+    std::vector<float> fraction10mmDCAz;  // fraction of tracks with |DCAz|>10mm
+    std::vector<int> nPeaksDCAz;          // number of peaks in the DCAz distribution of tracks associated to a collision
+    std::vector<int> nPeaksDCAzTrimmed1;  // number of peaks in the binned DCAz distribution (trimmed 1)
+    std::vector<int> nPeaksDCAzTrimmed2;  // number of peaks in the binned DCAz distribution (trimmed 2)
+    std::vector<int> nPeaksDCAzTrimmed3;  // number of peaks in the binned DCAz distribution (trimmed 3)
+
+    size_t size() const { return bimodalityCoeffDCAz.size(); }
+    void reset(size_t nCollisions)
+    {
+      // clear the values of the previous time frame and allocate zeroed ones for nCollisions
+      for (auto* v : {&bimodalityCoeffDCAz, &bimodalityCoeffDCAzBinned, &bimodalityCoeffDCAzBinnedTrimmed1, &bimodalityCoeffDCAzBinnedTrimmed2, &bimodalityCoeffDCAzBinnedTrimmed3,
+                      &meanDCAz, &meanDCAzBinnedTrimmed1, &meanDCAzBinnedTrimmed2, &meanDCAzBinnedTrimmed3,
+                      &rmsDCAz, &rmsDCAzBinnedTrimmed1, &rmsDCAzBinnedTrimmed2, &rmsDCAzBinnedTrimmed3, &skewnessDCAz, &kurtosisDCAz,
+                      &fraction100umDCAz, &fraction200umDCAz, &fraction500umDCAz, &fraction1mmDCAz, &fraction2mmDCAz, &fraction5mmDCAz, &fraction10mmDCAz}) {
+        v->assign(nCollisions, 0.0f);
+      }
+      for (auto* v : {&nPeaksDCAz, &nPeaksDCAzTrimmed1, &nPeaksDCAzTrimmed2, &nPeaksDCAzTrimmed3}) {
+        v->assign(nCollisions, 0);
+      }
+    }
   } fCollMergingTag;
 
   void init(o2::framework::InitContext& context)
@@ -908,65 +922,41 @@ struct TableMaker {
   void computeCollMergingTag(TEvents const& collisions, TTracks const& tracks, Preslice<TTracks>& preslice)
   {
     // This function uses the standard track-collision association to compute quantities related to collision merging
-    // clear the maps for this time frame
-    fCollMergingTag.bimodalityCoeffDCAz.clear();
-    fCollMergingTag.bimodalityCoeffDCAzBinned.clear();
-    fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed1.clear();
-    fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed2.clear();
-    fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed3.clear();
-    fCollMergingTag.meanDCAz.clear();
-    fCollMergingTag.meanDCAzBinnedTrimmed1.clear();
-    fCollMergingTag.meanDCAzBinnedTrimmed2.clear();
-    fCollMergingTag.meanDCAzBinnedTrimmed3.clear();
-    fCollMergingTag.rmsDCAz.clear();
-    fCollMergingTag.rmsDCAzBinnedTrimmed1.clear();
-    fCollMergingTag.rmsDCAzBinnedTrimmed2.clear();
-    fCollMergingTag.rmsDCAzBinnedTrimmed3.clear();
-    fCollMergingTag.skewnessDCAz.clear();
-    fCollMergingTag.kurtosisDCAz.clear();
-    fCollMergingTag.fraction100umDCAz.clear();
-    fCollMergingTag.fraction200umDCAz.clear();
-    fCollMergingTag.fraction500umDCAz.clear();
-    fCollMergingTag.fraction1mmDCAz.clear();
-    fCollMergingTag.fraction2mmDCAz.clear();
-    fCollMergingTag.fraction5mmDCAz.clear();
-    fCollMergingTag.fraction10mmDCAz.clear();
-    fCollMergingTag.nPeaksDCAz.clear();
-    fCollMergingTag.nPeaksDCAzTrimmed1.clear();
-    fCollMergingTag.nPeaksDCAzTrimmed2.clear();
-    fCollMergingTag.nPeaksDCAzTrimmed3.clear();
+    // reset the values for this time frame
+    fCollMergingTag.reset(collisions.size());
 
     for (const auto& collision : collisions) {
       // make a slice for this collision and compute the DCAz based event quantities
       auto thisCollTracks = tracks.sliceBy(preslice, collision.globalIndex());
       VarManager::FillEventTracks(thisCollTracks); // fill the VarManager arrays with the information of the tracks associated to this collision, needed for the cuts and histograms
-      // add the computed variables to the maps with the collision index as key
-      fCollMergingTag.bimodalityCoeffDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzBimodalityCoefficient];
-      fCollMergingTag.bimodalityCoeffDCAzBinned[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzBimodalityCoefficientBinned];
-      fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed1[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzBimodalityCoefficientBinnedTrimmed1];
-      fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed2[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzBimodalityCoefficientBinnedTrimmed2];
-      fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed3[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzBimodalityCoefficientBinnedTrimmed3];
-      fCollMergingTag.meanDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzMean];
-      fCollMergingTag.meanDCAzBinnedTrimmed1[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzMeanBinnedTrimmed1];
-      fCollMergingTag.meanDCAzBinnedTrimmed2[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzMeanBinnedTrimmed2];
-      fCollMergingTag.meanDCAzBinnedTrimmed3[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzMeanBinnedTrimmed3];
-      fCollMergingTag.rmsDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzRMS];
-      fCollMergingTag.rmsDCAzBinnedTrimmed1[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzRMSBinnedTrimmed1];
-      fCollMergingTag.rmsDCAzBinnedTrimmed2[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzRMSBinnedTrimmed2];
-      fCollMergingTag.rmsDCAzBinnedTrimmed3[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzRMSBinnedTrimmed3];
-      fCollMergingTag.skewnessDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzSkewness];
-      fCollMergingTag.kurtosisDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzKurtosis];
-      fCollMergingTag.fraction100umDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzFracAbove100um];
-      fCollMergingTag.fraction200umDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzFracAbove200um];
-      fCollMergingTag.fraction500umDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzFracAbove500um];
-      fCollMergingTag.fraction1mmDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzFracAbove1mm];
-      fCollMergingTag.fraction2mmDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzFracAbove2mm];
-      fCollMergingTag.fraction5mmDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzFracAbove5mm];
-      fCollMergingTag.fraction10mmDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzFracAbove10mm];
-      fCollMergingTag.nPeaksDCAz[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzNPeaks];
-      fCollMergingTag.nPeaksDCAzTrimmed1[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzNPeaksTrimmed1];
-      fCollMergingTag.nPeaksDCAzTrimmed2[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzNPeaksTrimmed2];
-      fCollMergingTag.nPeaksDCAzTrimmed3[collision.globalIndex()] = VarManager::fgValues[VarManager::kDCAzNPeaksTrimmed3];
+      // store the computed variables at the position of this collision
+      auto iColl = collision.globalIndex();
+      fCollMergingTag.bimodalityCoeffDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzBimodalityCoefficient];
+      fCollMergingTag.bimodalityCoeffDCAzBinned[iColl] = VarManager::fgValues[VarManager::kDCAzBimodalityCoefficientBinned];
+      fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed1[iColl] = VarManager::fgValues[VarManager::kDCAzBimodalityCoefficientBinnedTrimmed1];
+      fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed2[iColl] = VarManager::fgValues[VarManager::kDCAzBimodalityCoefficientBinnedTrimmed2];
+      fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed3[iColl] = VarManager::fgValues[VarManager::kDCAzBimodalityCoefficientBinnedTrimmed3];
+      fCollMergingTag.meanDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzMean];
+      fCollMergingTag.meanDCAzBinnedTrimmed1[iColl] = VarManager::fgValues[VarManager::kDCAzMeanBinnedTrimmed1];
+      fCollMergingTag.meanDCAzBinnedTrimmed2[iColl] = VarManager::fgValues[VarManager::kDCAzMeanBinnedTrimmed2];
+      fCollMergingTag.meanDCAzBinnedTrimmed3[iColl] = VarManager::fgValues[VarManager::kDCAzMeanBinnedTrimmed3];
+      fCollMergingTag.rmsDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzRMS];
+      fCollMergingTag.rmsDCAzBinnedTrimmed1[iColl] = VarManager::fgValues[VarManager::kDCAzRMSBinnedTrimmed1];
+      fCollMergingTag.rmsDCAzBinnedTrimmed2[iColl] = VarManager::fgValues[VarManager::kDCAzRMSBinnedTrimmed2];
+      fCollMergingTag.rmsDCAzBinnedTrimmed3[iColl] = VarManager::fgValues[VarManager::kDCAzRMSBinnedTrimmed3];
+      fCollMergingTag.skewnessDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzSkewness];
+      fCollMergingTag.kurtosisDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzKurtosis];
+      fCollMergingTag.fraction100umDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzFracAbove100um];
+      fCollMergingTag.fraction200umDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzFracAbove200um];
+      fCollMergingTag.fraction500umDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzFracAbove500um];
+      fCollMergingTag.fraction1mmDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzFracAbove1mm];
+      fCollMergingTag.fraction2mmDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzFracAbove2mm];
+      fCollMergingTag.fraction5mmDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzFracAbove5mm];
+      fCollMergingTag.fraction10mmDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzFracAbove10mm];
+      fCollMergingTag.nPeaksDCAz[iColl] = VarManager::fgValues[VarManager::kDCAzNPeaks];
+      fCollMergingTag.nPeaksDCAzTrimmed1[iColl] = VarManager::fgValues[VarManager::kDCAzNPeaksTrimmed1];
+      fCollMergingTag.nPeaksDCAzTrimmed2[iColl] = VarManager::fgValues[VarManager::kDCAzNPeaksTrimmed2];
+      fCollMergingTag.nPeaksDCAzTrimmed3[iColl] = VarManager::fgValues[VarManager::kDCAzNPeaksTrimmed3];
     }
   }
 
@@ -980,7 +970,11 @@ struct TableMaker {
     //      The collision-track associations which point to an event that is not selected for writing are discarded!
 
     VarManager::FillTimeFrame(collisions);
-    fCollIndexMap.clear();
+    fCollIndexMap.reset(collisions.size());
+    // the collision merging tag is computed only by the Pb-Pb barrel process functions, write zeros otherwise
+    if (fCollMergingTag.size() != static_cast<size_t>(collisions.size())) {
+      fCollMergingTag.reset(collisions.size());
+    }
     int multTPC = -1.0;
     float multFV0A = -1.0;
     float multFV0C = -1.0;
@@ -1249,20 +1243,21 @@ struct TableMaker {
                           fOccup.oMeanTimeShortA[collision.globalIndex()], fOccup.oMeanTimeShortC[collision.globalIndex()],
                           fOccup.oMedianTimeShortA[collision.globalIndex()], fOccup.oMedianTimeShortC[collision.globalIndex()]);
       }
-      outTables.mergingTable(fCollMergingTag.bimodalityCoeffDCAz[collision.globalIndex()], fCollMergingTag.bimodalityCoeffDCAzBinned[collision.globalIndex()],
-                             fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed1[collision.globalIndex()], fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed2[collision.globalIndex()], fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed3[collision.globalIndex()],
-                             fCollMergingTag.meanDCAz[collision.globalIndex()], fCollMergingTag.meanDCAzBinnedTrimmed1[collision.globalIndex()], fCollMergingTag.meanDCAzBinnedTrimmed2[collision.globalIndex()], fCollMergingTag.meanDCAzBinnedTrimmed3[collision.globalIndex()],
-                             fCollMergingTag.rmsDCAz[collision.globalIndex()], fCollMergingTag.rmsDCAzBinnedTrimmed1[collision.globalIndex()], fCollMergingTag.rmsDCAzBinnedTrimmed2[collision.globalIndex()], fCollMergingTag.rmsDCAzBinnedTrimmed3[collision.globalIndex()],
-                             fCollMergingTag.skewnessDCAz[collision.globalIndex()], fCollMergingTag.kurtosisDCAz[collision.globalIndex()],
-                             fCollMergingTag.fraction100umDCAz[collision.globalIndex()], fCollMergingTag.fraction200umDCAz[collision.globalIndex()],
-                             fCollMergingTag.fraction500umDCAz[collision.globalIndex()], fCollMergingTag.fraction1mmDCAz[collision.globalIndex()],
-                             fCollMergingTag.fraction2mmDCAz[collision.globalIndex()], fCollMergingTag.fraction5mmDCAz[collision.globalIndex()],
-                             fCollMergingTag.fraction10mmDCAz[collision.globalIndex()],
-                             fCollMergingTag.nPeaksDCAz[collision.globalIndex()], fCollMergingTag.nPeaksDCAzTrimmed1[collision.globalIndex()],
-                             fCollMergingTag.nPeaksDCAzTrimmed2[collision.globalIndex()], fCollMergingTag.nPeaksDCAzTrimmed3[collision.globalIndex()]);
+      auto iColl = collision.globalIndex();
+      outTables.mergingTable(fCollMergingTag.bimodalityCoeffDCAz[iColl], fCollMergingTag.bimodalityCoeffDCAzBinned[iColl],
+                             fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed1[iColl], fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed2[iColl], fCollMergingTag.bimodalityCoeffDCAzBinnedTrimmed3[iColl],
+                             fCollMergingTag.meanDCAz[iColl], fCollMergingTag.meanDCAzBinnedTrimmed1[iColl], fCollMergingTag.meanDCAzBinnedTrimmed2[iColl], fCollMergingTag.meanDCAzBinnedTrimmed3[iColl],
+                             fCollMergingTag.rmsDCAz[iColl], fCollMergingTag.rmsDCAzBinnedTrimmed1[iColl], fCollMergingTag.rmsDCAzBinnedTrimmed2[iColl], fCollMergingTag.rmsDCAzBinnedTrimmed3[iColl],
+                             fCollMergingTag.skewnessDCAz[iColl], fCollMergingTag.kurtosisDCAz[iColl],
+                             fCollMergingTag.fraction100umDCAz[iColl], fCollMergingTag.fraction200umDCAz[iColl],
+                             fCollMergingTag.fraction500umDCAz[iColl], fCollMergingTag.fraction1mmDCAz[iColl],
+                             fCollMergingTag.fraction2mmDCAz[iColl], fCollMergingTag.fraction5mmDCAz[iColl],
+                             fCollMergingTag.fraction10mmDCAz[iColl],
+                             fCollMergingTag.nPeaksDCAz[iColl], fCollMergingTag.nPeaksDCAzTrimmed1[iColl],
+                             fCollMergingTag.nPeaksDCAzTrimmed2[iColl], fCollMergingTag.nPeaksDCAzTrimmed3[iColl]);
 
       //
-      fCollIndexMap[collision.globalIndex()] = outTables.event.lastIndex();
+      fCollIndexMap.set(collision.globalIndex(), outTables.event.lastIndex());
     }
   }
 
@@ -1289,7 +1284,7 @@ struct TableMaker {
       // If the original collision of this track was not selected for skimming, then we skip this track.
       //  Normally, the filter-pp is selecting all collisions which contain the tracks which contributed to the triggering
       //    of an event, so this is rejecting possibly a few tracks unrelated to the trigger, originally associated with collisions distant in time.
-      if (fCollIndexMap.find(track.collisionId()) == fCollIndexMap.end()) {
+      if (!fCollIndexMap.isKept(track.collisionId())) {
         continue;
       }
 
@@ -1313,7 +1308,7 @@ struct TableMaker {
           trackTempFilterMap |= (static_cast<uint32_t>(1) << i);
           // NOTE: the QA is filled here just for the first occurence of this track.
           //    So if there are histograms of quantities which depend on the collision association, these will not be accurate
-          if (fConfigHistOutput.fConfigQA && (fTrackIndexMap.find(track.globalIndex()) == fTrackIndexMap.end())) {
+          if (fConfigHistOutput.fConfigQA && (!fTrackIndexMap.isKept(track.globalIndex()))) {
             fHistMan->FillHistClass(Form("TrackBarrel_%s", (*cut)->GetName()), VarManager::fgValues);
           }
           (reinterpret_cast<TH1D*>(fStatsList->At(kStatsTracks)))->Fill(static_cast<float>(i));
@@ -1325,7 +1320,7 @@ struct TableMaker {
 
       // If this track is already present in the index map, it means it was already skimmed,
       // so we just store the association and we skip the track
-      if (fTrackIndexMap.find(track.globalIndex()) != fTrackIndexMap.end()) {
+      if (fTrackIndexMap.isKept(track.globalIndex())) {
         outTables.trackBarrelAssoc(fCollIndexMap[collision.globalIndex()], fTrackIndexMap[track.globalIndex()]);
         continue;
       }
@@ -1420,7 +1415,7 @@ struct TableMaker {
                                  -999.0);
       }
 
-      fTrackIndexMap[track.globalIndex()] = outTables.trackBasic.lastIndex();
+      fTrackIndexMap.set(track.globalIndex(), outTables.trackBasic.lastIndex());
 
       // write the skimmed collision - track association
       outTables.trackBarrelAssoc(fCollIndexMap[collision.globalIndex()], fTrackIndexMap[track.globalIndex()]);
@@ -1442,13 +1437,13 @@ struct TableMaker {
       }
 
       // write the MFT track global index in the map for skimming (to make sure we have it just once)
-      if (fMftIndexMap.find(track.globalIndex()) == fMftIndexMap.end()) {
+      if (!fMftIndexMap.isKept(track.globalIndex())) {
         uint32_t reducedEventIdx = fCollIndexMap[collision.globalIndex()];
         outTables.mftTrack(reducedEventIdx, static_cast<uint64_t>(0), track.pt(), track.eta(), track.phi());
         // TODO: We are not writing the DCA at the moment, because this depend on the collision association
         outTables.mftTrackExtra(track.mftClusterSizesAndTrackFlags(), track.sign(), 0.0, 0.0, track.nClusters());
 
-        fMftIndexMap[track.globalIndex()] = outTables.mftTrack.lastIndex();
+        fMftIndexMap.set(track.globalIndex(), outTables.mftTrack.lastIndex());
       }
       outTables.mftAssoc(fCollIndexMap[collision.globalIndex()], fMftIndexMap[track.globalIndex()]);
     }
@@ -1522,7 +1517,7 @@ struct TableMaker {
 
     uint8_t trackFilteringTag = static_cast<uint8_t>(0);
     uint8_t trackTempFilterMap = static_cast<uint8_t>(0);
-    fFwdTrackIndexMapReversed.clear();
+    const size_t firstKeptMuon = fFwdTrackIndexMap.size(); // muons kept before this collision are already written
 
     uint32_t offset = outTables.muonBasic.lastIndex();
     uint32_t counter = 0;
@@ -1530,7 +1525,7 @@ struct TableMaker {
       // get the muon
       auto muon = muons.rawIteratorAt(assoc.fwdtrackId());
       if (fConfigVariousOptions.fKeepBestMatch && static_cast<int>(muon.trackType()) < 2) {
-        if (fBestMatch.find(muon.globalIndex()) == fBestMatch.end()) {
+        if (!fBestMatch[muon.globalIndex()]) {
           continue;
         }
       }
@@ -1583,7 +1578,7 @@ struct TableMaker {
           // NOTE: the QA is filled here just for the first occurence of this muon, which means the current association
           //     will be skipped from histograms if this muon was already filled in the skimming map.
           //    So if there are histograms of quantities which depend on the collision association, these histograms will not be completely accurate
-          if (fConfigHistOutput.fConfigQA && (fFwdTrackIndexMap.find(muon.globalIndex()) == fFwdTrackIndexMap.end())) {
+          if (fConfigHistOutput.fConfigQA && (!fFwdTrackIndexMap.isKept(muon.globalIndex()))) {
             fHistMan->FillHistClass(Form("Muons_%s", (*cut)->GetName()), VarManager::fgValues);
           }
           (reinterpret_cast<TH1D*>(fStatsList->At(kStatsMuons)))->Fill(static_cast<float>(i));
@@ -1597,19 +1592,17 @@ struct TableMaker {
       trackFilteringTag = trackTempFilterMap; // BIT0-7:  user selection cuts
 
       // update the index map if this is a new muon (it can already exist in the map from a different collision association)
-      if (fFwdTrackIndexMap.find(muon.globalIndex()) == fFwdTrackIndexMap.end()) {
+      if (!fFwdTrackIndexMap.isKept(muon.globalIndex())) {
         counter++;
-        fFwdTrackIndexMap[muon.globalIndex()] = offset + counter;
-        fFwdTrackIndexMapReversed[offset + counter] = muon.globalIndex();
-        fFwdTrackFilterMap[muon.globalIndex()] = trackFilteringTag;                                                    // store here the filtering tag so we don't repeat the cuts in the second iteration
-        if (muon.has_matchMCHTrack() && (fFwdTrackIndexMap.find(muon.matchMCHTrackId()) == fFwdTrackIndexMap.end())) { // write also the matched MCH track
+        fFwdTrackIndexMap.set(muon.globalIndex(), offset + counter);
+        fFwdTrackIndexMap.addFilter(muon.globalIndex(), trackFilteringTag);                  // store here the filtering tag so we don't repeat the cuts in the second iteration
+        if (muon.has_matchMCHTrack() && !fFwdTrackIndexMap.isKept(muon.matchMCHTrackId())) { // write also the matched MCH track
           counter++;
-          fFwdTrackIndexMap[muon.matchMCHTrackId()] = offset + counter;
-          fFwdTrackIndexMapReversed[offset + counter] = muon.matchMCHTrackId();
-          fFwdTrackFilterMap[muon.matchMCHTrackId()] = trackFilteringTag; // store here the filtering tag so we don't repeat the cuts in the second iteration
+          fFwdTrackIndexMap.set(muon.matchMCHTrackId(), offset + counter);
+          fFwdTrackIndexMap.addFilter(muon.matchMCHTrackId(), trackFilteringTag); // store here the filtering tag so we don't repeat the cuts in the second iteration
         }
       } else {
-        fFwdTrackFilterMap[muon.globalIndex()] |= trackFilteringTag; // make a bitwise OR with previous existing cuts
+        fFwdTrackIndexMap.addFilter(muon.globalIndex(), trackFilteringTag); // make a bitwise OR with previous existing cuts
       }
       // write the association table
       outTables.muonAssoc(fCollIndexMap[collision.globalIndex()], fFwdTrackIndexMap[muon.globalIndex()]);
@@ -1617,8 +1610,9 @@ struct TableMaker {
 
     // Now we have the full index map of selected muons so we can proceed with writing the muon tables
     // Special care needed for the MCH and MFT indices
-    for (const auto& [skimIdx, origIdx] : fFwdTrackIndexMapReversed) {
+    for (size_t iKept = firstKeptMuon; iKept < fFwdTrackIndexMap.size(); iKept++) {
       // get the muon
+      auto origIdx = fFwdTrackIndexMap.keptRows()[iKept];
       auto muon = muons.rawIteratorAt(origIdx);
       uint32_t reducedEventIdx = fCollIndexMap[collision.globalIndex()];
       // NOTE: Currently, one writes in the tables the momentum-vector (pt, eta and phi) of the first collision association for this muon,
@@ -1628,10 +1622,10 @@ struct TableMaker {
       uint32_t mchIdx = -1;
       uint32_t mftIdx = -1;
       if (muon.trackType() == static_cast<uint8_t>(0) || muon.trackType() == static_cast<uint8_t>(2)) { // MCH-MID (2) or global (0)
-        if (fFwdTrackIndexMap.find(muon.matchMCHTrackId()) != fFwdTrackIndexMap.end()) {
+        if (fFwdTrackIndexMap.isKept(muon.matchMCHTrackId())) {
           mchIdx = fFwdTrackIndexMap[muon.matchMCHTrackId()];
         }
-        if (fMftIndexMap.find(muon.matchMFTTrackId()) != fMftIndexMap.end()) {
+        if (fMftIndexMap.isKept(muon.matchMFTTrackId())) {
           mftIdx = fMftIndexMap[muon.matchMFTTrackId()];
         }
       }
@@ -1663,7 +1657,7 @@ struct TableMaker {
       } else {
         VarManager::FillTrackCollision<TMuonFillMap>(muon, collision);
       }
-      outTables.muonBasic(reducedEventIdx, mchIdx, mftIdx, fFwdTrackFilterMap[muon.globalIndex()], VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], muon.sign(), 0);
+      outTables.muonBasic(reducedEventIdx, mchIdx, mftIdx, static_cast<uint8_t>(fFwdTrackIndexMap.filter(muon.globalIndex())), VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], muon.sign(), 0);
       outTables.muonExtra(globalClusters, VarManager::fgValues[VarManager::kMuonPDca], VarManager::fgValues[VarManager::kMuonRAtAbsorberEnd],
                           VarManager::fgValues[VarManager::kMuonChi2], muon.chi2MatchMCHMID(), muon.chi2MatchMCHMFT(),
                           muon.matchScoreMCHMFT(),
@@ -1760,7 +1754,7 @@ struct TableMaker {
     }
 
     if constexpr (static_cast<bool>(TTrackFillMap)) {
-      fTrackIndexMap.clear();
+      fTrackIndexMap.reset(tracksBarrel.size());
       outTables.trackBarrelInfo.reserve(tracksBarrel.size());
       outTables.trackBasic.reserve(tracksBarrel.size());
       outTables.trackBarrel.reserve(tracksBarrel.size());
@@ -1770,7 +1764,7 @@ struct TableMaker {
     }
 
     if constexpr (static_cast<bool>(TMFTFillMap)) {
-      fMftIndexMap.clear();
+      fMftIndexMap.reset(mftTracks.size());
       map_mfttrackcovs.clear();
       outTables.mftTrack.reserve(mftTracks.size());
       outTables.mftTrackExtra.reserve(mftTracks.size());
@@ -1778,9 +1772,8 @@ struct TableMaker {
     }
 
     if constexpr (static_cast<bool>(TMuonFillMap)) {
-      fFwdTrackIndexMap.clear();
-      fFwdTrackFilterMap.clear();
-      fBestMatch.clear();
+      fFwdTrackIndexMap.reset(muons.size(), true);
+      fBestMatch.assign(muons.size(), false);
       outTables.muonBasic.reserve(muons.size());
       outTables.muonExtra.reserve(muons.size());
       outTables.muonInfo.reserve(muons.size());
@@ -1795,7 +1788,7 @@ struct TableMaker {
     }
 
     // loop over selected collisions, group the compatible associations, and run the skimming
-    for (auto const& [origIdx, skimIdx] : fCollIndexMap) {
+    for (auto const& origIdx : fCollIndexMap.keptRows()) {
       auto collision = collisions.rawIteratorAt(origIdx);
       // group the barrel track associations for this collision
       if constexpr (static_cast<bool>(TTrackFillMap)) {
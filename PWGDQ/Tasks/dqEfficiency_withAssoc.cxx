@@ -1556,6 +1556,13 @@ struct AnalysisSameEventPairing {
         fEmuRecMCSignals.push_back(mcIt);
       }
     }
+    // the MC particles enter many pairs, so the signal decisions are cached per MC particle
+    for (auto const& sig : fRecMCSignals) {
+      sig->SetUseParticleCache(true);
+    }
+    for (auto const& sig : fEmuRecMCSignals) {
+      sig->SetUseParticleCache(true);
+    }
 
     // get the barrel track selection cuts
     std::string tempCuts;
@@ -1893,6 +1900,9 @@ struct AnalysisSameEventPairing {
         fFinalStateMCSignals.push_back(sig);
       }
     }
+    for (auto const& sig : fGenMCSignals) {
+      sig->SetUseParticleCache(true);
+    }
 
     if (isMCGen) {
       for (auto const& sig : fGenMCSignals) {
@@ -1979,10 +1989,25 @@ struct AnalysisSameEventPairing {
     }
   }
 
+  // Clear the MC signal decisions cached for the MC particles of the previous data frame
+  void resetMCSignalCaches()
+  {
+    for (auto const& sig : fRecMCSignals) {
+      sig->ResetParticleCache();
+    }
+    for (auto const& sig : fEmuRecMCSignals) {
+      sig->ResetParticleCache();
+    }
+    for (auto const& sig : fGenMCSignals) {
+      sig->ResetParticleCache();
+    }
+  }
+
   // Template function to run same event pairing (barrel-barrel, muon-muon, barrel-muon)
   template <bool TTwoProngFitter, int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, typename TEvents, typename TTrackAssocs, typename TTracks>
   void runSameEventPairing(TEvents const& events, Preslice<TTrackAssocs>& preslice, TTrackAssocs const& assocs, TTracks const& /*tracks*/, ReducedMCEvents const& /*mcEvents*/, ReducedMCTracks const& mcTracks)
   {
+    resetMCSignalCaches();
     if (events.size() == 0) {
       LOG(warning) << "No events in this TF, going to the next one ...";
       return;
@@ -2396,6 +2421,7 @@ struct AnalysisSameEventPairing {
   template <int TPairType>
   void runMCGen(MyEventsVtxCovSelected const& events, ReducedMCEvents const& mcEvents, ReducedMCTracks const& mcTracks)
   {
+    resetMCSignalCaches();
     uint32_t mcDecision = 0;
     int isig = 0;
 
@@ -2523,6 +2549,7 @@ struct AnalysisSameEventPairing {
   template <int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, uint32_t TMuonFillMap, typename TEvents, typename TTrackAssocs, typename TTracks, typename TMuonAssocs, typename TMuons>
   void runEmuSameEventPairing(TEvents const& events, Preslice<TTrackAssocs>& preslice1, TTrackAssocs const& assocs1, TTracks const& /*tracks1*/, Preslice<TMuonAssocs>& preslice2, TMuonAssocs const& assocs2, TMuons const& /*tracks2*/, ReducedMCEvents const& /*mcEvents*/, ReducedMCTracks const& /*mcTracks*/)
   {
+    resetMCSignalCaches();
     if (events.size() > 0) {
       if (fCurrentRun != events.begin().runNumber()) {
         initParamsFromCCDB(events.begin().timestamp(), true);
@@ -2873,6 +2900,7 @@ struct AnalysisSameEventPairing {
 
   void processMCGen(soa::Filtered<MyEventsVtxCovSelected> const& events, ReducedMCEvents const& mcEvents, ReducedMCTracks const& mcTracks)
   {
+    resetMCSignalCaches();
     // Fill Generated histograms taking into account all generated tracks
     uint32_t mcDecision = 0;
     int isig = 0;
@@ -2988,6 +3016,7 @@ struct AnalysisSameEventPairing {
 
   void processMCGenWithGrouping(soa::Filtered<MyEventsVtxCovSelected> const& events, ReducedMCEvents const& mcEvents, ReducedMCTracks const& mcTracks)
   {
+    resetMCSignalCaches();
     uint32_t mcDecision = 0;
     int isig = 0;
 
@@ -3269,6 +3298,10 @@ struct AnalysisAsymmetricPairing {
         sigNamesStr += Form(",%s", mcIt->GetName());
       }
     }
+    // the MC particles enter many pairs and triplets, so the signal decisions are cached per MC particle
+    for (auto const& sig : fRecMCSignals) {
+      sig->SetUseParticleCache(true);
+    }
     // Put all the reco MCSignal names in the vector for histogram naming
     std::unique_ptr<TObjArray> objArrayRecMCSignals(sigNamesStr.Tokenize(","));
     for (int i = 0; i < objArrayRecMCSignals->GetEntries(); i++) {
@@ -3597,11 +3630,20 @@ struct AnalysisAsymmetricPairing {
     }
   }
 
+  // Clear the MC signal decisions cached for the MC particles of the previous data frame
+  void resetMCSignalCaches()
+  {
+    for (auto const& sig : fRecMCSignals) {
+      sig->ResetParticleCache();
+    }
+  }
+
   // Template function to run same event pairing with asymmetric pairs (e.g. kaon-pion)
   template <bool TTwoProngFitter, int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, typename TEvents, typename TTrackAssocs, typename TTracks>
   void runAsymmetricPairing(TEvents const& events, Preslice<TTrackAssocs>& preslice, TTrackAssocs const& /*assocs*/, TTracks const& /*tracks*/, ReducedMCEvents const& /*mcEvents*/, ReducedMCTracks const& /*mcTracks*/)
   {
     fPairCount.clear();
+    resetMCSignalCaches();
 
     if (events.size() > 0) { // Additional protection to avoid crashing of events.begin().runNumber()
       if (fCurrentRun != events.begin().runNumber()) {
@@ -3861,6 +3903,7 @@ struct AnalysisAsymmetricPairing {
   template <bool TThreeProngFitter, uint32_t TEventFillMap, uint32_t TTrackFillMap, typename TEvents, typename TTrackAssocs, typename TTracks>
   void runThreeProng(TEvents const& events, Preslice<TTrackAssocs>& preslice, TTrackAssocs const& /*assocs*/, TTracks const& tracks, ReducedMCEvents const& /*mcEvents*/, ReducedMCTracks const& /*mcTracks*/, VarManager::PairCandidateType tripletType)
   {
+    resetMCSignalCaches();
     if (events.size() > 0) { // Additional protection to avoid crashing of events.begin().runNumber()
       if (fCurrentRun != events.begin().runNumber()) {
         initParamsFromCCDB(events.begin().timestamp(), true);
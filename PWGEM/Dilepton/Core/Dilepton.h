@@ -21,6 +21,7 @@
 #include "PWGEM/Dilepton/Core/DimuonCut.h"
 #include "PWGEM/Dilepton/Core/EMEventCut.h"
 #include "PWGEM/Dilepton/DataModel/dileptonTables.h"
+#include "PWGEM/Dilepton/Utils/BootstrapUtilities.h"
 #include "PWGEM/Dilepton/Utils/EMFwdTrack.h"
 #include "PWGEM/Dilepton/Utils/EMTrack.h"
 #include "PWGEM/Dilepton/Utils/EMTrackUtilities.h"
@@ -63,15 +64,14 @@
 #include <Math/Vector4Dfwd.h>
 #include <TH1.h>
 #include <TH2.h>
+#include <THnSparse.h>
 #include <TList.h>
-#include <TRandom3.h>
 #include <TString.h>
 
 #include <sys/types.h>
 
 #include <algorithm>
 #include <array>
-#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -690,6 +690,7 @@ struct Dilepton {
       fRegistry.addClone("Pair/mix/uls/", "Pair/mix/lspp/");
       fRegistry.addClone("Pair/mix/uls/", "Pair/mix/lsmm/");
       o2::aod::pwgem::dilepton::utils::eventhistogram::addEventHistogramsBootstrap(&fRegistry, cfgNumBootstrapSamples);
+      bootstrapSampler.setNSamples(cfgNumBootstrapSamples);
     } else if (cfgAnalysisType == static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonAnalysisType::kFlowV2EP) || cfgAnalysisType == static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonAnalysisType::kFlowV3EP)) {
       if (cfgAnalysisType == static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonAnalysisType::kFlowV2EP)) {
         nmod = 2;
@@ -880,7 +881,7 @@ struct Dilepton {
   }
 
   template <int ev_id, typename TCollision, typename TTrack1, typename TTrack2, typename TCut, typename TAllTracks>
-  bool fillPairInfo(TCollision const& collision, TTrack1 const& t1, TTrack2 const& t2, TCut const& cut, TAllTracks const&, const std::vector<float> weightvector)
+  bool fillPairInfo(TCollision const& collision, TTrack1 const& t1, TTrack2 const& t2, TCut const& cut, TAllTracks const&)
   {
     if constexpr (ev_id == 0) {
       if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
@@ -1133,14 +1134,15 @@ struct Dilepton {
         // LOGF(info, "collision.centFT0C() = %f, collision.trackOccupancyInTimeRange() = %d, getSPresolution = %f", collision.centFT0C(), collision.trackOccupancyInTimeRange(), getSPresolution(collision.centFT0C(), collision.trackOccupancyInTimeRange()));
 
         float sp = RecoDecay::dotProd(std::array<float, 2>{static_cast<float>(std::cos(nmod * v12.Phi())), static_cast<float>(std::sin(nmod * v12.Phi()))}, qvectors[nmod][cfgQvecEstimator]) / getSPresolution(collision.centFT0C(), collision.trackOccupancyInTimeRange());
-        for (int i = 0; i < cfgNumBootstrapSamples; i++) {
-          if (t1.sign() * t2.sign() < 0) { // ULS
-            fRegistry.fill(HIST("Pair/") + HIST(event_pair_types[ev_id]) + HIST("uls/hs"), v12.M(), v12.Pt(), pair_dca, v12.Rapidity(), sp, i + 0.5, weightvector.at(i));
-          } else if (t1.sign() > 0 && t2.sign() > 0) { // LS++
-            fRegistry.fill(HIST("Pair/") + HIST(event_pair_types[ev_id]) + HIST("lspp/hs"), v12.M(), v12.Pt(), pair_dca, v12.Rapidity(), sp, i + 0.5, weightvector.at(i));
-          } else if (t1.sign() < 0 && t2.sign() < 0) { // LS--
-            fRegistry.fill(HIST("Pair/") + HIST(event_pair_types[ev_id]) + HIST("lsmm/hs"), v12.M(), v12.Pt(), pair_dca, v12.Rapidity(), sp, i + 0.5, weightvector.at(i));
-          }
+        // counted once per pair, and added to the bootstrap samples at the end of the event
+        const double x[5] = {v12.M(), v12.Pt(), pair_dca, v12.Rapidity(), sp};
+        const THnSparse* hs = fRegistry.get<THnSparse>(HIST("Pair/same/uls/hs")).get(); // same binning for uls, lspp and lsmm
+        if (t1.sign() * t2.sign() < 0) { // ULS
+          bootstrapSampler.countPair(hs, o2::aod::pwgem::dilepton::utils::bootstrap::PairType::kULS, x);
+        } else if (t1.sign() > 0 && t2.sign() > 0) { // LS++
+          bootstrapSampler.countPair(hs, o2::aod::pwgem::dilepton::utils::bootstrap::PairType::kLSpp, x);
+        } else if (t1.sign() < 0 && t2.sign() < 0) { // LS--
+          bootstrapSampler.countPair(hs, o2::aod::pwgem::dilepton::utils::bootstrap::PairType::kLSmm, x);
         }
       } else if constexpr (ev_id == 1) {
         if (t1.sign() * t2.sign() < 0) { // ULS
@@ -1298,6 +1300,8 @@ struct Dilepton {
   std::vector<int> used_trackIds_per_col;
   int ndf = 0;
 
+  o2::aod::pwgem::dilepton::utils::bootstrap::BootstrapSampler bootstrapSampler;
+
   template <bool isTriggerAnalysis, typename TCollisions, typename TLeptons, typename TPresilce, typename TCut, typename TAllTracks>
   void runPairing(TCollisions const& collisions, TLeptons const& posTracks, TLeptons const& negTracks, TPresilce const& perCollision, TCut const& cut, TAllTracks const& tracks)
   {
@@ -1380,18 +1384,12 @@ struct Dilepton {
         }
       }
 
-      std::vector<float> bootstrapweights = {};
-      if (cfgAnalysisType == static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonAnalysisType::kBootstrapv2)) { // bootstrapping for accepted events
-        int randomSeed = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
-        TRandom3 randomNumber(randomSeed);
+      const bool doBootstrap = cfgAnalysisType == static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonAnalysisType::kBootstrapv2);
+      if (doBootstrap) { // bootstrapping for accepted events
+        bootstrapSampler.generateWeights(collision.runNumber(), collision.globalBC(), collision.posZ());
         for (int i = 0; i < cfgNumBootstrapSamples; i++) {
-          float poissonweight = 0.;
-          poissonweight = static_cast<float>(randomNumber.PoissonD(1.0));
-          bootstrapweights.push_back(poissonweight);
-          o2::aod::pwgem::dilepton::utils::eventhistogram::fillEventInfoBootstrap(&fRegistry, collision, i, poissonweight);
+          o2::aod::pwgem::dilepton::utils::eventhistogram::fillEventInfoBootstrap(&fRegistry, collision, i, bootstrapSampler.getWeight(i));
         }
-      } else {
-        bootstrapweights.push_back(1.0); // to pass as non-empyt dummy to use
       }
 
       if (nmod == 2) {
@@ -1414,23 +1412,28 @@ struct Dilepton {
       used_trackIds_per_col.reserve(posTracks_per_coll.size() + negTracks_per_coll.size());
       int nuls = 0, nlspp = 0, nlsmm = 0;
       for (const auto& [pos, neg] : combinations(o2::soa::CombinationsFullIndexPolicy(posTracks_per_coll, negTracks_per_coll))) { // ULS
-        bool is_pair_ok = fillPairInfo<0>(collision, pos, neg, cut, tracks, bootstrapweights);
+        bool is_pair_ok = fillPairInfo<0>(collision, pos, neg, cut, tracks);
         if (is_pair_ok) {
           nuls++;
         }
       }
       for (const auto& [pos1, pos2] : combinations(o2::soa::CombinationsStrictlyUpperIndexPolicy(posTracks_per_coll, posTracks_per_coll))) { // LS++
-        bool is_pair_ok = fillPairInfo<0>(collision, pos1, pos2, cut, tracks, bootstrapweights);
+        bool is_pair_ok = fillPairInfo<0>(collision, pos1, pos2, cut, tracks);
         if (is_pair_ok) {
           nlspp++;
         }
       }
       for (const auto& [neg1, neg2] : combinations(o2::soa::CombinationsStrictlyUpperIndexPolicy(negTracks_per_coll, negTracks_per_coll))) { // LS--
-        bool is_pair_ok = fillPairInfo<0>(collision, neg1, neg2, cut, tracks, bootstrapweights);
+        bool is_pair_ok = fillPairInfo<0>(collision, neg1, neg2, cut, tracks);
         if (is_pair_ok) {
           nlsmm++;
         }
       }
+      if (doBootstrap) {
+        bootstrapSampler.fillPairs(fRegistry.get<THnSparse>(HIST("Pair/same/uls/hs")).get(), o2::aod::pwgem::dilepton::utils::bootstrap::PairType::kULS);
+        bootstrapSampler.fillPairs(fRegistry.get<THnSparse>(HIST("Pair/same/lspp/hs")).get(), o2::aod::pwgem::dilepton::utils::bootstrap::PairType::kLSpp);
+        bootstrapSampler.fillPairs(fRegistry.get<THnSparse>(HIST("Pair/same/lsmm/hs")).get(), o2::aod::pwgem::dilepton::utils::bootstrap::PairType::kLSmm);
+      }
       used_trackIds_per_col.clear();
       used_trackIds_per_col.shrink_to_fit();
 
@@ -1508,25 +1511,25 @@ struct Dilepton {
 
         for (const auto& pos : selected_posTracks_in_this_event) { // ULS mix
           for (const auto& neg : negTracks_from_event_pool) {
-            fillPairInfo<1>(collision, pos, neg, cut, nullptr, bootstrapweights);
+            fillPairInfo<1>(collision, pos, neg, cut, nullptr);
           }
         }
 
         for (const auto& neg : selected_negTracks_in_this_event) { // ULS mix
           for (const auto& pos : posTracks_from_event_pool) {
-            fillPairInfo<1>(collision, neg, pos, cut, nullptr, bootstrapweights);
+            fillPairInfo<1>(collision, neg, pos, cut, nullptr);
           }
         }
 
         for (const auto& pos1 : selected_posTracks_in_this_event) { // LS++ mix
           for (const auto& pos2 : posTracks_from_event_pool) {
-            fillPairInfo<1>(collision, pos1, pos2, cut, nullptr, bootstrapweights);
+            fillPairInfo<1>(collision, pos1, pos2, cut, nullptr);
           }
         }
 
         for (const auto& neg1 : selected_negTracks_in_this_event) { // LS-- mix
           for (const auto& neg2 : negTracks_from_event_pool) {
-            fillPairInfo<1>(collision, neg1, neg2, cut, nullptr, bootstrapweights);
+            fillPairInfo<1>(collision, neg1, neg2, cut, nullptr);
           }
         }
       } // end of loop over mixed event pool
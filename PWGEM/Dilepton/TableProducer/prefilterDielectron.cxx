@@ -44,12 +44,14 @@
 #include <Math/Vector4D.h> // IWYU pragma: keep (do not replace with Math/Vector4Dfwd.h)
 #include <Math/Vector4Dfwd.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <tuple>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <math.h>
@@ -79,6 +81,7 @@ struct prefilterDielectron {
   Configurable<int> cfgCentEstimator{"cfgCentEstimator", 2, "FT0M:0, FT0A:1, FT0C:2"};
   Configurable<float> cfgCentMin{"cfgCentMin", -1, "min. centrality"};
   Configurable<float> cfgCentMax{"cfgCentMax", 999.f, "max. centrality"};
+  Configurable<bool> cfgFillQA{"cfgFillQA", true, "flag to fill pair histograms. If false, only the pairs which can be tagged are computed"};
 
   EMEventCut fEMEventCut;
   struct : ConfigurableGroup {
@@ -312,7 +315,7 @@ struct prefilterDielectron {
     } // end of PID ML
   }
 
-  std::unordered_map<int, uint16_t> map_pfb; // map track.globalIndex -> prefilter bit
+  std::vector<uint16_t> pfb; // prefilter bit per track, indexed by track.globalIndex()
 
   SliceCache cache;
   Preslice<MyTracks> perCollision_track = aod::emprimaryelectron::emeventId;
@@ -324,205 +327,232 @@ struct prefilterDielectron {
   Filter collisionFilter_occupancy_ft0c = eventcuts.cfgFT0COccupancyMin <= o2::aod::evsel::ft0cOccupancyInTimeRange && o2::aod::evsel::ft0cOccupancyInTimeRange < eventcuts.cfgFT0COccupancyMax;
   using FilteredMyCollisions = soa::Filtered<MyCollisions>;
 
-  void processPFB(FilteredMyCollisions const& collisions, MyTracks const& tracks)
+  // selected tracks of one collision and one sign, sorted in eta
+  struct SelectedTracks {
+    std::vector<int> globalIndex;
+    std::vector<float> pt, eta, phi;
+    std::vector<int8_t> sign;
+    std::vector<double> px, py, pz, p;
+
+    int size() const { return static_cast<int>(globalIndex.size()); }
+    void clear()
+    {
+      globalIndex.clear();
+      for (auto* v : {&pt, &eta, &phi}) {
+        v->clear();
+      }
+      sign.clear();
+      for (auto* v : {&px, &py, &pz, &p}) {
+        v->clear();
+      }
+    }
+  };
+  SelectedTracks selectedPosTracks;
+  SelectedTracks selectedNegTracks;
+
+  struct SelectedTrack {
+    float eta;
+    int globalIndex;
+    float pt;
+    float phi;
+    int8_t sign;
+  };
+  std::vector<SelectedTrack> sortedTracks;
+
+  template <typename TTracks>
+  void selectTracks(TTracks const& tracks, SelectedTracks& selected)
   {
+    sortedTracks.clear();
     for (const auto& track : tracks) {
-      map_pfb[track.globalIndex()] = 0;
-    } // end of track loop
-
-    for (const auto& collision : collisions) {
-      initCCDB(collision);
-      const float centralities[3] = {collision.centFT0M(), collision.centFT0A(), collision.centFT0C()};
-      bool is_cent_ok = true;
-      if (centralities[cfgCentEstimator] < cfgCentMin || cfgCentMax < centralities[cfgCentEstimator]) {
-        is_cent_ok = false;
+      if (fDielectronCut.IsSelectedTrack(track)) {
+        sortedTracks.push_back({track.eta(), static_cast<int>(track.globalIndex()), track.pt(), track.phi(), track.sign()});
       }
+    }
+    std::sort(sortedTracks.begin(), sortedTracks.end(), [](SelectedTrack const& a, SelectedTrack const& b) { return a.eta < b.eta; });
+
+    selected.clear();
+    for (const auto& track : sortedTracks) {
+      selected.globalIndex.emplace_back(track.globalIndex);
+      selected.pt.emplace_back(track.pt);
+      selected.eta.emplace_back(track.eta);
+      selected.phi.emplace_back(track.phi);
+      selected.sign.emplace_back(track.sign);
+      selected.px.emplace_back(track.pt * std::cos(track.phi));
+      selected.py.emplace_back(track.pt * std::sin(track.phi));
+      selected.pz.emplace_back(track.pt * std::sinh(track.eta));
+      selected.p.emplace_back(track.pt * std::cosh(track.eta));
+    }
+  }
 
-      auto posTracks_per_coll = posTracks->sliceByCached(o2::aod::emprimaryelectron::emeventId, collision.globalIndex(), cache);
-      auto negTracks_per_coll = negTracks->sliceByCached(o2::aod::emprimaryelectron::emeventId, collision.globalIndex(), cache);
+  static constexpr std::string_view pair_steps[2] = {"before/", "after/"};
+  static constexpr std::string_view pair_types[3] = {"uls/", "lspp/", "lsmm/"};
 
-      if (!fEMEventCut.IsSelected(collision) || !is_cent_ok) {
-        for (const auto& pos : posTracks_per_coll) {
-          map_pfb[pos.globalIndex()] = 0;
-        }
-        for (const auto& neg : negTracks_per_coll) {
-          map_pfb[neg.globalIndex()] = 0;
-        }
-        continue;
-      }
+  // full pair calculation, as for the tracks in the table: t1 is the positive track for ULS and the one with the smaller index for LS
+  template <int step, int pairtype>
+  uint16_t evaluatePair(SelectedTracks const& t1, int i, SelectedTracks const& t2, int j)
+  {
+    ROOT::Math::PtEtaPhiMVector v1(t1.pt[i], t1.eta[i], t1.phi[i], o2::constants::physics::MassElectron);
+    ROOT::Math::PtEtaPhiMVector v2(t2.pt[j], t2.eta[j], t2.phi[j], o2::constants::physics::MassElectron);
+    ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+    float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(v1.Px(), v1.Py(), v1.Pz(), v2.Px(), v2.Py(), v2.Pz(), t1.sign[i], t2.sign[j], d_bz);
+    float deta = t1.sign[i] * v1.Pt() > t2.sign[j] * v2.Pt() ? v1.Eta() - v2.Eta() : v2.Eta() - v1.Eta();
+    float dphi = t1.sign[i] * v1.Pt() > t2.sign[j] * v2.Pt() ? v1.Phi() - v2.Phi() : v2.Phi() - v1.Phi();
+    dphi = RecoDecay::constrainAngle(dphi, -M_PI, 1U); // -pi - +pi
+
+    if (cfgFillQA) {
+      fRegistry.fill(HIST("Pair/") + HIST(pair_steps[step]) + HIST(pair_types[pairtype]) + HIST("hMvsPhiV"), phiv, v12.M());
+      fRegistry.fill(HIST("Pair/") + HIST(pair_steps[step]) + HIST(pair_types[pairtype]) + HIST("hMvsPt"), v12.M(), v12.Pt());
+      fRegistry.fill(HIST("Pair/") + HIST(pair_steps[step]) + HIST(pair_types[pairtype]) + HIST("hDeltaEtaDeltaPhi"), dphi, deta);
+    }
 
-      // LOGF(info, "centrality = %f , posTracks_per_coll.size() = %d, negTracks_per_coll.size() = %d", centralities[cfgCentEstimator], posTracks_per_coll.size(), negTracks_per_coll.size());
+    uint16_t bits = 0;
+    if constexpr (step == 0 && pairtype == 0) {
+      if (dielectroncuts.cfg_min_mass < v12.M() && v12.M() < dielectroncuts.cfg_max_mass) {
+        bits |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kMee);
+      }
+      if (dielectroncuts.cfg_apply_phiv && ((v12.M() < dielectroncuts.cfg_phiv_slope * phiv + dielectroncuts.cfg_phiv_intercept) && (dielectroncuts.cfg_min_phiv < phiv && phiv < dielectroncuts.cfg_max_phiv))) {
+        bits |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kPhiV);
+      }
+      if (dielectroncuts.cfg_apply_detadphi_uls && std::pow(deta / dielectroncuts.cfg_min_deta_uls, 2) + std::pow(dphi / dielectroncuts.cfg_min_dphi_uls, 2) < 1.f) {
+        bits |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kSplitOrMergedTrackULS);
+      }
+    } else if constexpr (step == 0) {
+      if (dielectroncuts.cfg_apply_detadphi_ls && std::pow(deta / dielectroncuts.cfg_min_deta_ls, 2) + std::pow(dphi / dielectroncuts.cfg_min_dphi_ls, 2) < 1.f) {
+        bits |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kSplitOrMergedTrackLS);
+      }
+    }
+    return bits;
+  }
 
-      for (const auto& [pos, ele] : combinations(CombinationsFullIndexPolicy(posTracks_per_coll, negTracks_per_coll))) { // ULS
-        if (!fDielectronCut.IsSelectedTrack(pos) || !fDielectronCut.IsSelectedTrack(ele)) {
-          continue;
-        }
-        // don't apply pair cut when you produce prefilter bit.
-
-        ROOT::Math::PtEtaPhiMVector v1(pos.pt(), pos.eta(), pos.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v2(ele.pt(), ele.eta(), ele.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-        float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(v1.Px(), v1.Py(), v1.Pz(), v2.Px(), v2.Py(), v2.Pz(), pos.sign(), ele.sign(), d_bz);
-        float deta = pos.sign() * v1.Pt() > ele.sign() * v2.Pt() ? v1.Eta() - v2.Eta() : v2.Eta() - v1.Eta();
-        float dphi = pos.sign() * v1.Pt() > ele.sign() * v2.Pt() ? v1.Phi() - v2.Phi() : v2.Phi() - v1.Phi();
-        dphi = RecoDecay::constrainAngle(dphi, -M_PI, 1U); // -pi - +pi
-
-        fRegistry.fill(HIST("Pair/before/uls/hMvsPhiV"), phiv, v12.M());
-        fRegistry.fill(HIST("Pair/before/uls/hMvsPt"), v12.M(), v12.Pt());
-        fRegistry.fill(HIST("Pair/before/uls/hDeltaEtaDeltaPhi"), dphi, deta);
-
-        if (dielectroncuts.cfg_min_mass < v12.M() && v12.M() < dielectroncuts.cfg_max_mass) {
-          map_pfb[pos.globalIndex()] |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kMee);
-          map_pfb[ele.globalIndex()] |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kMee);
+  // Calls func(i, j) for the pairs of t1 x t2 (i < j if t1 and t2 are the same) which can pass the cuts:
+  // m_ee < maxMass, or |deta| < maxDeta and |dphi| < maxDphi (the box around the deta-dphi ellipse).
+  // The mass is bound from below by m_ee^2 >= 2 m_e^2 + 2 (p1 p2 - p1.p2) before the full calculation.
+  // Without mass cut, only the pairs within maxDeta are visited, in the eta-sorted tracks.
+  template <typename TFunc>
+  void forEachCandidatePair(SelectedTracks const& t1, SelectedTracks const& t2, float maxMass, float maxDeta, float maxDphi, TFunc const& func)
+  {
+    const bool sameTracks = &t1 == &t2;
+    if (cfgFillQA) { // all pairs for the histograms
+      for (int i = 0; i < t1.size(); i++) {
+        for (int j = sameTracks ? i + 1 : 0; j < t2.size(); j++) {
+          func(i, j);
         }
+      }
+      return;
+    }
 
-        if (dielectroncuts.cfg_apply_phiv && ((v12.M() < dielectroncuts.cfg_phiv_slope * phiv + dielectroncuts.cfg_phiv_intercept) && (dielectroncuts.cfg_min_phiv < phiv && phiv < dielectroncuts.cfg_max_phiv))) {
-          map_pfb[pos.globalIndex()] |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kPhiV);
-          map_pfb[ele.globalIndex()] |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kPhiV);
+    constexpr float margin = 1.0001f; // against rounding differences with the full calculation
+    auto isCloseInPhi = [&](int i, int j) {
+      return std::fabs(RecoDecay::constrainAngle(t1.phi[i] - t2.phi[j], -M_PI)) < maxDphi * margin;
+    };
+    if (maxMass > 0.f) {
+      const double maxMass2 = static_cast<double>(maxMass) * maxMass * margin;
+      const double mass2 = 2. * o2::constants::physics::MassElectron * o2::constants::physics::MassElectron;
+      for (int i = 0; i < t1.size(); i++) {
+        for (int j = sameTracks ? i + 1 : 0; j < t2.size(); j++) {
+          const double minMass2 = mass2 + 2. * (t1.p[i] * t2.p[j] - (t1.px[i] * t2.px[j] + t1.py[i] * t2.py[j] + t1.pz[i] * t2.pz[j]));
+          if (minMass2 < maxMass2 || (std::fabs(t1.eta[i] - t2.eta[j]) < maxDeta * margin && isCloseInPhi(i, j))) {
+            func(i, j);
+          }
         }
-
-        if (dielectroncuts.cfg_apply_detadphi_uls && std::pow(deta / dielectroncuts.cfg_min_deta_uls, 2) + std::pow(dphi / dielectroncuts.cfg_min_dphi_uls, 2) < 1.f) {
-          map_pfb[pos.globalIndex()] |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kSplitOrMergedTrackULS);
-          map_pfb[ele.globalIndex()] |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kSplitOrMergedTrackULS);
+      }
+    } else if (maxDeta > 0.f) {
+      int first = 0; // first track of t2 within maxDeta of track i
+      for (int i = 0; i < t1.size(); i++) {
+        while (first < t2.size() && t2.eta[first] <= t1.eta[i] - maxDeta * margin) {
+          first++;
+        }
+        for (int j = sameTracks ? i + 1 : first; j < t2.size() && t2.eta[j] < t1.eta[i] + maxDeta * margin; j++) {
+          if (isCloseInPhi(i, j)) {
+            func(i, j);
+          }
         }
+      }
+    }
+  }
 
-      } // end of ULS pairing
+  template <int step>
+  void runPairing()
+  {
+    const auto& pos = selectedPosTracks;
+    const auto& neg = selectedNegTracks;
 
-      for (const auto& [pos1, pos2] : combinations(CombinationsStrictlyUpperIndexPolicy(posTracks_per_coll, posTracks_per_coll))) { // LS++
-        if (!fDielectronCut.IsSelectedTrack(pos1) || !fDielectronCut.IsSelectedTrack(pos2)) {
-          continue;
-        }
-        // don't apply pair cut when you produce prefilter bit.
-
-        ROOT::Math::PtEtaPhiMVector v1(pos1.pt(), pos1.eta(), pos1.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v2(pos2.pt(), pos2.eta(), pos2.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-        float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(v1.Px(), v1.Py(), v1.Pz(), v2.Px(), v2.Py(), v2.Pz(), pos1.sign(), pos2.sign(), d_bz);
-        float deta = pos1.sign() * v1.Pt() > pos2.sign() * v2.Pt() ? v1.Eta() - v2.Eta() : v2.Eta() - v1.Eta();
-        float dphi = pos1.sign() * v1.Pt() > pos2.sign() * v2.Pt() ? v1.Phi() - v2.Phi() : v2.Phi() - v1.Phi();
-        dphi = RecoDecay::constrainAngle(dphi, -M_PI, 1U); // -pi - +pi
-
-        fRegistry.fill(HIST("Pair/before/lspp/hMvsPt"), v12.M(), v12.Pt());
-        fRegistry.fill(HIST("Pair/before/lspp/hMvsPhiV"), phiv, v12.M());
-        fRegistry.fill(HIST("Pair/before/lspp/hDeltaEtaDeltaPhi"), dphi, deta);
-
-        if (dielectroncuts.cfg_apply_detadphi_ls && std::pow(deta / dielectroncuts.cfg_min_deta_ls, 2) + std::pow(dphi / dielectroncuts.cfg_min_dphi_ls, 2) < 1.f) {
-          map_pfb[pos1.globalIndex()] |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kSplitOrMergedTrackLS);
-          map_pfb[pos2.globalIndex()] |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kSplitOrMergedTrackLS);
-        }
+    float maxMassULS = 0.f; // largest mass which can be tagged in ULS
+    if (step == 0 && dielectroncuts.cfg_max_mass.value > dielectroncuts.cfg_min_mass.value) {
+      maxMassULS = dielectroncuts.cfg_max_mass;
+    }
+    if (step == 0 && dielectroncuts.cfg_apply_phiv) {
+      const float minPhiv = std::max(dielectroncuts.cfg_min_phiv.value, 0.f);
+      const float maxPhiv = std::min(dielectroncuts.cfg_max_phiv.value, static_cast<float>(M_PI));
+      if (minPhiv < maxPhiv) {
+        maxMassULS = std::max({maxMassULS, dielectroncuts.cfg_phiv_slope * minPhiv + dielectroncuts.cfg_phiv_intercept, dielectroncuts.cfg_phiv_slope * maxPhiv + dielectroncuts.cfg_phiv_intercept});
+      }
+    }
+    const bool applyDetaDphiULS = step == 0 && dielectroncuts.cfg_apply_detadphi_uls;
+    const bool applyDetaDphiLS = step == 0 && dielectroncuts.cfg_apply_detadphi_ls;
 
-      } // end of LS++ pairing
+    forEachCandidatePair(pos, neg, maxMassULS, applyDetaDphiULS ? dielectroncuts.cfg_min_deta_uls.value : 0.f, dielectroncuts.cfg_min_dphi_uls.value, [&](int i, int j) { // ULS
+      if (step == 1 && (pfb[pos.globalIndex[i]] != 0 || pfb[neg.globalIndex[j]] != 0)) { // the pairs of tagged tracks are not used after the prefilter
+        return;
+      }
+      const uint16_t bits = evaluatePair<step, 0>(pos, i, neg, j);
+      pfb[pos.globalIndex[i]] |= bits;
+      pfb[neg.globalIndex[j]] |= bits;
+    });
 
-      for (const auto& [ele1, ele2] : combinations(CombinationsStrictlyUpperIndexPolicy(negTracks_per_coll, negTracks_per_coll))) { // LS--
-        if (!fDielectronCut.IsSelectedTrack(ele1) || !fDielectronCut.IsSelectedTrack(ele2)) {
-          continue;
-        }
-        // don't apply pair cut when you produce prefilter bit.
-
-        ROOT::Math::PtEtaPhiMVector v1(ele1.pt(), ele1.eta(), ele1.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v2(ele2.pt(), ele2.eta(), ele2.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-        float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(v1.Px(), v1.Py(), v1.Pz(), v2.Px(), v2.Py(), v2.Pz(), ele1.sign(), ele2.sign(), d_bz);
-        float deta = ele1.sign() * v1.Pt() > ele2.sign() * v2.Pt() ? v1.Eta() - v2.Eta() : v2.Eta() - v1.Eta();
-        float dphi = ele1.sign() * v1.Pt() > ele2.sign() * v2.Pt() ? v1.Phi() - v2.Phi() : v2.Phi() - v1.Phi();
-        dphi = RecoDecay::constrainAngle(dphi, -M_PI, 1U); // -pi - +pi
-
-        fRegistry.fill(HIST("Pair/before/lsmm/hMvsPt"), v12.M(), v12.Pt());
-        fRegistry.fill(HIST("Pair/before/lsmm/hMvsPhiV"), phiv, v12.M());
-        fRegistry.fill(HIST("Pair/before/lsmm/hDeltaEtaDeltaPhi"), dphi, deta);
-
-        if (dielectroncuts.cfg_apply_detadphi_ls && std::pow(deta / dielectroncuts.cfg_min_deta_ls, 2) + std::pow(dphi / dielectroncuts.cfg_min_dphi_ls, 2) < 1.f) {
-          map_pfb[ele1.globalIndex()] |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kSplitOrMergedTrackLS);
-          map_pfb[ele2.globalIndex()] |= 1 << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBitDerived::kSplitOrMergedTrackLS);
-        }
+    runPairingLS<step, 1>(pos, applyDetaDphiLS); // LS++
+    runPairingLS<step, 2>(neg, applyDetaDphiLS); // LS--
+  }
 
-      } // end of LS-- pairing
-    } // end of collision loop
+  template <int step, int pairtype>
+  void runPairingLS(SelectedTracks const& t, bool applyDetaDphi)
+  {
+    forEachCandidatePair(t, t, 0.f, applyDetaDphi ? dielectroncuts.cfg_min_deta_ls.value : 0.f, dielectroncuts.cfg_min_dphi_ls.value, [&](int i, int j) {
+      if (t.globalIndex[i] > t.globalIndex[j]) {
+        std::swap(i, j);
+      }
+      if (step == 1 && (pfb[t.globalIndex[i]] != 0 || pfb[t.globalIndex[j]] != 0)) {
+        return;
+      }
+      const uint16_t bits = evaluatePair<step, pairtype>(t, i, t, j);
+      pfb[t.globalIndex[i]] |= bits;
+      pfb[t.globalIndex[j]] |= bits;
+    });
+  }
 
-    for (const auto& track : tracks) {
-      // LOGF(info, "map_pfb[%d] = %d", track.globalIndex(), map_pfb[track.globalIndex()]);
-      pfb_derived(map_pfb[track.globalIndex()]);
-    } // end of track loop
+  void processPFB(FilteredMyCollisions const& collisions, MyTracks const& tracks)
+  {
+    pfb.assign(tracks.size(), 0);
 
-    // check pfb.
     for (const auto& collision : collisions) {
+      initCCDB(collision);
       const float centralities[3] = {collision.centFT0M(), collision.centFT0A(), collision.centFT0C()};
       if (centralities[cfgCentEstimator] < cfgCentMin || cfgCentMax < centralities[cfgCentEstimator]) {
         continue;
       }
-
-      auto posTracks_per_coll = posTracks->sliceByCached(o2::aod::emprimaryelectron::emeventId, collision.globalIndex(), cache);
-      auto negTracks_per_coll = negTracks->sliceByCached(o2::aod::emprimaryelectron::emeventId, collision.globalIndex(), cache);
-
       if (!fEMEventCut.IsSelected(collision)) {
         continue;
       }
 
-      for (const auto& [pos, ele] : combinations(CombinationsFullIndexPolicy(posTracks_per_coll, negTracks_per_coll))) { // ULS
-        if (!fDielectronCut.IsSelectedTrack(pos) || !fDielectronCut.IsSelectedTrack(ele)) {
-          continue;
-        }
-        if (map_pfb[pos.globalIndex()] != 0 || map_pfb[ele.globalIndex()] != 0) {
-          continue;
-        }
-
-        ROOT::Math::PtEtaPhiMVector v1(pos.pt(), pos.eta(), pos.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v2(ele.pt(), ele.eta(), ele.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-        float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(v1.Px(), v1.Py(), v1.Pz(), v2.Px(), v2.Py(), v2.Pz(), pos.sign(), ele.sign(), d_bz);
-        float deta = pos.sign() * v1.Pt() > ele.sign() * v2.Pt() ? v1.Eta() - v2.Eta() : v2.Eta() - v1.Eta();
-        float dphi = pos.sign() * v1.Pt() > ele.sign() * v2.Pt() ? v1.Phi() - v2.Phi() : v2.Phi() - v1.Phi();
-        dphi = RecoDecay::constrainAngle(dphi, -M_PI, 1U); // -pi - +pi
-
-        fRegistry.fill(HIST("Pair/after/uls/hMvsPhiV"), phiv, v12.M());
-        fRegistry.fill(HIST("Pair/after/uls/hMvsPt"), v12.M(), v12.Pt());
-        fRegistry.fill(HIST("Pair/after/uls/hDeltaEtaDeltaPhi"), dphi, deta);
-      }
-
-      for (const auto& [pos1, pos2] : combinations(CombinationsStrictlyUpperIndexPolicy(posTracks_per_coll, posTracks_per_coll))) { // LS++
-        if (!fDielectronCut.IsSelectedTrack(pos1) || !fDielectronCut.IsSelectedTrack(pos2)) {
-          continue;
-        }
-        if (map_pfb[pos1.globalIndex()] != 0 || map_pfb[pos2.globalIndex()] != 0) {
-          continue;
-        }
-
-        ROOT::Math::PtEtaPhiMVector v1(pos1.pt(), pos1.eta(), pos1.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v2(pos2.pt(), pos2.eta(), pos2.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-        float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(v1.Px(), v1.Py(), v1.Pz(), v2.Px(), v2.Py(), v2.Pz(), pos1.sign(), pos2.sign(), d_bz);
-        float deta = pos1.sign() * v1.Pt() > pos2.sign() * v2.Pt() ? v1.Eta() - v2.Eta() : v2.Eta() - v1.Eta();
-        float dphi = pos1.sign() * v1.Pt() > pos2.sign() * v2.Pt() ? v1.Phi() - v2.Phi() : v2.Phi() - v1.Phi();
-        dphi = RecoDecay::constrainAngle(dphi, -M_PI, 1U); // -pi - +pi
-
-        fRegistry.fill(HIST("Pair/after/lspp/hMvsPt"), v12.M(), v12.Pt());
-        fRegistry.fill(HIST("Pair/after/lspp/hMvsPhiV"), phiv, v12.M());
-        fRegistry.fill(HIST("Pair/after/lspp/hDeltaEtaDeltaPhi"), dphi, deta);
-      }
+      auto posTracks_per_coll = posTracks->sliceByCached(o2::aod::emprimaryelectron::emeventId, collision.globalIndex(), cache);
+      auto negTracks_per_coll = negTracks->sliceByCached(o2::aod::emprimaryelectron::emeventId, collision.globalIndex(), cache);
+      // LOGF(info, "centrality = %f , posTracks_per_coll.size() = %d, negTracks_per_coll.size() = %d", centralities[cfgCentEstimator], posTracks_per_coll.size(), negTracks_per_coll.size());
 
-      for (const auto& [ele1, ele2] : combinations(CombinationsStrictlyUpperIndexPolicy(negTracks_per_coll, negTracks_per_coll))) { // LS--
-        if (!fDielectronCut.IsSelectedTrack(ele1) || !fDielectronCut.IsSelectedTrack(ele2)) {
-          continue;
-        }
-        if (map_pfb[ele1.globalIndex()] != 0 || map_pfb[ele2.globalIndex()] != 0) {
-          continue;
-        }
+      selectTracks(posTracks_per_coll, selectedPosTracks);
+      selectTracks(negTracks_per_coll, selectedNegTracks);
 
-        ROOT::Math::PtEtaPhiMVector v1(ele1.pt(), ele1.eta(), ele1.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v2(ele2.pt(), ele2.eta(), ele2.phi(), o2::constants::physics::MassElectron);
-        ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-        float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(v1.Px(), v1.Py(), v1.Pz(), v2.Px(), v2.Py(), v2.Pz(), ele1.sign(), ele2.sign(), d_bz);
-        float deta = ele1.sign() * v1.Pt() > ele2.sign() * v2.Pt() ? v1.Eta() - v2.Eta() : v2.Eta() - v1.Eta();
-        float dphi = ele1.sign() * v1.Pt() > ele2.sign() * v2.Pt() ? v1.Phi() - v2.Phi() : v2.Phi() - v1.Phi();
-        dphi = RecoDecay::constrainAngle(dphi, -M_PI, 1U); // -pi - +pi
-
-        fRegistry.fill(HIST("Pair/after/lsmm/hMvsPt"), v12.M(), v12.Pt());
-        fRegistry.fill(HIST("Pair/after/lsmm/hMvsPhiV"), phiv, v12.M());
-        fRegistry.fill(HIST("Pair/after/lsmm/hDeltaEtaDeltaPhi"), dphi, deta);
+      // don't apply pair cut when you produce prefilter bit.
+      runPairing<0>();
+      if (cfgFillQA) { // check pfb. The bits of the tracks are final, since they are only set by pairs of the same collision.
+        runPairing<1>();
       }
-
     } // end of collision loop
-    map_pfb.clear();
+
+    for (const auto& track : tracks) {
+      // LOGF(info, "pfb[%d] = %d", track.globalIndex(), pfb[track.globalIndex()]);
+      pfb_derived(pfb[track.globalIndex()]);
+    } // end of track loop
+    pfb.clear();
   } // end of process
   PROCESS_SWITCH(prefilterDielectron, processPFB, "produce prefilter bit", false);
 
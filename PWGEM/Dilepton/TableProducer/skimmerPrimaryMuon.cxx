@@ -119,6 +119,7 @@ struct skimmerPrimaryMuon {
   int mRunNumber = 0;
   float mBz = 0;
   float mZShift = 0;
+  PropagatedMuonCache propagatedMuons; // the same tracks are propagated for each matching candidate and in both passes over the collisions
 
   HistogramRegistry fRegistry{"output", {}, OutputObjHandlingPolicy::AnalysisObject, false, false};
   static constexpr std::string_view muon_types[5] = {"MFTMCHMID/", "MFTMCHMIDOtherMatch/", "MFTMCH/", "MCHMID/", "MCH/"};
@@ -149,6 +150,7 @@ struct skimmerPrimaryMuon {
       return;
     }
     mRunNumber = bc.runNumber();
+    propagatedMuons.clear();
 
     std::map<std::string, std::string> metadata;
     auto soreor = o2::ccdb::BasicCCDBManager::getRunDuration(ccdbApi, mRunNumber);
@@ -278,7 +280,7 @@ struct skimmerPrimaryMuon {
       return false;
     }
 
-    o2::dataformats::GlobalFwdTrack propmuonAtPV = propagateMuon(fwdtrack, fwdtrack, collision, propagationPoint::kToVertex, matchingZ, mBz, mZShift);
+    o2::dataformats::GlobalFwdTrack propmuonAtPV = propagatedMuons.propagate(fwdtrack, fwdtrack, collision, propagationPoint::kToVertex, matchingZ, mBz, mZShift);
     float pt = propmuonAtPV.getPt();
     float eta = propmuonAtPV.getEta();
     float phi = propmuonAtPV.getPhi();
@@ -374,13 +376,13 @@ struct skimmerPrimaryMuon {
         return false;
       }
 
-      o2::dataformats::GlobalFwdTrack propmuonAtPV_Matched = propagateMuon(mchtrack, mchtrack, collision, propagationPoint::kToVertex, matchingZ, mBz, mZShift);
+      o2::dataformats::GlobalFwdTrack propmuonAtPV_Matched = propagatedMuons.propagate(mchtrack, mchtrack, collision, propagationPoint::kToVertex, matchingZ, mBz, mZShift);
       ptMatchedMCHMID = propmuonAtPV_Matched.getPt();
       etaMatchedMCHMID = propmuonAtPV_Matched.getEta();
       phiMatchedMCHMID = propmuonAtPV_Matched.getPhi();
       o2::math_utils::bringTo02Pi(phiMatchedMCHMID);
 
-      o2::dataformats::GlobalFwdTrack propmuonAtDCA_Matched = propagateMuon(mchtrack, mchtrack, collision, propagationPoint::kToDCA, matchingZ, mBz, mZShift);
+      o2::dataformats::GlobalFwdTrack propmuonAtDCA_Matched = propagatedMuons.propagate(mchtrack, mchtrack, collision, propagationPoint::kToDCA, matchingZ, mBz, mZShift);
       float dcaX_Matched = propmuonAtDCA_Matched.getX() - collision.posX();
       float dcaY_Matched = propmuonAtDCA_Matched.getY() - collision.posY();
       float dcaXY_Matched = std::sqrt(dcaX_Matched * dcaX_Matched + dcaY_Matched * dcaY_Matched);
@@ -388,7 +390,7 @@ struct skimmerPrimaryMuon {
 
       if constexpr (withMFTCov) {
         auto mfttrackcov = mftCovs.rawIteratorAt(map_mfttrackcovs[mfttrack.globalIndex()]);
-        auto muonAtMP = propagateMuon(mchtrack, mchtrack, collision, propagationPoint::kToMatchingPlane, matchingZ, mBz, mZShift); // propagated to matching plane
+        auto muonAtMP = propagatedMuons.propagate(mchtrack, mchtrack, collision, propagationPoint::kToMatchingPlane, matchingZ, mBz, mZShift); // propagated to matching plane
         o2::track::TrackParCovFwd mftsaAtMP = getTrackParCovFwdShift(mfttrack, mZShift, mfttrackcov);                              // values at innermost update
         mftsaAtMP.propagateToZhelix(matchingZ, mBz);                                                                               // propagated to matching plane
         // etaMatchedMFTatMP = mftsaAtMP.getEta();
@@ -435,12 +437,12 @@ struct skimmerPrimaryMuon {
         pt = propmuonAtPV_Matched.getP() * std::sin(2.f * std::atan(std::exp(-eta)));
       }
     } else if (fwdtrack.trackType() == o2::aod::fwdtrack::ForwardTrackTypeEnum::MuonStandaloneTrack) {
-      o2::dataformats::GlobalFwdTrack propmuonAtRabs = propagateMuon(fwdtrack, fwdtrack, collision, propagationPoint::kToRabs, matchingZ, mBz, mZShift); // this is necessary only for MuonStandaloneTrack
+      o2::dataformats::GlobalFwdTrack propmuonAtRabs = propagatedMuons.propagate(fwdtrack, fwdtrack, collision, propagationPoint::kToRabs, matchingZ, mBz, mZShift); // this is necessary only for MuonStandaloneTrack
       float xAbs = propmuonAtRabs.getX();
       float yAbs = propmuonAtRabs.getY();
       rAtAbsorberEnd = std::sqrt(xAbs * xAbs + yAbs * yAbs); // Redo propagation only for muon tracks // propagation of MFT tracks alredy done in reconstruction
 
-      o2::dataformats::GlobalFwdTrack propmuonAtDCA = propagateMuon(fwdtrack, fwdtrack, collision, propagationPoint::kToDCA, matchingZ, mBz, mZShift);
+      o2::dataformats::GlobalFwdTrack propmuonAtDCA = propagatedMuons.propagate(fwdtrack, fwdtrack, collision, propagationPoint::kToDCA, matchingZ, mBz, mZShift);
       cXX = propmuonAtDCA.getSigma2X();
       cYY = propmuonAtDCA.getSigma2Y();
       cXY = propmuonAtDCA.getSigmaXY();
@@ -755,6 +757,7 @@ struct skimmerPrimaryMuon {
     multiMapGLMuonsPerCollision.clear();
     map_mfttrackcovs.clear();
     vec_min_chi2MatchMCHMFT.clear();
+    propagatedMuons.clear();
     vec_min_chi2MatchMCHMFT.shrink_to_fit();
     map_diff_chi2MatchMCHMFT.clear();
   }
@@ -850,6 +853,7 @@ struct skimmerPrimaryMuon {
     mapAmb.clear();
     map_mfttrackcovs.clear();
     vec_min_chi2MatchMCHMFT.clear();
+    propagatedMuons.clear();
     vec_min_chi2MatchMCHMFT.shrink_to_fit();
     map_diff_chi2MatchMCHMFT.clear();
   }
@@ -1026,6 +1030,7 @@ struct skimmerPrimaryMuon {
     multiMapGLMuonsPerCollision.clear();
     map_mfttrackcovs.clear();
     vec_min_chi2MatchMCHMFT.clear();
+    propagatedMuons.clear();
     vec_min_chi2MatchMCHMFT.shrink_to_fit();
     map_diff_chi2MatchMCHMFT.clear();
   }
@@ -1120,6 +1125,7 @@ struct skimmerPrimaryMuon {
     mapAmb.clear();
     map_mfttrackcovs.clear();
     vec_min_chi2MatchMCHMFT.clear();
+    propagatedMuons.clear();
     vec_min_chi2MatchMCHMFT.shrink_to_fit();
     map_diff_chi2MatchMCHMFT.clear();
   }
@@ -1297,6 +1303,7 @@ struct skimmerPrimaryMuon {
     multiMapGLMuonsPerCollision.clear();
     map_mfttrackcovs.clear();
     vec_min_chi2MatchMCHMFT.clear();
+    propagatedMuons.clear();
     vec_min_chi2MatchMCHMFT.shrink_to_fit();
     map_diff_chi2MatchMCHMFT.clear();
   }
@@ -1394,6 +1401,7 @@ struct skimmerPrimaryMuon {
     mapAmb.clear();
     map_mfttrackcovs.clear();
     vec_min_chi2MatchMCHMFT.clear();
+    propagatedMuons.clear();
     vec_min_chi2MatchMCHMFT.shrink_to_fit();
     map_diff_chi2MatchMCHMFT.clear();
   }
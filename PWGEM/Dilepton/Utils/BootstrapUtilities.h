@@ -0,0 +1,123 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \bootstrap samples of same-event pairs with per-event poisson weights
+/// \author daiki.sekihata@cern.ch
+
+#ifndef PWGEM_DILEPTON_UTILS_BOOTSTRAPUTILITIES_H_
+#define PWGEM_DILEPTON_UTILS_BOOTSTRAPUTILITIES_H_
+
+#include <TAxis.h>
+#include <THnSparse.h>
+#include <TRandom3.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::aod::pwgem::dilepton::utils::bootstrap
+{
+enum class PairType : int {
+  kULS = 0,
+  kLSpp = 1,
+  kLSmm = 2,
+  kNPairTypes = 3,
+};
+
+// Reproducible seed for the bootstrap weights of a collision.
+// The key is the same for a given collision in every job processing the run, and differs between collisions:
+// the global BC identifies the collision in the run, and the z vertex separates collisions in the same BC.
+inline uint32_t getSeed(int runNumber, uint64_t globalBC, float posZ)
+{
+  uint32_t posZBits = 0;
+  std::memcpy(&posZBits, &posZ, sizeof(posZBits));
+  uint64_t key = static_cast<uint32_t>(runNumber);
+  for (const uint64_t value : {globalBC, static_cast<uint64_t>(posZBits)}) {
+    key ^= value + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    key ^= key >> 31;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 29;
+  }
+  const auto seed = static_cast<uint32_t>(key >> 32);
+  return seed != 0 ? seed : 1; // TRandom3 takes seed 0 as a request for a time-dependent seed
+}
+
+// Poisson weights of the current event, and number of same-event pairs per bin of the physics axes
+// (i.e. all axes of the pair THnSparse but the last one, which is the sample axis).
+class BootstrapSampler
+{
+ public:
+  void setNSamples(int nSamples) { mWeights.resize(nSamples); }
+  int getNSamples() const { return static_cast<int>(mWeights.size()); }
+
+  // draws the poisson weights of a collision
+  void generateWeights(int runNumber, uint64_t globalBC, float posZ)
+  {
+    mRandom.SetSeed(getSeed(runNumber, globalBC, posZ));
+    for (auto& weight : mWeights) {
+      weight = static_cast<float>(mRandom.PoissonD(1.0));
+    }
+  }
+  float getWeight(int sample) const { return mWeights[sample]; }
+
+  // counts a pair once, whatever the number of samples; hs only provides the binning
+  void countPair(const THnSparse* hs, PairType type, const double* x)
+  {
+    const int ndim = hs->GetNdimensions() - 1;
+    int64_t key = 0;
+    for (int d = 0; d < ndim; d++) {
+      const TAxis* axis = hs->GetAxis(d);
+      key = key * (axis->GetNbins() + 2) + axis->FindFixBin(x[d]);
+    }
+    mPairs[static_cast<int>(type)][key]++;
+  }
+
+  // Adds the pairs of the event to each sample: n pairs in a bin with a poisson weight w are equivalent to n fills with weight w.
+  void fillPairs(THnSparse* hs, PairType type)
+  {
+    auto& pairs = mPairs[static_cast<int>(type)];
+    const int ndim = hs->GetNdimensions() - 1;
+    mBins.resize(ndim + 1);
+    int64_t npairs = 0;
+    for (const auto& [key, n] : pairs) {
+      int64_t k = key;
+      for (int d = ndim - 1; d >= 0; d--) {
+        const int nbins = hs->GetAxis(d)->GetNbins() + 2;
+        mBins[d] = k % nbins;
+        k /= nbins;
+      }
+      for (int i = 0; i < getNSamples(); i++) {
+        const double w = mWeights[i];
+        if (w == 0.0) {
+          continue;
+        }
+        mBins[ndim] = i + 1;
+        const Long64_t bin = hs->GetBin(mBins.data(), true);
+        hs->AddBinContent(bin, w * n);
+        hs->AddBinError2(bin, w * w * n);
+      }
+      npairs += n;
+    }
+    hs->SetEntries(hs->GetEntries() + npairs * getNSamples());
+    pairs.clear();
+  }
+
+ private:
+  TRandom3 mRandom;
+  std::vector<float> mWeights;
+  std::array<std::unordered_map<int64_t, int>, static_cast<int>(PairType::kNPairTypes)> mPairs;
+  std::vector<int> mBins;
+};
+} // namespace o2::aod::pwgem::dilepton::utils::bootstrap
+
+#endif // PWGEM_DILEPTON_UTILS_BOOTSTRAPUTILITIES_H_
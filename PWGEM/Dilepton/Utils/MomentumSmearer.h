@@ -29,9 +29,13 @@
 #include <THnSparse.h>
 #include <TKey.h>
 #include <TObject.h>
+#include <TRandom.h>
 #include <TString.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <limits>
 #include <vector>
 
 class MomentumSmearer
@@ -144,43 +148,138 @@ class MomentumSmearer
 
   void fillVecResoND(THnSparseF* hs_reso)
   {
-    LOGP(info, "prepare TH3D");
+    LOGP(info, "prepare alias tables of the ND resolution maps");
     fNCenBins = hs_reso->GetAxis(0)->GetNbins();
     fNPtBins = hs_reso->GetAxis(1)->GetNbins();
     fNEtaBins = hs_reso->GetAxis(2)->GetNbins();
     fNPhiBins = hs_reso->GetAxis(3)->GetNbins();
     fNChBins = hs_reso->GetAxis(4)->GetNbins();
     LOGF(info, "ncen = %d, npt = %d, neta = %d, nphi = %d, nch = %d without under- and overflow bins", fNCenBins, fNPtBins, fNEtaBins, fNPhiBins, fNChBins);
-    // fVecResoND.reserve(npt * neta * nphi * nch);
-
-    fVecResoND.resize(fNCenBins, std::vector<std::vector<std::vector<std::vector<TH3D*>>>>(fNPtBins, std::vector<std::vector<std::vector<TH3D*>>>(fNEtaBins, std::vector<std::vector<TH3D*>>(fNPhiBins, std::vector<TH3D*>(fNChBins)))));
-    // fVecResoND.resize(fNPtBins, std::vector<std::vector<std::vector<TH3D*>>>(fNEtaBins, std::vector<std::vector<TH3D*>>(fNPhiBins, std::vector<TH3D*>(fNChBins))));
-    //  auto h3 = reinterpret_cast<TH3D*>(hs_reso->Projection(4, 5, 6));
-    //  h3->SetName(Form("h3reso_pt%d_eta%d_phi%d_ch%d", 0, 0, 0, 0));
-    //  fVecResoND[0][0][0][0] = h3;
-
-    for (int icen = 0; icen < fNCenBins; icen++) {
-      hs_reso->GetAxis(0)->SetRange(icen + 1, icen + 1);
-      for (int ipt = 0; ipt < fNPtBins; ipt++) {
-        hs_reso->GetAxis(1)->SetRange(ipt + 1, ipt + 1);
-        for (int ieta = 0; ieta < fNEtaBins; ieta++) {
-          hs_reso->GetAxis(2)->SetRange(ieta + 1, ieta + 1);
-          for (int iphi = 0; iphi < fNPhiBins; iphi++) {
-            hs_reso->GetAxis(3)->SetRange(iphi + 1, iphi + 1);
-            for (int ich = 0; ich < fNChBins; ich++) {
-              if (-0.5 < hs_reso->GetAxis(4)->GetBinCenter(ich + 1) && hs_reso->GetAxis(4)->GetBinCenter(ich + 1) < 0.5) {
-                continue;
-              }
-              hs_reso->GetAxis(4)->SetRange(ich + 1, ich + 1);
-              auto h3 = reinterpret_cast<TH3D*>(hs_reso->Projection(5, 6, 7));
-              h3->SetName(Form("h3reso_cen%d_pt%d_eta%d_phi%d_ch%d", icen, ipt, ieta, iphi, ich));
-              h3->Scale(1.f, "width"); // convert ntrack to probability density
-              fVecResoND[icen][ipt][ieta][iphi][ich] = h3;
-            } // end of charge loop
-          } // end of phi loop
-        } // end of eta loop
-      } // end of pt loop
-    } // end of centrality loop
+    for (int idim = 0; idim < 5; idim++) {
+      fResoNDAxes[idim].set(hs_reso->GetAxis(idim));
+    }
+    for (int idim = 0; idim < 3; idim++) {
+      const TAxis* axis = hs_reso->GetAxis(idim + 5);
+      fResoNDEdges[idim].resize(axis->GetNbins() + 1);
+      for (int ibin = 0; ibin <= axis->GetNbins(); ibin++) {
+        fResoNDEdges[idim][ibin] = axis->GetBinLowEdge(ibin + 1);
+      }
+    }
+    const int nx = fResoNDEdges[0].size() - 1;
+    const int ny = fResoNDEdges[1].size() - 1;
+    const int nz = fResoNDEdges[2].size() - 1;
+    const size_t nmaps = static_cast<size_t>(fNCenBins) * fNPtBins * fNEtaBins * fNPhiBins * fNChBins;
+
+    // one entry per filled bin of the sparse, with the content per unit volume as for the TH3 projections scaled by the bin width
+    struct Entry {
+      size_t map;
+      int32_t bin;
+      double weight;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(hs_reso->GetNbins());
+    std::vector<bool> invalid(nmaps, false);
+    const int nbins[8] = {fNCenBins, fNPtBins, fNEtaBins, fNPhiBins, fNChBins, nx, ny, nz};
+    std::array<int, 8> coord{};
+    for (Long64_t i = 0; i < hs_reso->GetNbins(); i++) {
+      const double content = hs_reso->GetBinContent(i, coord.data());
+      bool inRange = true;
+      for (int idim = 0; idim < 8; idim++) {
+        inRange = inRange && 1 <= coord[idim] && coord[idim] <= nbins[idim];
+      }
+      if (!inRange) {
+        continue;
+      }
+      const double center = hs_reso->GetAxis(4)->GetBinCenter(coord[4]);
+      if (-0.5 < center && center < 0.5) { // no map for neutral
+        continue;
+      }
+      const size_t map = (((static_cast<size_t>(coord[0] - 1) * fNPtBins + coord[1] - 1) * fNEtaBins + coord[2] - 1) * fNPhiBins + coord[3] - 1) * fNChBins + coord[4] - 1;
+      const int32_t bin = (coord[5] - 1) + nx * ((coord[6] - 1) + ny * (coord[7] - 1));
+      const double volume = (fResoNDEdges[0][coord[5]] - fResoNDEdges[0][coord[5] - 1]) * (fResoNDEdges[1][coord[6]] - fResoNDEdges[1][coord[6] - 1]) * (fResoNDEdges[2][coord[7]] - fResoNDEdges[2][coord[7] - 1]);
+      if (content < 0) {
+        invalid[map] = true; // TH3::GetRandom3 returns NaN for histograms with negative bins
+      } else if (content > 0) {
+        entries.push_back({map, bin, content / volume});
+      }
+    }
+    std::sort(entries.begin(), entries.end(), [](Entry const& a, Entry const& b) { return a.map < b.map || (a.map == b.map && a.bin < b.bin); });
+
+    fResoNDOffset.assign(nmaps + 1, 0);
+    fResoNDBin.resize(entries.size());
+    fResoNDProb.resize(entries.size());
+    fResoNDAlias.resize(entries.size());
+    fResoNDInvalid = invalid;
+    std::vector<double> scaled;
+    std::vector<int32_t> small, large;
+    size_t begin = 0;
+    for (size_t map = 0; map < nmaps; map++) {
+      size_t end = begin;
+      double integral = 0;
+      while (end < entries.size() && entries[end].map == map) {
+        integral += entries[end++].weight;
+      }
+      fResoNDOffset[map] = begin;
+      fResoNDOffset[map + 1] = end;
+
+      // Walker alias table (Vose)
+      const int32_t n = end - begin;
+      scaled.resize(n);
+      small.clear();
+      large.clear();
+      for (int32_t k = 0; k < n; k++) {
+        fResoNDBin[begin + k] = entries[begin + k].bin;
+        scaled[k] = entries[begin + k].weight * n / integral;
+        (scaled[k] < 1. ? small : large).push_back(k);
+      }
+      while (!small.empty() && !large.empty()) {
+        const int32_t s = small.back();
+        const int32_t l = large.back();
+        small.pop_back();
+        large.pop_back();
+        fResoNDProb[begin + s] = scaled[s];
+        fResoNDAlias[begin + s] = l;
+        scaled[l] = (scaled[l] + scaled[s]) - 1.;
+        (scaled[l] < 1. ? small : large).push_back(l);
+      }
+      for (const auto& stack : {&small, &large}) { // left over by rounding, probability 1
+        for (const auto& k : *stack) {
+          fResoNDProb[begin + k] = 1.f;
+          fResoNDAlias[begin + k] = k;
+        }
+      }
+      begin = end;
+    }
+    LOGP(info, "{} non-empty resolution bins in {} maps", entries.size(), nmaps);
+  }
+
+  // same distribution as TH3::GetRandom3 of the map: bin drawn from the alias table, then uniform inside the bin
+  void getRandomResoND(size_t map, double& dpt_rel, double& deta, double& dphi)
+  {
+    if (fResoNDInvalid[map]) {
+      dpt_rel = deta = dphi = std::numeric_limits<double>::quiet_NaN();
+      return;
+    }
+    const int64_t offset = fResoNDOffset[map];
+    const int64_t n = fResoNDOffset[map + 1] - offset;
+    if (n == 0) {
+      return;
+    }
+    const double u = gRandom->Rndm() * n;
+    int64_t k = std::min(static_cast<int64_t>(u), n - 1);
+    if (u - k >= fResoNDProb[offset + k]) {
+      k = fResoNDAlias[offset + k];
+    }
+    int32_t bin = fResoNDBin[offset + k];
+    std::array<int32_t, 3> ibin{};
+    for (int idim = 0; idim < 3; idim++) {
+      const int32_t nbins = fResoNDEdges[idim].size() - 1;
+      ibin[idim] = bin % nbins;
+      bin /= nbins;
+    }
+    dpt_rel = fResoNDEdges[0][ibin[0]] + (fResoNDEdges[0][ibin[0] + 1] - fResoNDEdges[0][ibin[0]]) * gRandom->Rndm();
+    deta = fResoNDEdges[1][ibin[1]] + (fResoNDEdges[1][ibin[1] + 1] - fResoNDEdges[1][ibin[1]]) * gRandom->Rndm();
+    dphi = fResoNDEdges[2][ibin[2]] + (fResoNDEdges[2][ibin[2] + 1] - fResoNDEdges[2][ibin[2]]) * gRandom->Rndm();
   }
 
   void init()
@@ -421,51 +520,15 @@ class MomentumSmearer
   void applySmearingND(const float centrality, const int ch, const float ptgen, const float etagen, const float phigen, float& ptsmeared, float& etasmeared, float& phismeared)
   {
     float ptgen_tmp = ptgen > fMinPtGen ? ptgen : fMinPtGen;
-    int cenbin = fResoND->GetAxis(0)->FindBin(centrality);
-    int ptbin = fResoND->GetAxis(1)->FindBin(ptgen_tmp);
-    int etabin = fResoND->GetAxis(2)->FindBin(etagen);
-    int phibin = fResoND->GetAxis(3)->FindBin(phigen);
-    int chbin = fResoND->GetAxis(4)->FindBin(ch);
-
-    // protection
-    if (cenbin < 1) {
-      cenbin = 1;
-    } else if (cenbin > fNCenBins) {
-      cenbin = fNCenBins;
-    }
-
-    // protection
-    if (ptbin < 1) {
-      ptbin = 1;
-    } else if (ptbin > fNPtBins) {
-      ptbin = fNPtBins;
-    }
-
-    // protection
-    if (etabin < 1) {
-      etabin = 1;
-    } else if (etabin > fNEtaBins) {
-      etabin = fNEtaBins;
-    }
-
-    // protection
-    if (phibin < 1) {
-      phibin = 1;
-    } else if (phibin > fNPhiBins) {
-      phibin = fNPhiBins;
-    }
-
-    // protection
-    if (chbin < 1) {
-      chbin = 1;
-    } else if (chbin > fNChBins) {
-      chbin = fNChBins;
-    }
+    // bins from 0, under- and overflow moved to the first and last bins
+    const size_t cenbin = fResoNDAxes[0].findClamped(centrality);
+    const size_t ptbin = fResoNDAxes[1].findClamped(ptgen_tmp);
+    const size_t etabin = fResoNDAxes[2].findClamped(etagen);
+    const size_t phibin = fResoNDAxes[3].findClamped(phigen);
+    const size_t chbin = fResoNDAxes[4].findClamped(ch);
 
     double dpt_rel = 0, deta = 0, dphi = 0;
-    if (fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1]->GetEntries() > 0) {
-      fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1]->GetRandom3(dpt_rel, deta, dphi);
-    }
+    getRandomResoND((((cenbin * fNPtBins + ptbin) * fNEtaBins + etabin) * fNPhiBins + phibin) * fNChBins + chbin, dpt_rel, deta, dphi);
     ptsmeared = ptgen - dpt_rel * ptgen;
     etasmeared = etagen - deta;
     phismeared = phigen - dphi;
@@ -627,7 +690,48 @@ class MomentumSmearer
   TH2F* fResoEta;
   TH2F* fResoPhi_Pos;
   TH2F* fResoPhi_Neg;
-  std::vector<std::vector<std::vector<std::vector<std::vector<TH3D*>>>>> fVecResoND;
+
+  // TAxis::FindFixBin, computed for equidistant bins
+  struct AxisLookup {
+    int nBins = 1;
+    double xMin = 0.;
+    double xMax = 1.;
+    std::vector<double> edges; // only for variable bins
+
+    void set(const TAxis* axis)
+    {
+      nBins = axis->GetNbins();
+      xMin = axis->GetXmin();
+      xMax = axis->GetXmax();
+      edges.clear();
+      if (axis->GetXbins()->GetSize() > 0) {
+        edges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + nBins + 1);
+      }
+    }
+    int findClamped(double x) const
+    {
+      int bin = 0;
+      if (x < xMin) {
+        bin = 0;
+      } else if (!(x < xMax)) {
+        bin = nBins + 1;
+      } else if (edges.empty()) {
+        bin = 1 + static_cast<int>(nBins * (x - xMin) / (xMax - xMin));
+      } else {
+        bin = std::upper_bound(edges.begin(), edges.end(), x) - edges.begin();
+      }
+      return std::clamp(bin, 1, nBins) - 1;
+    }
+  };
+
+  // ND resolution maps per (cen, pt, eta, phi, ch) bin, flattened: alias tables over the non-empty (dpt/pt, deta, dphi) bins
+  std::array<AxisLookup, 5> fResoNDAxes;
+  std::array<std::vector<double>, 3> fResoNDEdges; // edges of the dpt/pt, deta, dphi axes
+  std::vector<int64_t> fResoNDOffset;              // first entry of each map, nmaps + 1 entries
+  std::vector<int32_t> fResoNDBin;                 // (dpt/pt, deta, dphi) bin from 0, x fastest
+  std::vector<float> fResoNDProb;                  // probability to keep the bin instead of the alias
+  std::vector<int32_t> fResoNDAlias;               // alias within the map
+  std::vector<bool> fResoNDInvalid;                // maps with negative contents
   int fNCenBins = 1;
   int fNPtBins = 1;
   int fNEtaBins = 1;
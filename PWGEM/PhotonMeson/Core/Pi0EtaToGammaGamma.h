@@ -369,6 +369,182 @@ struct Pi0EtaToGammaGamma {
     }
   };
 
+  //---------------------------------------------------------------------------
+  // Photons of one event in a structure of arrays, converted once per event for the pair kernel
+  struct PhotonSoA {
+    std::vector<double> px, py, pz, e, pt; // four-momentum components as computed by ROOT::Math::PtEtaPhiMVector
+    std::vector<float> eta, phi;
+    std::vector<float> eAlpha; // energy used for the energy asymmetry
+    std::vector<float> weight; // photon weight
+    std::vector<int> globalIndex;
+
+    void add(float pt_, float eta_, float phi_, float mass, float eAlpha_, float weight_, int globalIndex_)
+    {
+      ROOT::Math::PtEtaPhiMVector v(pt_, eta_, phi_, mass);
+      px.emplace_back(v.Px());
+      py.emplace_back(v.Py());
+      pz.emplace_back(v.Pz());
+      e.emplace_back(v.E());
+      pt.emplace_back(v.Pt());
+      eta.emplace_back(eta_);
+      phi.emplace_back(phi_);
+      eAlpha.emplace_back(eAlpha_);
+      weight.emplace_back(weight_);
+      globalIndex.emplace_back(globalIndex_);
+    }
+
+    void clear()
+    {
+      px.clear();
+      py.clear();
+      pz.clear();
+      e.clear();
+      pt.clear();
+      eta.clear();
+      phi.clear();
+      eAlpha.clear();
+      weight.clear();
+      globalIndex.clear();
+    }
+
+    size_t size() const { return px.size(); }
+  };
+
+  // Pairs accepted by the pair kernel, filled into the histograms afterwards
+  struct PairSoA {
+    std::vector<double> mass, pt;
+    std::vector<float> weight;
+    std::vector<uint32_t> index2; // index of the second photon
+
+    void clear()
+    {
+      mass.clear();
+      pt.clear();
+      weight.clear();
+      index2.clear();
+    }
+
+    size_t size() const { return mass.size(); }
+  };
+
+  PhotonSoA photons1_soa;
+  PhotonSoA photons2_soa;
+  PairSoA pairs_soa;
+
+  /// \brief Select the photons of one collision and convert them into the structure of arrays
+  /// \tparam isSecond the photons are the second ones of the pair, cut as in the same-event pairing of runPairing
+  template <typename TDetectorTag1, typename TDetectorTag2, bool isSecond, typename TPhotons, typename TMatchedTracks, typename TMatchedSecondaries>
+  void selectPhotons(TPhotons const& photons, PhotonSoA& soa, TMatchedTracks const& matchedTracks, TMatchedSecondaries const& matchedSecondaries)
+  {
+    soa.clear();
+    for (const auto& g : photons) {
+      if constexpr (!isSecond) {
+        if constexpr (std::is_same_v<TDetectorTag1, EMCTag>) {
+          auto matchedTracks1 = matchedTracks.sliceByCached(TDetectorTag1::perClusterMT(), g.globalIndex(), cache);
+          auto matchedSecondaries1 = matchedSecondaries.sliceByCached(TDetectorTag1::perClusterMS(), g.globalIndex(), cache);
+          if (!TDetectorTag1::applyCut(*this, g, matchedTracks1, matchedSecondaries1)) {
+            continue;
+          }
+        } else {
+          if (!TDetectorTag1::applyCut(*this, g)) {
+            continue;
+          }
+        }
+      } else {
+        if constexpr (!std::is_same_v<TDetectorTag1, EMCTag>) {
+          if (!TDetectorTag2::applyCut(*this, g)) {
+            continue;
+          }
+        }
+        if constexpr (std::is_same_v<TDetectorTag2, EMCTag>) {
+          auto matchedTracks2 = matchedTracks.sliceByCached(TDetectorTag2::perClusterMT(), g.globalIndex(), cache);
+          auto matchedSecondaries2 = matchedSecondaries.sliceByCached(TDetectorTag2::perClusterMS(), g.globalIndex(), cache);
+          if (!TDetectorTag2::applyCut(*this, g, matchedTracks2, matchedSecondaries2)) {
+            continue;
+          }
+        } else {
+          if (!TDetectorTag2::applyCut(*this, g)) {
+            continue;
+          }
+        }
+      }
+
+      float w = 1.f;
+      if constexpr (requires { g.omegaMBWeight(); }) {
+        w = g.omegaMBWeight();
+      }
+      soa.add(g.pt(), g.eta(), g.phi(), 0.f, g.e(), w, g.globalIndex());
+    }
+  }
+
+  /// \brief Convert the photons (or dileptons) stored in the mixing pool into the structure of arrays
+  void convertPhotons(std::vector<o2::aod::pwgem::photonmeson::utils::EMPhoton> const& photons, PhotonSoA& soa)
+  {
+    soa.clear();
+    for (const auto& g : photons) {
+      // as photon has mass= 0 e = p
+      soa.add(g.pt(), g.eta(), g.phi(), g.mass(), g.p(), 1.f, -1);
+    }
+  }
+
+  /// \brief Pair kernel: combine photon i of photons1 with the photons [jmin, size) of photons2
+  /// and append the pairs passing the rapidity and energy asymmetry cuts to pairs_soa
+  void combinePhotons(PhotonSoA const& photons1, size_t i, PhotonSoA const& photons2, size_t jmin, float weight, bool applyAlphaCut)
+  {
+    const auto alphaOption = applyAlphaCut ? static_cast<AlphaMesonCutOption>(cfgAlphaMesonCut.value) : AlphaMesonCutOption::Off;
+    const float alphaValue = cfgAlphaMeson;
+    const float alphaA = cfgAlphaMesonA;
+    const float alphaB = cfgAlphaMesonB;
+    const float ymax = maxY;
+    const double px1 = photons1.px[i], py1 = photons1.py[i], pz1 = photons1.pz[i], e1 = photons1.e[i];
+    const float eAlpha1 = photons1.eAlpha[i];
+    const float weight1 = weight * photons1.weight[i];
+
+    for (size_t j = jmin; j < photons2.size(); j++) {
+      // same components, mass and pT as the sum of the two PtEtaPhiMVector
+      ROOT::Math::PxPyPzEVector v12(px1 + photons2.px[j], py1 + photons2.py[j], pz1 + photons2.pz[j], e1 + photons2.e[j]);
+      if (std::fabs(v12.Rapidity()) > ymax) {
+        continue;
+      }
+
+      const double pt12 = v12.Pt();
+      if (alphaOption != AlphaMesonCutOption::Off) {
+        float alphaMeson = std::fabs(eAlpha1 - photons2.eAlpha[j]) / (eAlpha1 + photons2.eAlpha[j]);
+        float alphaCut = 999.f;
+        switch (alphaOption) {
+          case AlphaMesonCutOption::SpecificValue:
+            alphaCut = alphaValue;
+            break;
+          case AlphaMesonCutOption::PTDependent:
+            alphaCut = alphaA * std::tanh(alphaB * pt12);
+            break;
+          default:
+            break;
+        }
+        if (alphaMeson > alphaCut) {
+          continue;
+        }
+      }
+
+      pairs_soa.mass.emplace_back(v12.M());
+      pairs_soa.pt.emplace_back(pt12);
+      pairs_soa.weight.emplace_back(weight1 * photons2.weight[j]);
+      pairs_soa.index2.emplace_back(j);
+    }
+  }
+
+  /// \brief Fill the pairs of the photons of the current event with the photons of one event from the mixing pool
+  void fillMixedPairs(PhotonSoA const& photons1, PhotonSoA const& photons2, float weight, bool applyAlphaCut)
+  {
+    pairs_soa.clear();
+    for (size_t i = 0; i < photons1.size(); i++) {
+      combinePhotons(photons1, i, photons2, 0, weight, applyAlphaCut);
+    }
+    for (size_t k = 0; k < pairs_soa.size(); k++) {
+      fRegistry.fill(HIST("Pair/mix/hs"), pairs_soa.mass[k], pairs_soa.pt[k], pairs_soa.weight[k]);
+    }
+  }
+
   void init(o2::framework::InitContext&)
   {
     zvtx_bin_edges = std::vector<float>(ConfVtxBins.value.begin(), ConfVtxBins.value.end());
@@ -384,6 +560,10 @@ struct Pi0EtaToGammaGamma {
     occ_bin_edges = std::vector<float>(ConfOccupancyBins.value.begin(), ConfOccupancyBins.value.end());
     occ_bin_edges.erase(occ_bin_edges.begin());
 
+    if (cfgAlphaMesonCut < static_cast<int>(AlphaMesonCutOption::Off) || static_cast<int>(AlphaMesonCutOption::PTDependent) < cfgAlphaMesonCut) {
+      LOGF(error, "Invalid option for alpha meson cut. No alpha cut will be applied.");
+    }
+
     emh1 = new o2::aod::pwgem::dilepton::utils::EventMixingHandler<std::tuple<int, int, int, int>, std::pair<int, int>, o2::aod::pwgem::photonmeson::utils::EMPhoton>(ndepth);
     emh2 = new o2::aod::pwgem::dilepton::utils::EventMixingHandler<std::tuple<int, int, int, int>, std::pair<int, int>, o2::aod::pwgem::photonmeson::utils::EMPhoton>(ndepth);
 
@@ -855,82 +1035,33 @@ struct Pi0EtaToGammaGamma {
           } // end of dielectron loop
         } // end of g1 loop
       } else { // PCM-PCM, EMC-EMC, PHOS-PHOS, PCM-EMC and PCM-PHOS.
+        constexpr bool isSameKind = std::is_same_v<TDetectorTag1, TDetectorTag2>; // same table, pairs with strictly upper index
         auto photons1_per_collision = photons1.sliceByCached(TDetectorTag1::perCollision(), collision.globalIndex(), cache);
-        auto photons2_per_collision = photons2.sliceByCached(TDetectorTag2::perCollision(), collision.globalIndex(), cache);
-
-        for (const auto& [g1, g2] : o2::soa::combinations(TCombinationPolicy(photons1_per_collision, photons2_per_collision))) {
-          if constexpr (std::is_same_v<TDetectorTag1, EMCTag>) {
-            // For the EMCal case we need to get the primary and secondary matched tracks
-            auto matchedTracks1 = matchedTracks.sliceByCached(TDetectorTag1::perClusterMT(), g1.globalIndex(), cache);
-            auto matchedSecondaries1 = matchedSecondaries.sliceByCached(TDetectorTag1::perClusterMS(), g1.globalIndex(), cache);
-
-            if (!TDetectorTag1::applyCut(*this, g1, matchedTracks1, matchedSecondaries1)) {
-              continue;
-            }
-          } else {
-            if (!TDetectorTag1::applyCut(*this, g1) || !TDetectorTag2::applyCut(*this, g2)) {
-              continue;
-            }
-          }
-
-          if constexpr (std::is_same_v<TDetectorTag2, EMCTag>) {
-            auto matchedTracks2 = matchedTracks.sliceByCached(TDetectorTag2::perClusterMT(), g2.globalIndex(), cache);
-            auto matchedSecondaries2 = matchedSecondaries.sliceByCached(TDetectorTag2::perClusterMS(), g2.globalIndex(), cache);
-            if (!TDetectorTag2::applyCut(*this, g2, matchedTracks2, matchedSecondaries2)) {
-              continue;
-            }
-          } else {
-            if (!TDetectorTag2::applyCut(*this, g2)) {
-              continue;
+        selectPhotons<TDetectorTag1, TDetectorTag2, false>(photons1_per_collision, photons1_soa, matchedTracks, matchedSecondaries);
+        if constexpr (!isSameKind) {
+          auto photons2_per_collision = photons2.sliceByCached(TDetectorTag2::perCollision(), collision.globalIndex(), cache);
+          selectPhotons<TDetectorTag1, TDetectorTag2, true>(photons2_per_collision, photons2_soa, matchedTracks, matchedSecondaries);
+        }
+        const auto& photons2_selected = isSameKind ? photons1_soa : photons2_soa;
+
+        for (size_t i = 0; i < photons1_soa.size(); i++) {
+          pairs_soa.clear();
+          combinePhotons(photons1_soa, i, photons2_selected, isSameKind ? i + 1 : 0, weight, true);
+
+          for (size_t k = 0; k < pairs_soa.size(); k++) {
+            fRegistry.fill(HIST("Pair/same/hs"), pairs_soa.mass[k], pairs_soa.pt[k], pairs_soa.weight[k]);
+
+            const auto j = pairs_soa.index2[k];
+            if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), photons1_soa.globalIndex[i]) == used_photonIds_per_col.end()) {
+              emh1->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::photonmeson::utils::EMPhoton(photons1_soa.pt[i], photons1_soa.eta[i], photons1_soa.phi[i], 0));
+              used_photonIds_per_col.emplace_back(photons1_soa.globalIndex[i]);
             }
-          }
-
-          ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-          ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-          if (std::fabs(v12.Rapidity()) > maxY) {
-            continue;
-          }
-
-          float alphaMeson = std::fabs(g1.e() - g2.e()) / (g1.e() + g2.e());
-          float alphaCut = 999.f;
-          switch (static_cast<AlphaMesonCutOption>(cfgAlphaMesonCut.value)) {
-            case AlphaMesonCutOption::Off:
-              break;
-            case AlphaMesonCutOption::SpecificValue:
-              alphaCut = cfgAlphaMeson;
-              break;
-            case AlphaMesonCutOption::PTDependent: {
-              alphaCut = cfgAlphaMesonA * std::tanh(cfgAlphaMesonB * v12.pt());
-              break;
+            if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), photons2_selected.globalIndex[j]) == used_photonIds_per_col.end()) {
+              emh2->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::photonmeson::utils::EMPhoton(photons2_selected.pt[j], photons2_selected.eta[j], photons2_selected.phi[j], 0));
+              used_photonIds_per_col.emplace_back(photons2_selected.globalIndex[j]);
             }
-            default:
-              LOGF(error, "Invalid option for alpha meson cut. No alpha cut will be applied.");
-          }
-          if (alphaMeson > alphaCut) {
-            continue;
-          }
-
-          float wpair = weight;
-
-          if constexpr (requires { g1.omegaMBWeight(); }) {
-            wpair *= g1.omegaMBWeight();
-          }
-          if constexpr (requires { g2.omegaMBWeight(); }) {
-            wpair *= g2.omegaMBWeight();
-          }
-
-          fRegistry.fill(HIST("Pair/same/hs"), v12.M(), v12.Pt(), wpair);
-
-          if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), g1.globalIndex()) == used_photonIds_per_col.end()) {
-            emh1->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::photonmeson::utils::EMPhoton(g1.pt(), g1.eta(), g1.phi(), 0));
-            used_photonIds_per_col.emplace_back(g1.globalIndex());
-          }
-          if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), g2.globalIndex()) == used_photonIds_per_col.end()) {
-            emh2->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::photonmeson::utils::EMPhoton(g2.pt(), g2.eta(), g2.phi(), 0));
-            used_photonIds_per_col.emplace_back(g2.globalIndex());
+            ndiphoton++;
           }
-          ndiphoton++;
         } // end of pairing loop
       } // end of pairing in same event
 
@@ -952,6 +1083,7 @@ struct Pi0EtaToGammaGamma {
       auto collisionIds2_in_mixing_pool = emh2->GetCollisionIdsFromEventPool(key_bin);
 
       if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMPCM || pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPHOSPHOS || pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kEMCEMC) { // same kinds pairing
+        convertPhotons(selected_photons1_in_this_event, photons1_soa);
         for (const auto& mix_dfId_collisionId : collisionIds1_in_mixing_pool) {
           int mix_dfId = mix_dfId_collisionId.first;
           int64_t mix_collisionId = mix_dfId_collisionId.second;
@@ -969,41 +1101,13 @@ struct Pi0EtaToGammaGamma {
 
           auto photons1_from_event_pool = emh1->GetTracksPerCollision(mix_dfId_collisionId);
           // LOGF(info, "Do event mixing: current event (%d, %d), ngamma = %d | event pool (%d, %d), ngamma = %d", ndf, collision.globalIndex(), selected_photons1_in_this_event.size(), mix_dfId, mix_collisionId, photons1_from_event_pool.size());
-
-          for (const auto& g1 : selected_photons1_in_this_event) {
-            for (const auto& g2 : photons1_from_event_pool) {
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (std::fabs(v12.Rapidity()) > maxY) {
-                continue;
-              }
-              // as photon has mass= 0 e = p
-              float alphaMeson = std::fabs(g1.p() - g2.p()) / (g1.p() + g2.p());
-              float alphaCut = 999.f;
-              switch (static_cast<AlphaMesonCutOption>(cfgAlphaMesonCut.value)) {
-                case AlphaMesonCutOption::Off:
-                  break;
-                case AlphaMesonCutOption::SpecificValue:
-                  alphaCut = cfgAlphaMeson;
-                  break;
-                case AlphaMesonCutOption::PTDependent: {
-                  alphaCut = cfgAlphaMesonA * std::tanh(cfgAlphaMesonB * v12.pt());
-                  break;
-                }
-                default:
-                  LOGF(error, "Invalid option for alpha meson cut. No alpha cut will be applied.");
-              }
-              if (alphaMeson > alphaCut) {
-                continue;
-              }
-
-              fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
-            }
-          }
+          convertPhotons(photons1_from_event_pool, photons2_soa);
+          fillMixedPairs(photons1_soa, photons2_soa, weight, true);
         } // end of loop over mixed event pool
 
       } else { // [photon1 from event1, photon2 from event2] and [photon1 from event2, photon2 from event1]
+        // the dileptons of PCM-DalitzEE are stored in the pool with their mass
+        convertPhotons(selected_photons1_in_this_event, photons1_soa);
         for (const auto& mix_dfId_collisionId : collisionIds2_in_mixing_pool) {
           int mix_dfId = mix_dfId_collisionId.first;
           int64_t mix_collisionId = mix_dfId_collisionId.second;
@@ -1021,22 +1125,10 @@ struct Pi0EtaToGammaGamma {
 
           auto photons2_from_event_pool = emh2->GetTracksPerCollision(mix_dfId_collisionId);
           // LOGF(info, "Do event mixing: current event (%d, %d), ngamma = %d | event pool (%d, %d), nll = %d", ndf, collision.globalIndex(), selected_photons1_in_this_event.size(), mix_dfId, mix_collisionId, photons2_from_event_pool.size());
-
-          for (const auto& g1 : selected_photons1_in_this_event) {
-            for (const auto& g2 : photons2_from_event_pool) {
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMDalitzEE) { //[photon from event1, dilepton from event2] and [photon from event2, dilepton from event1]
-                v2.SetM(g2.mass());
-              }
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (std::fabs(v12.Rapidity()) > maxY) {
-                continue;
-              }
-              fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
-            }
-          }
+          convertPhotons(photons2_from_event_pool, photons2_soa);
+          fillMixedPairs(photons1_soa, photons2_soa, weight, false);
         } // end of loop over mixed event pool
+        convertPhotons(selected_photons2_in_this_event, photons2_soa);
         for (const auto& mix_dfId_collisionId : collisionIds1_in_mixing_pool) {
           int mix_dfId = mix_dfId_collisionId.first;
           int64_t mix_collisionId = mix_dfId_collisionId.second;
@@ -1054,24 +1146,10 @@ struct Pi0EtaToGammaGamma {
 
           auto photons1_from_event_pool = emh1->GetTracksPerCollision(mix_dfId_collisionId);
           // LOGF(info, "Do event mixing: current event (%d, %d), nll = %d | event pool (%d, %d), ngamma = %d", ndf, collision.globalIndex(), selected_photons2_in_this_event.size(), mix_dfId, mix_collisionId, photons1_from_event_pool.size());
-
-          for (const auto& g1 : selected_photons2_in_this_event) {
-            for (const auto& g2 : photons1_from_event_pool) {
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMDalitzEE) { //[photon from event1, dilepton from event2] and [photon from event2, dilepton from event1]
-                v1.SetM(g1.mass());
-              }
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (std::fabs(v12.Rapidity()) > maxY) {
-                continue;
-              }
-              fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
-            }
-          }
+          convertPhotons(photons1_from_event_pool, photons1_soa);
+          fillMixedPairs(photons2_soa, photons1_soa, weight, false);
         } // end of loop over mixed event pool
       }
-
       if (ndiphoton > 0) {
         emh1->AddCollisionIdAtLast(key_bin, key_df_collision);
         emh2->AddCollisionIdAtLast(key_bin, key_df_collision);
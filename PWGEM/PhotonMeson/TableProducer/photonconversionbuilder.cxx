@@ -66,10 +66,13 @@
 #include <array>
 #include <cmath>
 #include <cstdint>
-#include <map>
+#include <limits>
+#include <numeric>
 #include <set>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -770,8 +773,9 @@ struct PhotonConversionBuilder {
     if (!checkAP(v0photoncandidate.getAlpha(), v0photoncandidate.getQt(), max_alpha_ap, max_qt_ap)) { // store only photon conversions
       return;
     }
-    pca_map[std::make_tuple(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())] = v0photoncandidate.getPCA();
-    cospa_map[std::make_tuple(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())] = v0photoncandidate.getCosPA();
+    if (!filltable) { // candidates for the arbitration
+      v0Candidates.add(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex(), v0photoncandidate.getPCA(), v0photoncandidate.getCosPA());
+    }
 
     if (applyPCMMl) {
       bool isSelectedML = false;
@@ -868,12 +872,127 @@ struct PhotonConversionBuilder {
   }
 
   Preslice<aod::V0s> perCollision = o2::aod::v0::collisionId;
-  std::map<std::tuple<int64_t, int64_t, int64_t, int64_t>, float> pca_map;      // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex()) -> pca
-  std::map<std::tuple<int64_t, int64_t, int64_t, int64_t>, float> cospa_map;    // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex()) -> cospa
-  std::vector<std::pair<int64_t, int64_t>> stored_v0Ids;                        // (pos.globalIndex(), ele.globalIndex())
+
+  // photon candidates of the DF before arbitration
+  struct V0Candidates {
+    std::vector<int64_t> v0Id;        // v0.globalIndex()
+    std::vector<int64_t> collisionId; // collision.globalIndex()
+    std::vector<int64_t> posId;       // pos.globalIndex()
+    std::vector<int64_t> eleId;       // ele.globalIndex()
+    std::vector<float> pca;
+    std::vector<float> cospa;
+
+    size_t size() const { return v0Id.size(); }
+    void add(int64_t v0, int64_t collision, int64_t pos, int64_t ele, float v0pca, float v0cospa)
+    {
+      v0Id.emplace_back(v0);
+      collisionId.emplace_back(collision);
+      posId.emplace_back(pos);
+      eleId.emplace_back(ele);
+      pca.emplace_back(v0pca);
+      cospa.emplace_back(v0cospa);
+    }
+    void clear()
+    {
+      for (auto* ids : {&v0Id, &collisionId, &posId, &eleId}) {
+        ids->clear();
+        ids->shrink_to_fit();
+      }
+      for (auto* values : {&pca, &cospa}) {
+        values->clear();
+        values->shrink_to_fit();
+      }
+    }
+  } v0Candidates;
+
   std::vector<std::tuple<int64_t, int64_t, int64_t, int64_t>> stored_fullv0Ids; // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())
   std::unordered_map<int64_t, int> nv0_map;                                     // map collisionId -> nv0
 
+  // Selects the photon candidates in v0Id order: a candidate is rejected if another one sharing a leg has a smaller pca,
+  // or if the same pair of legs attached to another collision has a larger cospa. Only the first accepted candidate of a pair of legs is stored.
+  // Each condition is evaluated on the candidates sorted by the corresponding key, in one sweep per group.
+  void arbitrateV0Candidates()
+  {
+    const auto& c = v0Candidates;
+    const size_t n = c.size();
+    std::vector<size_t> order(n);
+    std::vector<bool> rejected(n, false);
+
+    // sorts the candidates by key and calls fillGroup(begin, end) for each range of equal keys in order
+    auto forEachGroup = [&](auto const& less, auto const& fillGroup) {
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), less);
+      for (size_t begin = 0, end = 0; begin < n; begin = end) {
+        for (end = begin + 1; end < n && !less(order[begin], order[end]); end++) {
+        }
+        fillGroup(begin, end);
+      }
+    };
+
+    // closest v0: pca_i > pca_j for any j sharing a leg <=> pca_i > min(pca_j) over the leg (NaN never compares larger)
+    auto rejectLargerPCA = [&](std::vector<int64_t> const& legIds) {
+      forEachGroup([&](size_t a, size_t b) { return legIds[a] < legIds[b]; },
+                   [&](size_t begin, size_t end) {
+                     float minPCA = std::numeric_limits<float>::infinity();
+                     for (size_t k = begin; k < end; k++) {
+                       if (c.pca[order[k]] < minPCA) {
+                         minPCA = c.pca[order[k]];
+                       }
+                     }
+                     for (size_t k = begin; k < end; k++) {
+                       if (c.pca[order[k]] > minPCA) {
+                         rejected[order[k]] = true;
+                       }
+                     }
+                   });
+    };
+    rejectLargerPCA(c.posId);
+    rejectLargerPCA(c.eleId);
+
+    // most aligned v0: for each pair of legs, keep the largest cospa and the largest cospa of the other collisions
+    forEachGroup([&](size_t a, size_t b) { return std::tie(c.posId[a], c.eleId[a]) < std::tie(c.posId[b], c.eleId[b]); },
+                 [&](size_t begin, size_t end) {
+                   float maxCosPA = -std::numeric_limits<float>::infinity();
+                   int64_t maxCollisionId = -1;
+                   float maxCosPAOtherCollisions = -std::numeric_limits<float>::infinity(); // collisions != maxCollisionId
+                   for (size_t k = begin; k < end; k++) {
+                     const float cospa = c.cospa[order[k]];
+                     const int64_t collisionId = c.collisionId[order[k]];
+                     if (cospa > maxCosPA) {
+                       if (collisionId != maxCollisionId) {
+                         maxCosPAOtherCollisions = maxCosPA;
+                       }
+                       maxCosPA = cospa;
+                       maxCollisionId = collisionId;
+                     } else if (collisionId != maxCollisionId && cospa > maxCosPAOtherCollisions) {
+                       maxCosPAOtherCollisions = cospa;
+                     }
+                   }
+                   for (size_t k = begin; k < end; k++) {
+                     const float maxCosPAOthers = c.collisionId[order[k]] == maxCollisionId ? maxCosPAOtherCollisions : maxCosPA;
+                     if (c.cospa[order[k]] < maxCosPAOthers) {
+                       rejected[order[k]] = true;
+                     }
+                   }
+                 });
+
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return c.v0Id[a] < c.v0Id[b]; });
+    std::unordered_set<uint64_t> stored_v0Ids; // (pos.globalIndex(), ele.globalIndex())
+    stored_v0Ids.reserve(n);
+    stored_fullv0Ids.reserve(n);
+    for (const auto& i : order) {
+      if (rejected[i]) {
+        continue;
+      }
+      if (!stored_v0Ids.insert((static_cast<uint64_t>(c.posId[i]) << 32) | static_cast<uint32_t>(c.eleId[i])).second) {
+        continue;
+      }
+      stored_fullv0Ids.emplace_back(std::make_tuple(c.v0Id[i], c.collisionId[i], c.posId[i], c.eleId[i]));
+      nv0_map[c.collisionId[i]]++;
+    }
+  }
+
   template <bool isMC, bool isTriggerAnalysis, bool enableFilter, typename TCollisions, typename TV0s, typename TTracks, typename TBCs>
   void build(TCollisions const& collisions, TV0s const& v0s, TTracks const&, TBCs const&)
   {
@@ -910,60 +1029,7 @@ struct PhotonConversionBuilder {
       } // end of v0 loop
     } // end of collision loop
 
-    stored_v0Ids.reserve(pca_map.size());     // number of photon candidates per DF
-    stored_fullv0Ids.reserve(pca_map.size()); // number of photon candidates per DF
-
-    // find minimal pca
-    for (const auto& [key, value] : pca_map) {
-      auto v0Id = std::get<0>(key);
-      auto collisionId = std::get<1>(key);
-      auto posId = std::get<2>(key);
-      auto eleId = std::get<3>(key);
-      float v0pca = value;
-      float cospa = cospa_map[key];
-      bool is_closest_v0 = true;
-      bool is_most_aligned_v0 = true;
-
-      for (const auto& [key_tmp, value_tmp] : pca_map) {
-        auto v0Id_tmp = std::get<0>(key_tmp);
-        auto collisionId_tmp = std::get<1>(key_tmp);
-        auto posId_tmp = std::get<2>(key_tmp);
-        auto eleId_tmp = std::get<3>(key_tmp);
-        float v0pca_tmp = value_tmp;
-        float cospa_tmp = cospa_map[key_tmp];
-
-        if (v0Id == v0Id_tmp) { // skip exactly the same v0
-          continue;
-        }
-
-        if (collisionId != collisionId_tmp && eleId == eleId_tmp && posId == posId_tmp && cospa < cospa_tmp) { // same ele and pos, but attached to different collision
-          // LOGF(info, "!reject! | collision id = %d | posid1 = %d , eleid1 = %d , posid2 = %d , eleid2 = %d , cospa1 = %f , cospa2 = %f", collisionId, posId, eleId, posId_tmp, eleId_tmp, cospa, cospa_tmp);
-          is_most_aligned_v0 = false;
-          break;
-        }
-
-        if ((eleId == eleId_tmp || posId == posId_tmp) && v0pca > v0pca_tmp) {
-          // LOGF(info, "!reject! | collision id = %d | posid1 = %d , eleid1 = %d , posid2 = %d , eleid2 = %d , pca1 = %f , pca2 = %f", collisionId, posId, eleId, posId_tmp, eleId_tmp, v0pca, v0pca_tmp);
-          is_closest_v0 = false;
-          break;
-        }
-      } // end of pca_map tmp loop
-
-      bool is_stored = std::find(stored_v0Ids.begin(), stored_v0Ids.end(), std::make_pair(posId, eleId)) != stored_v0Ids.end();
-      if (is_closest_v0 && is_most_aligned_v0 && !is_stored) {
-        // auto v0 = v0s.rawIteratorAt(v0Id);
-        // auto collision = collisions.rawIteratorAt(collisionId);
-        // auto pos = tracks.rawIteratorAt(posId);
-        // auto ele = tracks.rawIteratorAt(eleId);
-        // LOGF(info, "!accept! | collision id = %d | v0id1 = %d , posid1 = %d , eleid1 = %d , pca1 = %f , cospa = %f", collisionId, v0Id, posId, eleId, v0pca, cospa);
-
-        // fillV0Table<isMC, TCollisions, TTracks>(v0, true);
-        stored_v0Ids.emplace_back(std::make_pair(posId, eleId));
-        stored_fullv0Ids.emplace_back(std::make_tuple(v0Id, collisionId, posId, eleId));
-        nv0_map[collisionId]++;
-      }
-    } // end of pca_map loop
-    // LOGF(info, "pca_map.size() = %d", pca_map.size());
+    arbitrateV0Candidates();
 
     for (const auto& fullv0Id : stored_fullv0Ids) {
       auto v0Id = std::get<0>(fullv0Id);
@@ -993,11 +1059,8 @@ struct PhotonConversionBuilder {
       // events_ngpcm(nv0_map[collision.globalIndex()]);
     } // end of collision loop
 
-    pca_map.clear();
-    cospa_map.clear();
+    v0Candidates.clear();
     nv0_map.clear();
-    stored_v0Ids.clear();
-    stored_v0Ids.shrink_to_fit();
     stored_fullv0Ids.clear();
     stored_fullv0Ids.shrink_to_fit();
   } // end of build
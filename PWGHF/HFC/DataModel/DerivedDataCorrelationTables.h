@@ -111,6 +111,20 @@ DECLARE_SOA_TABLE(AssocTrackPids, "AOD", "ASSOCTRACKPID", //! Table with associa
                   aod::hf_assoc_track_reduced::NSigmaTpc,
                   aod::hf_assoc_track_reduced::NSigmaTof);
 
+// slim pair table: candidate and associated track properties are in the tables above
+namespace hf_pair_reduced
+{
+DECLARE_SOA_INDEX_COLUMN(HcCandReduced, hcCandReduced); //! Reduced charm hadron candidate index
+DECLARE_SOA_INDEX_COLUMN(AssocTrackRed, assocTrackRed); //! Reduced associated track index
+DECLARE_SOA_COLUMN(DeltaPhi, deltaPhi, float);          //! Phi of the track minus phi of the candidate, in [-pi/2, 3pi/2)
+DECLARE_SOA_COLUMN(DeltaEta, deltaEta, float);          //! Eta of the track minus eta of the candidate
+} // namespace hf_pair_reduced
+DECLARE_SOA_TABLE(HcAssocPairReds, "AOD", "HCASSOCPAIRRED", //! Table with charm hadron - associated track pairs of the reduced tables
+                  aod::hf_pair_reduced::HcCandReducedId,
+                  aod::hf_pair_reduced::AssocTrackRedId,
+                  aod::hf_pair_reduced::DeltaPhi,
+                  aod::hf_pair_reduced::DeltaEta);
+
 // definition of columns and tables for Charm-Hadron and Hadron-Hadron correlation pairs
 namespace hf_correl_charm_had_reduced
 {
@@ -22,6 +22,7 @@
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
 #include "PWGHF/HFC/DataModel/CorrelationTables.h"
 #include "PWGHF/HFC/DataModel/DerivedDataCorrelationTables.h"
+#include "PWGHF/HFC/Utils/utilsCorrelations.h"
 #include "PWGHF/Utils/utilsAnalysis.h"
 
 #include "Common/CCDB/EventSelectionParams.h"
@@ -187,6 +188,7 @@ struct HfCorrelatorDplusHadrons {
   Produces<aod::HcCandSelInfos> candSelInfo;
   Produces<aod::AssocTrackReds> assocTrackReduced;
   Produces<aod::AssocTrackSels> assocTrackSelInfo;
+  Produces<aod::HcAssocPairReds> assocPairReduced;
 
   static constexpr std::size_t NDaughters{3u};
   static constexpr float EtaDaughtersMax = 0.8f; // Eta cut on daughters of D+ meson as Run2
@@ -200,6 +202,7 @@ struct HfCorrelatorDplusHadrons {
   Configurable<float> zVtxMax{"zVtxMax", 10., "max. position-z of the reconstructed collision"};
   Configurable<bool> applyEfficiency{"applyEfficiency", true, "Flag for applying D-meson efficiency weights"};
   Configurable<bool> removeDaughters{"removeDaughters", true, "Flag for removing D-meson daughters from correlations"};
+  Configurable<bool> fillPairsReduced{"fillPairsReduced", false, "Store in derived data also the D-hadron pairs as indices and angular differences"};
   Configurable<float> yCandMax{"yCandMax", 0.8, "max. cand. rapidity"};
   Configurable<float> yCandGenMax{"yCandGenMax", 0.5, "max. gen. cand. rapidity"};
   Configurable<float> etaTrackMax{"etaTrackMax", 0.8, "max. eta of tracks"};
@@ -218,6 +221,7 @@ struct HfCorrelatorDplusHadrons {
   Configurable<std::vector<float>> efficiencyD{"efficiencyD", {1., 1., 1., 1., 1., 1.}, "efficiency values for D+ meson"};
 
   SliceCache cache;
+  o2::analysis::hf_correlations::ReducedPairsBuilder reducedPairs;
 
   // Event Mixing for the Data Mode
   using SelCollisionsWithDplus = soa::Filtered<soa::Join<aod::Collisions, aod::Mults, aod::EvSels, aod::DmesonSelection>>;
@@ -489,9 +493,10 @@ struct HfCorrelatorDplusHadrons {
         if (applyEfficiency) {
           efficiencyWeightD = 1. / efficiencyD->at(effBinD);
         }
+        float const massD = HfHelper::invMassDplusToPiKPi(candidate);
         // fill invariant mass plots and generic info from all Dplus candidates
-        registry.fill(HIST("hMassDplus_2D"), HfHelper::invMassDplusToPiKPi(candidate), candidate.pt(), efficiencyWeightD);
-        registry.fill(HIST("hMassDplusData"), HfHelper::invMassDplusToPiKPi(candidate), efficiencyWeightD);
+        registry.fill(HIST("hMassDplus_2D"), massD, candidate.pt(), efficiencyWeightD);
+        registry.fill(HIST("hMassDplusData"), massD, efficiencyWeightD);
         registry.fill(HIST("hPtCand"), candidate.pt());
         registry.fill(HIST("hPtProng0"), candidate.ptProng0());
         registry.fill(HIST("hPtProng1"), candidate.ptProng1());
@@ -504,8 +509,8 @@ struct HfCorrelatorDplusHadrons {
         for (unsigned int iclass = 0; iclass < classMl->size(); iclass++) {
           outputMl[iclass] = candidate.mlProbDplusToPiKPi()[classMl->at(iclass)];
         }
-        entryDplusCandRecoInfo(HfHelper::invMassDplusToPiKPi(candidate), candidate.pt(), outputMl[0], outputMl[1], outputMl[2]); // 0: BkgBDTScore, 1:PromptBDTScore, 2: FDScore
-        entryDplus(candidate.phi(), candidate.eta(), candidate.pt(), HfHelper::invMassDplusToPiKPi(candidate), poolBin, gCollisionId, timeStamp);
+        entryDplusCandRecoInfo(massD, candidate.pt(), outputMl[0], outputMl[1], outputMl[2]); // 0: BkgBDTScore, 1:PromptBDTScore, 2: FDScore
+        entryDplus(candidate.phi(), candidate.eta(), candidate.pt(), massD, poolBin, gCollisionId, timeStamp);
 
         // Dplus-Hadron correlation dedicated section
         // if the candidate is a Dplus, search for Hadrons and evaluate correlations
@@ -524,7 +529,7 @@ struct HfCorrelatorDplusHadrons {
                                track.eta() - candidate.eta(),
                                candidate.pt(),
                                track.pt(), poolBin);
-          entryDplusHadronRecoInfo(HfHelper::invMassDplusToPiKPi(candidate), false);
+          entryDplusHadronRecoInfo(massD, false);
           entryDplusHadronGenInfo(false, false, 0);
           entryDplusHadronMlInfo(outputMl[0], outputMl[1], outputMl[2]);
           entryTrackRecoInfo(track.dcaXY(), track.dcaZ(), track.tpcNClsCrossedRows());
@@ -552,6 +557,7 @@ struct HfCorrelatorDplusHadrons {
       auto tracksThisColl = tracks.sliceBy(trackIndicesPerCollision, thisCollId);
 
       int indexHfcReducedCollision = collReduced.lastIndex() + 1;
+      reducedPairs.clear();
 
       // Ds fill histograms and Dplus candidates information stored
       for (const auto& candidate : candsDplusThisColl) {
@@ -563,6 +569,9 @@ struct HfCorrelatorDplusHadrons {
           }
           candReduced(indexHfcReducedCollision, candidate.phi(), candidate.eta(), candidate.pt(), HfHelper::invMassDplusToPiKPi(candidate), candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id());
           candSelInfo(indexHfcReducedCollision, outputMl[0], outputMl[2]);
+          if (fillPairsReduced) {
+            reducedPairs.addCandidate(candReduced.lastIndex(), candidate.phi(), candidate.eta(), {candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id()});
+          }
         }
       }
 
@@ -574,8 +583,14 @@ struct HfCorrelatorDplusHadrons {
         registry.fill(HIST("hDcaXYVsPt"), track.dcaXY(), track.pt());
         assocTrackReduced(indexHfcReducedCollision, track.globalIndex(), track.phi(), track.eta(), track.pt());
         assocTrackSelInfo(indexHfcReducedCollision, track.tpcNClsCrossedRows(), track.itsClusterMap(), track.itsNCls(), track.dcaXY(), track.dcaZ());
+        if (fillPairsReduced) {
+          reducedPairs.addTrack(assocTrackReduced.lastIndex(), track.globalIndex(), track.phi(), track.eta());
+        }
       }
 
+      if (fillPairsReduced) {
+        reducedPairs.fillPairs(assocPairReduced, removeDaughters);
+      }
       collReduced(collision.multFT0M(), 0.f, collision.numContrib(), collision.posZ());
     }
   }
@@ -632,9 +647,10 @@ struct HfCorrelatorDplusHadrons {
         bool isDplusNonPrompt = candidate.originMcRec() == RecoDecay::OriginType::NonPrompt;
 
         std::vector<float> outputMl = {-1., -1., -1.};
+        float const massD = HfHelper::invMassDplusToPiKPi(candidate);
 
         // fill invariant mass plots from Dplus signal and background candidates
-        registry.fill(HIST("hMassDplusMcRec"), HfHelper::invMassDplusToPiKPi(candidate), efficiencyWeightD);
+        registry.fill(HIST("hMassDplusMcRec"), massD, efficiencyWeightD);
         registry.fill(HIST("hDplusBin"), poolBin);
 
         if (isDplusSignal) {
@@ -642,7 +658,7 @@ struct HfCorrelatorDplusHadrons {
           registry.fill(HIST("hPtProng0MCRec"), candidate.ptProng0());
           registry.fill(HIST("hPtProng1MCRec"), candidate.ptProng1());
           registry.fill(HIST("hPtProng2MCRec"), candidate.ptProng2());
-          registry.fill(HIST("hMassDplusVsPtMcRec"), HfHelper::invMassDplusToPiKPi(candidate), candidate.pt(), efficiencyWeightD);
+          registry.fill(HIST("hMassDplusVsPtMcRec"), massD, candidate.pt(), efficiencyWeightD);
           registry.fill(HIST("hSelectionStatusMCRec"), candidate.isSelDplusToPiKPi());
           registry.fill(HIST("hPtCandMcRecSig"), candidate.pt());
           registry.fill(HIST("hEtaMcRecSig"), candidate.eta());
@@ -661,14 +677,14 @@ struct HfCorrelatorDplusHadrons {
           for (unsigned int iclass = 0; iclass < classMl->size(); iclass++) {
             outputMl[iclass] = candidate.mlProbDplusToPiKPi()[classMl->at(iclass)];
           }
-          registry.fill(HIST("hMassDplusMcRecSig"), HfHelper::invMassDplusToPiKPi(candidate), candidate.pt(), efficiencyWeightD);
-          entryDplusCandRecoInfo(HfHelper::invMassDplusToPiKPi(candidate), candidate.pt(), outputMl[0], outputMl[1], outputMl[2]);
+          registry.fill(HIST("hMassDplusMcRecSig"), massD, candidate.pt(), efficiencyWeightD);
+          entryDplusCandRecoInfo(massD, candidate.pt(), outputMl[0], outputMl[1], outputMl[2]);
           entryDplusCandGenInfo(isDplusPrompt);
         } else {
           registry.fill(HIST("hPtCandMcRecBkg"), candidate.pt());
           registry.fill(HIST("hEtaMcRecBkg"), candidate.eta());
           registry.fill(HIST("hPhiMcRecBkg"), RecoDecay::constrainAngle(candidate.phi(), -PIHalf));
-          registry.fill(HIST("hMassDplusMcRecBkg"), HfHelper::invMassDplusToPiKPi(candidate), candidate.pt(), efficiencyWeightD);
+          registry.fill(HIST("hMassDplusMcRecBkg"), massD, candidate.pt(), efficiencyWeightD);
         }
 
         // Dplus-Hadron correlation dedicated section
@@ -690,7 +706,7 @@ struct HfCorrelatorDplusHadrons {
                                track.eta() - candidate.eta(),
                                candidate.pt(),
                                track.pt(), poolBin);
-          entryDplusHadronRecoInfo(HfHelper::invMassDplusToPiKPi(candidate), isDplusSignal);
+          entryDplusHadronRecoInfo(massD, isDplusSignal);
           entryDplusHadronMlInfo(outputMl[0], outputMl[1], outputMl[2]);
           if (track.has_mcParticle()) {
             auto mcParticle = track.template mcParticle_as<aod::McParticles>();
@@ -179,6 +179,7 @@ struct HfCorrelatorDsHadrons {
   Produces<aod::AssocTrackReds> assocTrackReduced;
   Produces<aod::AssocTrackSels> assocTrackSelInfo;
   Produces<aod::AssocTrackPids> assocTrackPidInfo;
+  Produces<aod::HcAssocPairReds> assocPairReduced;
 
   Configurable<bool> fillHistoData{"fillHistoData", true, "Flag for filling histograms in data processes"};
   Configurable<bool> fillHistoMcRec{"fillHistoMcRec", true, "Flag for filling histograms in MC Rec processes"};
@@ -188,6 +189,7 @@ struct HfCorrelatorDsHadrons {
   Configurable<bool> selNoSameBunchPileUpColl{"selNoSameBunchPileUpColl", true, "Flag for rejecting the collisions associated with the same bunch crossing (used only in MC processes)"};
   Configurable<bool> pidTrkApplied{"pidTrkApplied", false, "Apply PID selection for associated tracks"};
   Configurable<bool> forceTOF{"forceTOF", false, "force the TOF signal for the PID"};
+  Configurable<bool> fillPairsReduced{"fillPairsReduced", false, "Store in derived data also the Ds-hadron pairs as indices and angular differences"};
   Configurable<int> selectionFlagDs{"selectionFlagDs", 7, "Selection Flag for Ds (avoid the case of flag = 0, no outputMlScore)"};
   Configurable<int> numberEventsMixed{"numberEventsMixed", 5, "Number of events mixed in ME process"};
   Configurable<int> decayChannel{"decayChannel", 1, "Resonant decay channels: 1 for Ds->PhiPi->KKpi, 2 for Ds->K0*K->KKPi"};
@@ -216,6 +218,7 @@ struct HfCorrelatorDsHadrons {
   static constexpr std::size_t NDaughtersDs{3u};
 
   SliceCache cache;
+  ReducedPairsBuilder reducedPairs;
 
   using SelCollisionsWithDs = soa::Filtered<soa::Join<aod::Collisions, aod::Mults, aod::CentFT0Ms, aod::EvSels, aod::DmesonSelection>>; // collisionFilter applied
   // using SelCollisionsWithDsWithMc = soa::Filtered<soa::Join<aod::Collisions, aod::Mults, aod::EvSels, aod::DmesonSelection, aod::McCollisionLabels>>; // collisionFilter applied
@@ -847,6 +850,7 @@ struct HfCorrelatorDsHadrons {
       auto tracksThisColl = tracks.sliceBy(trackIndicesPerCollision, thisCollId);
 
       int indexHfcReducedCollision = collReduced.lastIndex() + 1;
+      reducedPairs.clear();
 
       // Ds fill histograms and Ds candidates information stored
       for (const auto& candidate : candsDsThisColl) {
@@ -860,12 +864,18 @@ struct HfCorrelatorDsHadrons {
           }
           candReduced(indexHfcReducedCollision, candidate.phi(), candidate.eta(), candidate.pt() * chargeDs, HfHelper::invMassDsToKKPi(candidate), candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id());
           candSelInfo(indexHfcReducedCollision, outputMl[0], outputMl[2]);
+          if (fillPairsReduced) {
+            reducedPairs.addCandidate(candReduced.lastIndex(), candidate.phi(), candidate.eta(), {candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id()});
+          }
         } else if (candidate.isSelDsToPiKK() >= selectionFlagDs) {
           for (unsigned int iclass = 0; iclass < classMl->size(); iclass++) {
             outputMl[iclass] = candidate.mlProbDsToPiKK()[classMl->at(iclass)];
           }
           candReduced(indexHfcReducedCollision, candidate.phi(), candidate.eta(), candidate.pt() * chargeDs, HfHelper::invMassDsToPiKK(candidate), candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id());
           candSelInfo(indexHfcReducedCollision, outputMl[0], outputMl[2]);
+          if (fillPairsReduced) {
+            reducedPairs.addCandidate(candReduced.lastIndex(), candidate.phi(), candidate.eta(), {candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id()});
+          }
         }
       }
 
@@ -906,8 +916,15 @@ struct HfCorrelatorDsHadrons {
         if (trkPIDspecies->at(0) == o2::track::PID::Proton) {
           assocTrackPidInfo(track.tpcNSigmaPr(), track.tofNSigmaPr());
         }
+        if (fillPairsReduced) {
+          reducedPairs.addTrack(assocTrackReduced.lastIndex(), track.globalIndex(), track.phi(), track.eta());
+        }
       }
 
+      // Ds daughters are always removed from the same-event pairs
+      if (fillPairsReduced) {
+        reducedPairs.fillPairs(assocPairReduced, true);
+      }
       collReduced(collision.multFT0M(), collision.centFT0M(), collision.numContrib(), collision.posZ());
     }
   }
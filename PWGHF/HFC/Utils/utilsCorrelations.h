@@ -18,6 +18,7 @@
 
 #include "PWGHF/Core/DecayChannels.h"
 
+#include "Common/Core/RecoDecay.h"
 #include "Common/DataModel/PIDResponseTOF.h"
 #include "Common/DataModel/PIDResponseTPC.h"
 
@@ -27,8 +28,11 @@
 
 #include <TPDGCode.h>
 
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace o2::analysis::hf_correlations
 {
@@ -227,5 +231,60 @@ int findLeadingParticleMcGen(TMcParticles const& mcParticles, T1 const etaTrackM
   }
   return leadingParticle.globalIndex();
 }
+
+// ======= Pairs of the reduced tables ============
+/// Keeps the candidates and associated tracks of one collision as they are written to the
+/// reduced tables, to store their pairs only as indices and angular differences
+class ReducedPairsBuilder
+{
+ public:
+  void clear()
+  {
+    mCandidates.clear();
+    mTracks.clear();
+  }
+
+  /// \param index row of the candidate in the reduced candidate table
+  void addCandidate(int64_t index, float phi, float eta, std::array<int, 3> const& prongIds)
+  {
+    mCandidates.push_back({index, phi, eta, prongIds});
+  }
+
+  /// \param index row of the track in the reduced associated track table
+  void addTrack(int64_t index, int originTrackId, float phi, float eta)
+  {
+    mTracks.push_back({index, originTrackId, phi, eta});
+  }
+
+  /// Fills the pair table with all the candidate-track pairs of the collision
+  template <typename TPairs>
+  void fillPairs(TPairs& pairs, bool removeDaughters) const
+  {
+    for (const auto& candidate : mCandidates) {
+      for (const auto& track : mTracks) {
+        if (removeDaughters && (candidate.prongIds[0] == track.originTrackId || candidate.prongIds[1] == track.originTrackId || candidate.prongIds[2] == track.originTrackId)) {
+          continue;
+        }
+        pairs(candidate.index, track.index, RecoDecay::constrainAngle(track.phi - candidate.phi, -o2::constants::math::PIHalf), track.eta - candidate.eta);
+      }
+    }
+  }
+
+ private:
+  struct Candidate {
+    int64_t index;
+    float phi;
+    float eta;
+    std::array<int, 3> prongIds;
+  };
+  struct Track {
+    int64_t index;
+    int originTrackId;
+    float phi;
+    float eta;
+  };
+  std::vector<Candidate> mCandidates;
+  std::vector<Track> mTracks;
+};
 } // namespace o2::analysis::hf_correlations
 #endif // PWGHF_HFC_UTILS_UTILSCORRELATIONS_H_
@@ -58,15 +58,21 @@
 
 #include <GPUROOTCartesianFwd.h>
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <gsl/span>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <span>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -141,6 +147,7 @@ struct EmcalCorrectionTask {
   Configurable<bool> applySoftwareTriggerSelection{"applySoftwareTriggerSelection", false, "Apply software trigger selection"};
   Configurable<std::string> softwareTriggerSelection{"softwareTriggerSelection", "fGammaHighPtEMCAL,fGammaHighPtDCAL", "Default: fGammaHighPtEMCAL,fGammaHighPtDCAL"};
   Configurable<bool> storePerDFInfo{"storePerDFInfo", false, "store addition information per DF."};
+  Configurable<int> nClusterizerThreads{"nClusterizerThreads", 1, "Number of threads running the clusterizers on independent BCs in processFull (1: serial). Track matching and the table filling stay serial, in BC order."};
   ConfigurableAxis thConfigAxisClusters{"thConfigAxisClusters", {1000, 0.5f, 1000.5f}, ""};
   ConfigurableAxis thConfigAxisCells{"thConfigAxisCells", {1000, 0.5f, 1000.5f}, ""};
   // cross talk emulation configs
@@ -174,6 +181,110 @@ struct EmcalCorrectionTask {
   std::vector<float> mClusterPhi;
   std::vector<float> mClusterEta;
 
+  // Cells of a BC converted for the clusterizer, together with the clusters found for each clusterizer
+  struct PreparedBC {
+    int64_t bcIndex = -1;
+    std::vector<o2::emcal::Cell> cells;
+    std::vector<int64_t> cellIndices;
+    std::vector<std::vector<o2::emcal::AnalysisCluster>> analysisClusters; // per clusterizer
+    std::vector<std::vector<float>> clusterPhi;                            // per clusterizer
+    std::vector<std::vector<float>> clusterEta;                            // per clusterizer
+  };
+  PreparedBC mSerialBC;
+  std::vector<PreparedBC> mPreparedBCs;
+
+  // Each clusterizer thread owns its own set of clusterizers and its own cluster factory
+  struct ClusterizerWorker {
+    std::vector<std::unique_ptr<o2::emcal::Clusterizer<o2::emcal::Cell>>> clusterizers;
+    o2::emcal::ClusterFactory<o2::emcal::Cell> clusterFactory;
+  };
+  std::vector<std::unique_ptr<ClusterizerWorker>> mClusterizerWorkers;
+
+  // Threads started once in init() and woken up for each DF. The calling thread runs worker 0, thread i runs worker i,
+  // and the workers take the tasks of the DF one after the other.
+  class ClusterizerThreadPool
+  {
+   public:
+    ClusterizerThreadPool(size_t nWorkers, std::function<void(size_t, size_t)> work) : mWork(std::move(work))
+    {
+      for (size_t iWorker = 1; iWorker < nWorkers; iWorker++) {
+        mThreads.emplace_back(&ClusterizerThreadPool::loop, this, iWorker);
+      }
+    }
+    ~ClusterizerThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+      }
+      mWakeUp.notify_all();
+      for (auto& thread : mThreads) {
+        thread.join();
+      }
+    }
+
+    /// \brief Run nTasks tasks on the workers and return once all of them are done
+    void run(size_t nTasks)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mNTasks = nTasks;
+        mNextTask = 0;
+        ++mGeneration;
+        mNBusy = mThreads.size();
+      }
+      mWakeUp.notify_all();
+      work(0);
+      std::unique_lock<std::mutex> lock(mMutex);
+      mDone.wait(lock, [this] { return mNBusy == 0; });
+    }
+
+   private:
+    void work(size_t iWorker)
+    {
+      for (size_t iTask = mNextTask++; iTask < mNTasks; iTask = mNextTask++) {
+        mWork(iWorker, iTask);
+      }
+    }
+
+    void loop(size_t iWorker)
+    {
+      uint64_t generation = 0;
+      std::unique_lock<std::mutex> lock(mMutex);
+      while (true) {
+        mWakeUp.wait(lock, [this, generation] { return mStop || mGeneration != generation; });
+        if (mStop) {
+          return;
+        }
+        generation = mGeneration;
+        lock.unlock();
+        work(iWorker);
+        lock.lock();
+        if (--mNBusy == 0) {
+          mDone.notify_one();
+        }
+      }
+    }
+
+    std::function<void(size_t, size_t)> mWork; // (worker, task)
+    size_t mNTasks = 0;
+    std::atomic<size_t> mNextTask{0};
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWakeUp;
+    std::condition_variable mDone;
+    uint64_t mGeneration = 0;
+    size_t mNBusy = 0;
+    bool mStop = false;
+  };
+  // Declared after the workers and the prepared BCs, so that the threads are joined before those are destroyed
+  std::unique_ptr<ClusterizerThreadPool> mClusterizerThreadPool;
+
+  // Time spent per DF in the different stages of processFull
+  std::chrono::duration<double, std::milli> mTimeCellPrep{0};
+  std::chrono::duration<double, std::milli> mTimeClusterizer{0};
+  std::chrono::duration<double, std::milli> mTimeTrackMatching{0};
+
   std::vector<o2::aod::EMCALClusterDefinition> mClusterDefinitions;
   // QA
   o2::framework::HistogramRegistry mHistManager{"EMCALCorrectionTaskQAHistograms"};
@@ -258,15 +369,8 @@ struct EmcalCorrectionTask {
         mClusterDefinitions.push_back(clusDef);
       }
     }
-    mClusterFactories.setGeometry(geometry);
-    mClusterFactories.SetECALogWeight(logWeight);
-    mClusterFactories.setExoticCellFraction(exoticCellFraction);
-    mClusterFactories.setExoticCellDiffTime(exoticCellDiffTime);
-    mClusterFactories.setExoticCellMinAmplitude(exoticCellMinAmplitude);
-    mClusterFactories.setExoticCellInCrossMinAmplitude(exoticCellInCrossMinAmplitude);
-    mClusterFactories.setUseWeightExotic(useWeightExotic);
+    setupClusterizers(mClusterizers, mClusterFactories);
     for (const auto& clusterDefinition : mClusterDefinitions) {
-      mClusterizers.emplace_back(std::make_unique<o2::emcal::Clusterizer<o2::emcal::Cell>>(clusterDefinition.timeDiff, clusterDefinition.timeMin, clusterDefinition.timeMax, clusterDefinition.gradientCut, clusterDefinition.doGradientCut, clusterDefinition.seedEnergy, clusterDefinition.minCellEnergy));
       LOG(info) << "Cluster definition initialized: " << clusterDefinition.toString();
       LOG(info) << "timeMin: " << clusterDefinition.timeMin;
       LOG(info) << "timeMax: " << clusterDefinition.timeMax;
@@ -276,14 +380,29 @@ struct EmcalCorrectionTask {
       LOG(info) << "minCellEnergy: " << clusterDefinition.minCellEnergy;
       LOG(info) << "storageID: " << clusterDefinition.storageID;
     }
-    for (const auto& clusterizer : mClusterizers) {
-      clusterizer->setGeometry(geometry);
-    }
 
     if (mClusterizers.size() == 0) {
       LOG(error) << "No cluster definitions specified!";
     }
 
+    if (nClusterizerThreads > 1 && doprocessFull) {
+      for (int iWorker = 0; iWorker < nClusterizerThreads; iWorker++) {
+        auto& worker = mClusterizerWorkers.emplace_back(std::make_unique<ClusterizerWorker>());
+        setupClusterizers(worker->clusterizers, worker->clusterFactory);
+      }
+      // All workers share the geometry. The clusterizers and cluster factories only call its const lookups, which
+      // compute from the geometry constants, except for the super module matrices used by GetGlobal, which are
+      // loaded from the geometry manager on first access. Load them here, before the threads start, so that the
+      // threads only read from the geometry.
+      for (int iSM = 0; iSM < geometry->GetNumberOfSuperModules(); iSM++) {
+        geometry->GetMatrixForSuperModule(iSM);
+      }
+      mClusterizerThreadPool = std::make_unique<ClusterizerThreadPool>(mClusterizerWorkers.size(), [this](size_t iWorker, size_t iBC) {
+        clusterizePreparedBC(*mClusterizerWorkers[iWorker], mPreparedBCs[iBC]);
+      });
+      LOG(info) << "Running clusterizers of processFull on " << nClusterizerThreads << " threads";
+    }
+
     // 500 clusters per event is a good upper limit
     mClusterPhi.reserve(500 * mClusterizers.size());
     mClusterEta.reserve(500 * mClusterizers.size());
@@ -399,6 +518,9 @@ struct EmcalCorrectionTask {
       mHistManager.add("hNClusterDF", "hNClusterDF", O2HistType::kTH1D, {nClusterDFAxis});
       mHistManager.add("hNClusterAmbigousDF", "hNClusterAmbigousDF", O2HistType::kTH1D, {nClusterDFAxis});
       mHistManager.add("hNCellDF", "hNCellDF", O2HistType::kTH1D, {nCellsDFAxis});
+      mHistManager.add("hTimeCellPrepDF", "hTimeCellPrepDF;#it{t}_{cell correction} (ms);#it{N}_{DF}", O2HistType::kTH1D, {{1000, 0., 1000.}});
+      mHistManager.add("hTimeClusterizerDF", "hTimeClusterizerDF;#it{t}_{clusterizer} (ms);#it{N}_{DF}", O2HistType::kTH1D, {{1000, 0., 1000.}});
+      mHistManager.add("hTimeTrackMatchingDF", "hTimeTrackMatchingDF;#it{t}_{track matching} (ms);#it{N}_{DF}", O2HistType::kTH1D, {{1000, 0., 1000.}});
     }
   }
 
@@ -432,6 +554,9 @@ struct EmcalCorrectionTask {
     nCluster = 0;
     nClusterAmb = 0;
     nCells = 0;
+    resetStageTimers();
+    const bool runParallel = mClusterizerWorkers.size() > 1;
+    mPreparedBCs.clear();
     for (const auto& bc : bcs) {
       LOG(debug) << "Next BC";
 
@@ -470,89 +595,65 @@ struct EmcalCorrectionTask {
         }
       }
 
-      std::vector<o2::emcal::Cell> cellsBC;
-      std::vector<int64_t> cellIndicesBC;
-      for (const auto& cell : cellsInBC) {
-        auto amplitude = cell.amplitude();
-        if (static_cast<bool>(hasShaperCorrection) && emcal::intToChannelType(cell.cellType()) == emcal::ChannelType_t::LOW_GAIN) { // Apply shaper correction to LG cells
-          amplitude = o2::emcal::NonlinearityHandler::evaluateShaperCorrectionCellEnergy(amplitude);
-        }
-        if (applyCellAbsScale) {
-          amplitude *= getAbsCellScale(cell.cellNumber());
-        }
-        if (applyGainCalibShift) {
-          amplitude *= mArrGainCalibDiff[cell.cellNumber()];
-        }
-        if (applyTempCalib) {
-          float tempCalibFactor = mTempCalibExtractor->getGainCalibFactor(static_cast<uint16_t>(cell.cellNumber()));
-          amplitude /= tempCalibFactor;
-          mHistManager.fill(HIST("hTempCalibCorrection"), tempCalibFactor);
-        }
-        cellsBC.emplace_back(cell.cellNumber(),
-                             amplitude,
-                             cell.time() + getCellTimeShift(cell.cellNumber(), amplitude, o2::emcal::intToChannelType(cell.cellType()), runNumber),
-                             o2::emcal::intToChannelType(cell.cellType()));
-        cellIndicesBC.emplace_back(cell.globalIndex());
-      }
-      LOG(detail) << "Number of cells for BC (CF): " << cellsBC.size();
-      nCellsProcessed += cellsBC.size();
+      auto startCellPrep = std::chrono::steady_clock::now();
+      auto& preparedBC = runParallel ? mPreparedBCs.emplace_back() : mSerialBC;
+      preparedBC.bcIndex = bc.globalIndex();
+      prepareCells(cellsInBC, preparedBC.cells, preparedBC.cellIndices);
+      mTimeCellPrep += std::chrono::steady_clock::now() - startCellPrep;
+      LOG(detail) << "Number of cells for BC (CF): " << preparedBC.cells.size();
+      nCellsProcessed += preparedBC.cells.size();
 
-      fillQAHistogram(cellsBC);
+      fillQAHistogram(preparedBC.cells);
 
-      LOG(debug) << "Converted cells. Contains: " << cellsBC.size() << ". Originally " << cellsInBC.size() << ". About to run clusterizer.";
-      //  this is a test
+      LOG(debug) << "Converted cells. Contains: " << preparedBC.cells.size() << ". Originally " << cellsInBC.size() << ". About to run clusterizer.";
+      if (runParallel) {
+        // clusterization and matching are deferred until all BCs of the DF are prepared
+        continue;
+      }
       //  Run the clusterizers
       LOG(debug) << "Running clusterizers";
       for (size_t iClusterizer = 0; iClusterizer < mClusterizers.size(); iClusterizer++) {
-        cellsToCluster(iClusterizer, cellsBC);
-
-        if (collisionsInFoundBC.size() == 1) {
-          // dummy loop to get the first collision
-          for (const auto& col : collisionsInFoundBC) {
-            if (previousCollisionId > col.globalIndex()) {
-              mHistManager.fill(HIST("hBCMatchErrors"), 1);
-              continue;
-            }
-            previousCollisionId = col.globalIndex();
-            if (col.foundBCId() == bc.globalIndex()) {
-              mHistManager.fill(HIST("hBCMatchErrors"), 0); // CollisionID ordered and foundBC matches -> Fill as healthy
-              mHistManager.fill(HIST("hCollisionTimeReso"), col.collisionTimeRes());
-              mHistManager.fill(HIST("hCollPerBC"), 1);
-              mHistManager.fill(HIST("hCollisionType"), 1);
-              math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
-
-              MatchResult indexMapPair;
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
-
-              // Store the clusters in the table where a matching collision could
-              // be identified.
-              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &indexMapPair, &trackGlobalIndex);
-            } else {
-              mHistManager.fill(HIST("hBCMatchErrors"), 2);
-            }
-          }
-        } else { // ambiguous
-          // LOG(warning) << "No vertex found for event. Assuming (0,0,0).";
-          bool hasCollision = false;
-          mHistManager.fill(HIST("hCollPerBC"), collisionsInFoundBC.size());
-          if (collisionsInFoundBC.size() == 0) {
-            mHistManager.fill(HIST("hCollisionType"), 0);
-          } else {
-            hasCollision = true;
-            mHistManager.fill(HIST("hCollisionType"), 2);
-          }
-          fillAmbigousClusterTable<BcEvSels::iterator>(bc, iClusterizer, cellIndicesBC, hasCollision);
-        }
+        auto startClusterizer = std::chrono::steady_clock::now();
+        cellsToCluster(iClusterizer, preparedBC.cells);
+        mTimeClusterizer += std::chrono::steady_clock::now() - startClusterizer;
 
-        mClusterPhi.clear();
-        mClusterEta.clear();
-        LOG(debug) << "Cluster loop done for clusterizer " << iClusterizer;
+        fillClustersForBC(bc, collisionsInFoundBC, tracks, iClusterizer, preparedBC.cellIndices, previousCollisionId);
       } // end of clusterizer loop
       LOG(debug) << "Done with process BC.";
       nBCsProcessed++;
     } // end of bc loop
 
+    if (runParallel) {
+      // Run the clusterizers for all prepared BCs on the worker threads, each worker owning its own clusterizers
+      auto startClusterizer = std::chrono::steady_clock::now();
+      runClusterizerWorkers();
+      mTimeClusterizer += std::chrono::steady_clock::now() - startClusterizer;
+
+      // Merge the results in BC order, so that the output tables are identical to the serial mode
+      auto preparedBC = mPreparedBCs.begin();
+      for (const auto& bc : bcs) {
+        if (preparedBC == mPreparedBCs.end()) {
+          break;
+        }
+        if (preparedBC->bcIndex != bc.globalIndex()) {
+          continue;
+        }
+        auto collisionsInFoundBC = collisions.sliceBy(collisionsPerFoundBC, bc.globalIndex());
+        for (size_t iClusterizer = 0; iClusterizer < mClusterizers.size(); iClusterizer++) {
+          mAnalysisClusters.swap(preparedBC->analysisClusters[iClusterizer]);
+          mClusterPhi.swap(preparedBC->clusterPhi[iClusterizer]);
+          mClusterEta.swap(preparedBC->clusterEta[iClusterizer]);
+          mClusterLabels.clear();
+          mHistManager.fill(HIST("hNCluster"), mAnalysisClusters.size());
+
+          fillClustersForBC(bc, collisionsInFoundBC, tracks, iClusterizer, preparedBC->cellIndices, previousCollisionId);
+        }
+        nBCsProcessed++;
+        ++preparedBC;
+      }
+      mPreparedBCs.clear();
+    }
+
     // Loop through all collisions and fill emcalcollisionmatch with a boolean stating, whether the collision was ambiguous (not the only collision in its BC)
     // NOTE: we can not do zorro selection here since emcalcollisionmatch needs to alway be filled to be joinable with collision table
     for (const auto& collision : collisions) {
@@ -571,6 +672,7 @@ struct EmcalCorrectionTask {
       mHistManager.fill(HIST("hNClusterDF"), nCluster);
       mHistManager.fill(HIST("hNClusterAmbigousDF"), nClusterAmb);
       mHistManager.fill(HIST("hNCellDF"), nCells);
+      fillStageTimers();
     }
   }
   PROCESS_SWITCH(EmcalCorrectionTask, processFull, "run full analysis", true);
@@ -1263,6 +1365,156 @@ struct EmcalCorrectionTask {
   }
   PROCESS_SWITCH(EmcalCorrectionTask, processStandalone, "run stand alone analysis", false);
 
+  /// \brief Apply the cell level corrections and convert the cells of one BC to o2::emcal::Cell for the clusterizer
+  template <typename Cells>
+  void prepareCells(Cells const& cellsInBC, std::vector<o2::emcal::Cell>& cellsBC, std::vector<int64_t>& cellIndicesBC)
+  {
+    cellsBC.clear();
+    cellIndicesBC.clear();
+    cellsBC.reserve(cellsInBC.size());
+    cellIndicesBC.reserve(cellsInBC.size());
+    for (const auto& cell : cellsInBC) {
+      auto amplitude = cell.amplitude();
+      if (static_cast<bool>(hasShaperCorrection) && emcal::intToChannelType(cell.cellType()) == emcal::ChannelType_t::LOW_GAIN) { // Apply shaper correction to LG cells
+        amplitude = o2::emcal::NonlinearityHandler::evaluateShaperCorrectionCellEnergy(amplitude);
+      }
+      if (applyCellAbsScale) {
+        amplitude *= getAbsCellScale(cell.cellNumber());
+      }
+      if (applyGainCalibShift) {
+        amplitude *= mArrGainCalibDiff[cell.cellNumber()];
+      }
+      if (applyTempCalib) {
+        float tempCalibFactor = mTempCalibExtractor->getGainCalibFactor(static_cast<uint16_t>(cell.cellNumber()));
+        amplitude /= tempCalibFactor;
+        mHistManager.fill(HIST("hTempCalibCorrection"), tempCalibFactor);
+      }
+      cellsBC.emplace_back(cell.cellNumber(),
+                           amplitude,
+                           cell.time() + getCellTimeShift(cell.cellNumber(), amplitude, o2::emcal::intToChannelType(cell.cellType()), runNumber),
+                           o2::emcal::intToChannelType(cell.cellType()));
+      cellIndicesBC.emplace_back(cell.globalIndex());
+    }
+  }
+
+  /// \brief Match the clusters of one clusterizer in a BC to the tracks and store them in the (ambiguous) cluster tables
+  /// Expects mAnalysisClusters, mClusterPhi and mClusterEta to hold the clusters of the given clusterizer.
+  template <typename BC, typename Collisions>
+  void fillClustersForBC(BC const& bc, Collisions const& collisionsInFoundBC, MyGlobTracks const& tracks, size_t iClusterizer, const gsl::span<int64_t> cellIndicesBC, int& previousCollisionId)
+  {
+    if (collisionsInFoundBC.size() == 1) {
+      // dummy loop to get the first collision
+      for (const auto& col : collisionsInFoundBC) {
+        if (previousCollisionId > col.globalIndex()) {
+          mHistManager.fill(HIST("hBCMatchErrors"), 1);
+          continue;
+        }
+        previousCollisionId = col.globalIndex();
+        if (col.foundBCId() == bc.globalIndex()) {
+          mHistManager.fill(HIST("hBCMatchErrors"), 0); // CollisionID ordered and foundBC matches -> Fill as healthy
+          mHistManager.fill(HIST("hCollisionTimeReso"), col.collisionTimeRes());
+          mHistManager.fill(HIST("hCollPerBC"), 1);
+          mHistManager.fill(HIST("hCollisionType"), 1);
+          math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
+
+          MatchResult indexMapPair;
+          std::vector<int64_t> trackGlobalIndex;
+          auto startTrackMatching = std::chrono::steady_clock::now();
+          doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
+          mTimeTrackMatching += std::chrono::steady_clock::now() - startTrackMatching;
+
+          // Store the clusters in the table where a matching collision could
+          // be identified.
+          fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &indexMapPair, &trackGlobalIndex);
+        } else {
+          mHistManager.fill(HIST("hBCMatchErrors"), 2);
+        }
+      }
+    } else { // ambiguous
+      bool hasCollision = false;
+      mHistManager.fill(HIST("hCollPerBC"), collisionsInFoundBC.size());
+      if (collisionsInFoundBC.size() == 0) {
+        mHistManager.fill(HIST("hCollisionType"), 0);
+      } else {
+        hasCollision = true;
+        mHistManager.fill(HIST("hCollisionType"), 2);
+      }
+      fillAmbigousClusterTable<BcEvSels::iterator>(bc, iClusterizer, cellIndicesBC, hasCollision);
+    }
+
+    mClusterPhi.clear();
+    mClusterEta.clear();
+    LOG(debug) << "Cluster loop done for clusterizer " << iClusterizer;
+  }
+
+  /// \brief Run all clusterizers of one worker on the cells of a prepared BC and keep the resulting analysis clusters in the BC
+  /// Only touches the state of the worker and of the BC, so that it can be called concurrently for different BCs.
+  static void clusterizePreparedBC(ClusterizerWorker& worker, PreparedBC& preparedBC)
+  {
+    const auto nClusterizers = worker.clusterizers.size();
+    preparedBC.analysisClusters.resize(nClusterizers);
+    preparedBC.clusterPhi.resize(nClusterizers);
+    preparedBC.clusterEta.resize(nClusterizers);
+    for (size_t iClusterizer = 0; iClusterizer < nClusterizers; iClusterizer++) {
+      auto& clusterizer = worker.clusterizers[iClusterizer];
+      clusterizer->findClusters(preparedBC.cells);
+      worker.clusterFactory.reset();
+      worker.clusterFactory.setContainer(*clusterizer->getFoundClusters(), preparedBC.cells, *clusterizer->getFoundClustersInputIndices());
+
+      auto& analysisClusters = preparedBC.analysisClusters[iClusterizer];
+      auto& clusterPhi = preparedBC.clusterPhi[iClusterizer];
+      auto& clusterEta = preparedBC.clusterEta[iClusterizer];
+      analysisClusters.clear();
+      clusterPhi.clear();
+      clusterEta.clear();
+      for (int icl = 0; icl < worker.clusterFactory.getNumberOfClusters(); icl++) {
+        o2::emcal::ClusterLabel clusterLabel;
+        auto analysisCluster = worker.clusterFactory.buildCluster(icl, &clusterLabel);
+        auto pos = analysisCluster.getGlobalPosition();
+        clusterPhi.emplace_back(RecoDecay::constrainAngle(pos.Phi()));
+        clusterEta.emplace_back(pos.Eta());
+        analysisClusters.emplace_back(std::move(analysisCluster));
+      }
+    }
+  }
+
+  /// \brief Distribute the prepared BCs of the DF over the clusterizer workers
+  void runClusterizerWorkers()
+  {
+    mClusterizerThreadPool->run(mPreparedBCs.size());
+  }
+
+  /// \brief Create one clusterizer per cluster definition and configure the cluster factory
+  /// Used for the clusterizers of the task and for those of each clusterizer worker.
+  void setupClusterizers(std::vector<std::unique_ptr<o2::emcal::Clusterizer<o2::emcal::Cell>>>& clusterizers, o2::emcal::ClusterFactory<o2::emcal::Cell>& clusterFactory)
+  {
+    clusterFactory.setGeometry(geometry);
+    clusterFactory.SetECALogWeight(logWeight);
+    clusterFactory.setExoticCellFraction(exoticCellFraction);
+    clusterFactory.setExoticCellDiffTime(exoticCellDiffTime);
+    clusterFactory.setExoticCellMinAmplitude(exoticCellMinAmplitude);
+    clusterFactory.setExoticCellInCrossMinAmplitude(exoticCellInCrossMinAmplitude);
+    clusterFactory.setUseWeightExotic(useWeightExotic);
+    for (const auto& clusterDefinition : mClusterDefinitions) {
+      clusterizers.emplace_back(std::make_unique<o2::emcal::Clusterizer<o2::emcal::Cell>>(clusterDefinition.timeDiff, clusterDefinition.timeMin, clusterDefinition.timeMax, clusterDefinition.gradientCut, clusterDefinition.doGradientCut, clusterDefinition.seedEnergy, clusterDefinition.minCellEnergy));
+      clusterizers.back()->setGeometry(geometry);
+    }
+  }
+
+  void resetStageTimers()
+  {
+    mTimeCellPrep = mTimeCellPrep.zero();
+    mTimeClusterizer = mTimeClusterizer.zero();
+    mTimeTrackMatching = mTimeTrackMatching.zero();
+  }
+
+  void fillStageTimers()
+  {
+    mHistManager.fill(HIST("hTimeCellPrepDF"), mTimeCellPrep.count());
+    mHistManager.fill(HIST("hTimeClusterizerDF"), mTimeClusterizer.count());
+    mHistManager.fill(HIST("hTimeTrackMatchingDF"), mTimeTrackMatching.count());
+  }
+
   void cellsToCluster(size_t iClusterizer, const gsl::span<o2::emcal::Cell> cellsBC, gsl::span<const o2::emcal::CellLabel> cellLabels = {})
   {
     mClusterizers.at(iClusterizer)->findClusters(cellsBC);
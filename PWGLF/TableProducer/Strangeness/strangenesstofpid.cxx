@@ -517,6 +517,7 @@ struct strangenesstofpid {
       // if in mode 1, bookkeep the failures of propagation
       if (calculationMethod.value == 1) {
         histos.add("hPropagationBookkeeping", "hPropagationBookkeeping", kTProfile, {{5, -0.5f, 4.5f}});
+        histos.add("hPropagationsSaved", "hPropagationsSaved", kTH1D, {{5, -0.5f, 4.5f}});
       }
 
       // standard deltaTime values
@@ -864,6 +865,7 @@ struct strangenesstofpid {
     bool hasITS = false;
     bool hasTPC = false;
     bool hasTOF = false;
+    int trackId = -1; // daughter track index, used to reuse its propagation to the primary vertex
     int collisionId = -1;
     float tofExpMom = 0.0f;
     float tofSignal = 0.0f;
@@ -878,6 +880,60 @@ struct strangenesstofpid {
     float tpcNSigmaPr = 0.0f;
   };
 
+  struct propagationToPV { // daughter track propagated to the primary vertex (method 1)
+    std::array<float, 7> start{};        // x, alpha and parameters before the propagation
+    o2::track::TrackPar propagatedTrack; // parameters at the primary vertex
+    float length = 0.0f;                 // path length to the primary vertex
+    bool success = false;
+  };
+
+  // propagations of the daughter tracks in this DF, keyed by (track index, collision index).
+  // A daughter shared by several candidates (e.g. the V0 daughters of the cascades built with the
+  // same V0) is propagated once, as long as it starts from the same parameters.
+  std::unordered_map<uint64_t, propagationToPV> propagationCache;
+
+  /// function to propagate a daughter track to the primary vertex of its collision
+  /// and to obtain the travel length from the decay point to the primary vertex
+  /// \param collisions the collisions table
+  /// \param tofInfo the information of the daughter track (track and collision indices)
+  /// \param track the daughter track, initialized at the decay point and propagated to the primary vertex
+  /// \param propagationType the type of propagation for the bookkeeping (see typesOfPropagation)
+  /// \param length the travel length to the primary vertex, if the propagation succeeded
+  template <class TCollisions, typename TTOFInfo>
+  bool propagateToPrimaryVertex(TCollisions const& collisions, TTOFInfo const& tofInfo, o2::track::TrackPar& track, int propagationType, float& length)
+  {
+    const float* params = track.getParams();
+    const std::array<float, 7> start{track.getX(), track.getAlpha(), params[0], params[1], params[2], params[3], params[4]};
+    const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(tofInfo.trackId)) << 32) | static_cast<uint32_t>(tofInfo.collisionId);
+
+    auto cached = tofInfo.trackId >= 0 ? propagationCache.find(key) : propagationCache.end();
+    const bool reused = cached != propagationCache.end() && cached->second.start == start;
+    propagationToPV propagation;
+    if (reused) {
+      propagation = cached->second;
+      track = propagation.propagatedTrack;
+    } else {
+      auto trackCollision = collisions.rawIteratorAt(tofInfo.collisionId);
+      const o2::math_utils::Point3D<float> trackVertex{trackCollision.posX(), trackCollision.posY(), trackCollision.posZ()};
+      o2::track::TrackLTIntegral ltIntegral;
+      propagation.start = start;
+      propagation.success = o2::base::Propagator::Instance()->propagateToDCA(trackVertex, track, d_bz, 2.f, o2::base::Propagator::MatCorrType::USEMatCorrNONE, nullptr, &ltIntegral);
+      propagation.propagatedTrack = track;
+      propagation.length = ltIntegral.getL();
+      if (tofInfo.trackId >= 0) {
+        propagationCache.insert_or_assign(key, propagation);
+      }
+    }
+    if (doQA) {
+      histos.fill(HIST("hPropagationBookkeeping"), propagationType, static_cast<float>(propagation.success));
+      if (reused) {
+        histos.fill(HIST("hPropagationsSaved"), propagationType);
+      }
+    }
+    length = propagation.length;
+    return propagation.success;
+  }
+
   // templatized process function for symmetric operation in derived and original AO2D
   /// \param collisions the collisions table (needed for de-referencing V0 and progns)
   /// \param v0 the V0 being processed
@@ -945,15 +1001,9 @@ struct strangenesstofpid {
       // use main method from TOF to calculate expected time
       if (calculationMethod.value == 1) {
         if (pTof.collisionId >= 0) {
-          auto trackCollision = collisions.rawIteratorAt(pTof.collisionId);
-          const o2::math_utils::Point3D<float> trackVertex{trackCollision.posX(), trackCollision.posY(), trackCollision.posZ()};
-          o2::track::TrackLTIntegral ltIntegral;
-          bool successPropag = o2::base::Propagator::Instance()->propagateToDCA(trackVertex, posTrack, d_bz, 2.f, o2::base::Propagator::MatCorrType::USEMatCorrNONE, nullptr, &ltIntegral);
-          if (doQA) {
-            histos.fill(HIST("hPropagationBookkeeping"), kPropagPosV0, static_cast<float>(successPropag));
-          }
-          if (successPropag) {
-            lengthPositive = pTof.length - ltIntegral.getL();
+          float lengthToPV = 0.0f;
+          if (propagateToPrimaryVertex(collisions, pTof, posTrack, kPropagPosV0, lengthToPV)) {
+            lengthPositive = pTof.length - lengthToPV;
             v0tof.timePositiveEl = o2::framework::pid::tof::MassToExpTime(pTof.tofExpMom, lengthPositive, o2::constants::physics::MassElectron * o2::constants::physics::MassElectron);
             v0tof.timePositivePr = o2::framework::pid::tof::MassToExpTime(pTof.tofExpMom, lengthPositive, o2::constants::physics::MassProton * o2::constants::physics::MassProton);
             v0tof.timePositivePi = o2::framework::pid::tof::MassToExpTime(pTof.tofExpMom, lengthPositive, o2::constants::physics::MassPionCharged * o2::constants::physics::MassPionCharged);
@@ -1061,15 +1111,9 @@ struct strangenesstofpid {
       // use main method from TOF to calculate expected time
       if (calculationMethod.value == 1) {
         if (nTof.collisionId >= 0) {
-          auto trackCollision = collisions.rawIteratorAt(nTof.collisionId);
-          const o2::math_utils::Point3D<float> trackVertex{trackCollision.posX(), trackCollision.posY(), trackCollision.posZ()};
-          o2::track::TrackLTIntegral ltIntegral;
-          bool successPropag = o2::base::Propagator::Instance()->propagateToDCA(trackVertex, negTrack, d_bz, 2.f, o2::base::Propagator::MatCorrType::USEMatCorrNONE, nullptr, &ltIntegral);
-          if (doQA) {
-            histos.fill(HIST("hPropagationBookkeeping"), kPropagNegV0, static_cast<float>(successPropag));
-          }
-          if (successPropag) {
-            lengthNegative = nTof.length - ltIntegral.getL();
+          float lengthToPV = 0.0f;
+          if (propagateToPrimaryVertex(collisions, nTof, negTrack, kPropagNegV0, lengthToPV)) {
+            lengthNegative = nTof.length - lengthToPV;
             v0tof.timeNegativeEl = o2::framework::pid::tof::MassToExpTime(nTof.tofExpMom, lengthNegative, o2::constants::physics::MassElectron * o2::constants::physics::MassElectron);
             v0tof.timeNegativePr = o2::framework::pid::tof::MassToExpTime(nTof.tofExpMom, lengthNegative, o2::constants::physics::MassProton * o2::constants::physics::MassProton);
             v0tof.timeNegativePi = o2::framework::pid::tof::MassToExpTime(nTof.tofExpMom, lengthNegative, o2::constants::physics::MassPionCharged * o2::constants::physics::MassPionCharged);
@@ -1295,17 +1339,11 @@ struct strangenesstofpid {
       // use main method from TOF to calculate expected time
       if (calculationMethod.value == 1) {
         if (pTof.collisionId >= 0) {
-          auto trackCollision = collisions.rawIteratorAt(pTof.collisionId);
-          const o2::math_utils::Point3D<float> trackVertex{trackCollision.posX(), trackCollision.posY(), trackCollision.posZ()};
-          o2::track::TrackLTIntegral ltIntegral;
-          bool successPropag = o2::base::Propagator::Instance()->propagateToDCA(trackVertex, posTrack, d_bz, 2.f, o2::base::Propagator::MatCorrType::USEMatCorrNONE, nullptr, &ltIntegral);
-          if (doQA) {
-            histos.fill(HIST("hPropagationBookkeeping"), kPropagPosCasc, static_cast<float>(successPropag));
-          }
-          if (successPropag) {
-            lengthPositive = pTof.length - ltIntegral.getL();
-            casctof.posFlightPr = o2::framework::pid::tof::MassToExpTime(pTof.tofExpMom, pTof.length - ltIntegral.getL(), o2::constants::physics::MassProton * o2::constants::physics::MassProton);
-            casctof.posFlightPi = o2::framework::pid::tof::MassToExpTime(pTof.tofExpMom, pTof.length - ltIntegral.getL(), o2::constants::physics::MassPionCharged * o2::constants::physics::MassPionCharged);
+          float lengthToPV = 0.0f;
+          if (propagateToPrimaryVertex(collisions, pTof, posTrack, kPropagPosCasc, lengthToPV)) {
+            lengthPositive = pTof.length - lengthToPV;
+            casctof.posFlightPr = o2::framework::pid::tof::MassToExpTime(pTof.tofExpMom, lengthPositive, o2::constants::physics::MassProton * o2::constants::physics::MassProton);
+            casctof.posFlightPi = o2::framework::pid::tof::MassToExpTime(pTof.tofExpMom, lengthPositive, o2::constants::physics::MassPionCharged * o2::constants::physics::MassPionCharged);
 
             // as primary
             casctof.posFlightAsPrimaryPr = o2::framework::pid::tof::MassToExpTime(pTof.tofExpMom, pTof.length, o2::constants::physics::MassProton * o2::constants::physics::MassProton);
@@ -1432,17 +1470,11 @@ struct strangenesstofpid {
       // use main method from TOF to calculate expected time
       if (calculationMethod.value == 1) {
         if (nTof.collisionId >= 0) {
-          auto trackCollision = collisions.rawIteratorAt(nTof.collisionId);
-          const o2::math_utils::Point3D<float> trackVertex{trackCollision.posX(), trackCollision.posY(), trackCollision.posZ()};
-          o2::track::TrackLTIntegral ltIntegral;
-          bool successPropag = o2::base::Propagator::Instance()->propagateToDCA(trackVertex, negTrack, d_bz, 2.f, o2::base::Propagator::MatCorrType::USEMatCorrNONE, nullptr, &ltIntegral);
-          if (doQA) {
-            histos.fill(HIST("hPropagationBookkeeping"), kPropagNegCasc, static_cast<float>(successPropag));
-          }
-          if (successPropag) {
-            lengthNegative = nTof.length - ltIntegral.getL();
-            casctof.negFlightPr = o2::framework::pid::tof::MassToExpTime(nTof.tofExpMom, nTof.length - ltIntegral.getL(), o2::constants::physics::MassProton * o2::constants::physics::MassProton);
-            casctof.negFlightPi = o2::framework::pid::tof::MassToExpTime(nTof.tofExpMom, nTof.length - ltIntegral.getL(), o2::constants::physics::MassPionCharged * o2::constants::physics::MassPionCharged);
+          float lengthToPV = 0.0f;
+          if (propagateToPrimaryVertex(collisions, nTof, negTrack, kPropagNegCasc, lengthToPV)) {
+            lengthNegative = nTof.length - lengthToPV;
+            casctof.negFlightPr = o2::framework::pid::tof::MassToExpTime(nTof.tofExpMom, lengthNegative, o2::constants::physics::MassProton * o2::constants::physics::MassProton);
+            casctof.negFlightPi = o2::framework::pid::tof::MassToExpTime(nTof.tofExpMom, lengthNegative, o2::constants::physics::MassPionCharged * o2::constants::physics::MassPionCharged);
 
             // as primary
             casctof.negFlightAsPrimaryPr = o2::framework::pid::tof::MassToExpTime(nTof.tofExpMom, nTof.length, o2::constants::physics::MassProton * o2::constants::physics::MassProton);
@@ -1569,17 +1601,11 @@ struct strangenesstofpid {
       // use main method from TOF to calculate expected time
       if (calculationMethod.value == 1) {
         if (bTof.collisionId >= 0) {
-          auto trackCollision = collisions.rawIteratorAt(bTof.collisionId);
-          const o2::math_utils::Point3D<float> trackVertex{trackCollision.posX(), trackCollision.posY(), trackCollision.posZ()};
-          o2::track::TrackLTIntegral ltIntegral;
-          bool successPropag = o2::base::Propagator::Instance()->propagateToDCA(trackVertex, bachTrack, d_bz, 2.f, o2::base::Propagator::MatCorrType::USEMatCorrNONE, nullptr, &ltIntegral);
-          if (doQA) {
-            histos.fill(HIST("hPropagationBookkeeping"), kPropagBachCasc, static_cast<float>(successPropag));
-          }
-          if (successPropag) {
-            lengthBachelor = bTof.length - ltIntegral.getL();
-            casctof.bachFlightPi = o2::framework::pid::tof::MassToExpTime(bTof.tofExpMom, bTof.length - ltIntegral.getL(), o2::constants::physics::MassPionCharged * o2::constants::physics::MassPionCharged);
-            casctof.bachFlightKa = o2::framework::pid::tof::MassToExpTime(bTof.tofExpMom, bTof.length - ltIntegral.getL(), o2::constants::physics::MassKaonCharged * o2::constants::physics::MassKaonCharged);
+          float lengthToPV = 0.0f;
+          if (propagateToPrimaryVertex(collisions, bTof, bachTrack, kPropagBachCasc, lengthToPV)) {
+            lengthBachelor = bTof.length - lengthToPV;
+            casctof.bachFlightPi = o2::framework::pid::tof::MassToExpTime(bTof.tofExpMom, lengthBachelor, o2::constants::physics::MassPionCharged * o2::constants::physics::MassPionCharged);
+            casctof.bachFlightKa = o2::framework::pid::tof::MassToExpTime(bTof.tofExpMom, lengthBachelor, o2::constants::physics::MassKaonCharged * o2::constants::physics::MassKaonCharged);
 
             // as primary
             casctof.bachFlightAsPrimaryPi = o2::framework::pid::tof::MassToExpTime(bTof.tofExpMom, bTof.length, o2::constants::physics::MassPionCharged * o2::constants::physics::MassPionCharged);
@@ -1739,6 +1765,7 @@ struct strangenesstofpid {
           histos.fill(HIST("hV0NegativeBCShift"), deltaTimeNeg);
         }
 
+        pTof.trackId = pTra.globalIndex();
         pTof.collisionId = pTra.collisionId();
         pTof.hasITS = pTra.hasITS();
         pTof.hasTPC = pTra.hasTPC();
@@ -1755,6 +1782,7 @@ struct strangenesstofpid {
         pTof.tpcNSigmaPi = pTra.tpcNSigmaPi();
         pTof.tpcNSigmaPr = pTra.tpcNSigmaPr();
 
+        nTof.trackId = nTra.globalIndex();
         nTof.collisionId = nTra.collisionId();
         nTof.hasITS = nTra.hasITS();
         nTof.hasTPC = nTra.hasTPC();
@@ -1857,6 +1885,7 @@ struct strangenesstofpid {
           histos.fill(HIST("hCascadeBachelorBCShift"), deltaTimeBach);
         }
 
+        pTof.trackId = pTra.globalIndex();
         pTof.collisionId = pTra.collisionId();
         pTof.hasITS = pTra.hasITS();
         pTof.hasTPC = pTra.hasTPC();
@@ -1870,6 +1899,7 @@ struct strangenesstofpid {
         pTof.tpcNSigmaPi = pTra.tpcNSigmaPi();
         pTof.tpcNSigmaPr = pTra.tpcNSigmaPr();
 
+        nTof.trackId = nTra.globalIndex();
         nTof.collisionId = nTra.collisionId();
         nTof.hasITS = nTra.hasITS();
         nTof.hasTPC = nTra.hasTPC();
@@ -1883,6 +1913,7 @@ struct strangenesstofpid {
         nTof.tpcNSigmaPi = nTra.tpcNSigmaPi();
         nTof.tpcNSigmaPr = nTra.tpcNSigmaPr();
 
+        bTof.trackId = bTra.globalIndex();
         bTof.collisionId = bTra.collisionId();
         bTof.hasITS = bTra.hasITS();
         bTof.hasTPC = bTra.hasTPC();
@@ -1933,6 +1964,7 @@ struct strangenesstofpid {
 
     mapCollisionTime.clear();
     mapCollisionTimeError.clear();
+    propagationCache.clear();
   }
 
   void processDerivedData(soa::Join<aod::StraCollisions, aod::StraStamps, aod::StraEvTimes> const& collisions, V0DerivedDatas const& V0s, CascDerivedDatas const& cascades, dauTracks const& dauTrackTable, aod::DauTrackTOFPIDs const& dauTrackTOFPIDs)
@@ -2006,6 +2038,7 @@ struct strangenesstofpid {
             deltaTimeBcPos = deltaTimeBc;
 
             // assign variables
+            pTof.trackId = pTofExt.dauTrackExtraId();
             pTof.collisionId = pTofExt.straCollisionId();
             pTof.tofExpMom = pTofExt.tofExpMom();
             pTof.tofEvTime = reassociateTracks.value ? collision.eventTime() : pTofExt.tofEvTime();
@@ -2033,6 +2066,7 @@ struct strangenesstofpid {
             deltaTimeBcNeg = deltaTimeBc;
 
             // assign variables
+            nTof.trackId = nTofExt.dauTrackExtraId();
             nTof.collisionId = nTofExt.straCollisionId();
             nTof.tofExpMom = nTofExt.tofExpMom();
             nTof.tofEvTime = reassociateTracks.value ? collision.eventTime() : nTofExt.tofEvTime();
@@ -2102,6 +2136,7 @@ struct strangenesstofpid {
             histos.fill(HIST("hCascadePositiveBCShift"), deltaTimeBc);
             histos.fill(HIST("h2dTOFSignalCascadePositive"), pTof.tofSignal, deltaTimeBc);
 
+            pTof.trackId = pTofExt.dauTrackExtraId();
             pTof.collisionId = pTofExt.straCollisionId();
             pTof.tofExpMom = pTofExt.tofExpMom();
             pTof.tofEvTime = reassociateTracks.value ? collision.eventTime() : pTofExt.tofEvTime();
@@ -2128,6 +2163,7 @@ struct strangenesstofpid {
             histos.fill(HIST("hCascadeNegativeBCShift"), deltaTimeBc);
             histos.fill(HIST("h2dTOFSignalCascadeNegative"), nTof.tofSignal, deltaTimeBc);
 
+            nTof.trackId = nTofExt.dauTrackExtraId();
             nTof.collisionId = nTofExt.straCollisionId();
             nTof.tofExpMom = nTofExt.tofExpMom();
             nTof.tofEvTime = reassociateTracks.value ? collision.eventTime() : nTofExt.tofEvTime();
@@ -2154,6 +2190,7 @@ struct strangenesstofpid {
             histos.fill(HIST("hCascadeBachelorBCShift"), deltaTimeBc);
             histos.fill(HIST("h2dTOFSignalCascadeBachelor"), bTof.tofSignal, deltaTimeBc);
 
+            bTof.trackId = bTofExt.dauTrackExtraId();
             bTof.collisionId = bTofExt.straCollisionId();
             bTof.tofExpMom = bTofExt.tofExpMom();
             bTof.tofEvTime = reassociateTracks.value ? collision.eventTime() : bTofExt.tofEvTime();
@@ -2180,6 +2217,7 @@ struct strangenesstofpid {
         }
       }
     }
+    propagationCache.clear();
   }
 
   PROCESS_SWITCH(strangenesstofpid, processStandardData, "Process standard data", false);
@@ -47,6 +47,7 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
@@ -181,6 +182,46 @@ struct AmbiguousTrackPropagation {
     }
   }
 
+  // Compatible vertex of an ambiguous forward track, scanned without covariance transport
+  struct FwdVertexCandidate {
+    double x = 0.;
+    double y = 0.;
+    double z = 0.;
+    int64_t globalIndex = -1;
+    int order = 0; // position among the compatible collisions, breaks DCA ties as in the unsorted scan
+    double dcaX = 999.;
+    double dcaY = 999.;
+    float dcaXY = 999.f;
+  };
+  std::vector<FwdVertexCandidate> fwdCandidates;
+
+  template <typename C>
+  void addFwdCandidate(C const& collision)
+  {
+    fwdCandidates.push_back({collision.posX(), collision.posY(), collision.posZ(), collision.globalIndex(), static_cast<int>(fwdCandidates.size())});
+  }
+
+  /// Evaluates the helix position only (no covariance) at all candidates in increasing z,
+  /// fills their DCA and returns the index of the candidate with the smallest DCA_xy, -1 if none is below maxDCA
+  int scanFwdCandidates(o2::track::TrackParFwd helix, float maxDCA)
+  {
+    std::sort(fwdCandidates.begin(), fwdCandidates.end(), [](auto const& a, auto const& b) { return a.z < b.z || (a.z == b.z && a.order < b.order); });
+    int best = -1;
+    float bestDCA = maxDCA;
+    for (auto i = 0; i < static_cast<int>(fwdCandidates.size()); ++i) {
+      auto& candidate = fwdCandidates[i];
+      helix.propagateParamToZhelix(candidate.z, bZ);
+      candidate.dcaX = helix.getX() - candidate.x;
+      candidate.dcaY = helix.getY() - candidate.y;
+      candidate.dcaXY = std::sqrt(candidate.dcaX * candidate.dcaX + candidate.dcaY * candidate.dcaY);
+      if (candidate.dcaXY < bestDCA || (best >= 0 && candidate.dcaXY == bestDCA && candidate.order < fwdCandidates[best].order)) {
+        best = i;
+        bestDCA = candidate.dcaXY;
+      }
+    }
+    return best;
+  }
+
   static constexpr TrackSelectionFlags::flagtype CtrackSelectionITS =
     TrackSelectionFlags::kITSNCls | TrackSelectionFlags::kITSChi2NDF |
     TrackSelectionFlags::kITSHits;
@@ -287,12 +328,10 @@ struct AmbiguousTrackPropagation {
     initCCDB(bcs.begin());
 
     // Minimum only on DCAxy
-    float dcaInfo = 0.f;
     float bestDCA = 0.f, bestDCAx = 0.f, bestDCAy = 0.f;
     o2::track::TrackParCovFwd bestTrackPar;
 
     for (auto const& atrack : atracks) {
-      dcaInfo = 999; // DCAxy
       bestDCA = 999;
 
       auto track = atrack.mfttrack();
@@ -300,8 +339,7 @@ struct AmbiguousTrackPropagation {
 
       o2::track::TrackParCovFwd trackPar = o2::aod::fwdtrackutils::getTrackParCovFwdShift(track, mZShift);
 
-      int degree = 0; // degree of ambiguity of the track
-
+      fwdCandidates.clear();
       auto compatibleBCs = atrack.bc_as<ExtBCs>();
       for (auto const& bc : compatibleBCs) {
         if (!bc.has_collisions()) {
@@ -309,30 +347,32 @@ struct AmbiguousTrackPropagation {
         }
         auto collisions = bc.collisions();
         for (auto const& collision : collisions) {
-          degree++;
-          trackPar.propagateToZhelix(collision.posZ(), bZ); // track parameters propagation to the position of the z vertex
-
-          const auto dcaX(trackPar.getX() - collision.posX());
-          const auto dcaY(trackPar.getY() - collision.posY());
-          dcaInfo = std::sqrt(dcaX * dcaX + dcaY * dcaY);
-
-          if ((dcaInfo < bestDCA)) {
-            bestCol = collision.globalIndex();
-            bestDCA = dcaInfo;
-            bestDCAx = dcaX;
-            bestDCAy = dcaY;
-            bestTrackPar = trackPar;
-          }
+          addFwdCandidate(collision);
+        }
+      }
+      int degree = fwdCandidates.size(); // degree of ambiguity of the track
+
+      auto best = scanFwdCandidates(trackPar, bestDCA);
+      if (best >= 0) {
+        auto const& candidate = fwdCandidates[best];
+        bestCol = candidate.globalIndex;
+        bestDCA = candidate.dcaXY;
+        bestDCAx = candidate.dcaX;
+        bestDCAy = candidate.dcaY;
+        if (produceExtra) {
+          bestTrackPar = trackPar;
+          bestTrackPar.propagateToZhelix(candidate.z, bZ); // covariance transport only for the chosen vertex
+        }
+      }
 
-          if (produceHistos) {
-            registry.fill(HIST("TracksDCAXY"), dcaInfo);
-          }
-          if ((track.collisionId() != collision.globalIndex()) && produceHistos) {
-            registry.fill(HIST("DeltaZ"), track.collision().posZ() - collision.posZ()); // deltaZ between the 1st coll zvtx and the other compatible ones
+      if (produceHistos) {
+        for (auto const& candidate : fwdCandidates) {
+          registry.fill(HIST("TracksDCAXY"), candidate.dcaXY);
+          if (track.collisionId() != candidate.globalIndex) {
+            registry.fill(HIST("DeltaZ"), track.collision().posZ() - candidate.z); // deltaZ between the 1st coll zvtx and the other compatible ones
           }
-
-          if ((collision.globalIndex() == track.collisionId()) && produceHistos) {
-            registry.fill(HIST("TracksOrigDCAXY"), dcaInfo);
+          if (candidate.globalIndex == track.collisionId()) {
+            registry.fill(HIST("TracksOrigDCAXY"), candidate.dcaXY);
           }
         }
       }
@@ -370,12 +410,10 @@ struct AmbiguousTrackPropagation {
     }
     initCCDB(bcs.begin());
 
-    float dcaInfo = 0.f;
     float bestDCA = 0.f, bestDCAx = 0.f, bestDCAy = 0.f;
     o2::track::TrackParCovFwd bestTrackPar;
 
     for (auto const& track : tracks) {
-      dcaInfo = 999; // DCAxy
       bestDCA = 999;
 
       auto bestCol = track.has_collision() ? track.collisionId() : -1;
@@ -390,30 +428,33 @@ struct AmbiguousTrackPropagation {
 
       o2::track::TrackParCovFwd trackPar = o2::aod::fwdtrackutils::getTrackParCovFwdShift(track, mZShift);
 
+      fwdCandidates.clear();
       for (auto const& collision : compatibleColls) {
+        addFwdCandidate(collision);
+      }
 
-        trackPar.propagateToZhelix(collision.posZ(), bZ); // track parameters propagation to the position of the z vertex
-
-        const auto dcaX(trackPar.getX() - collision.posX());
-        const auto dcaY(trackPar.getY() - collision.posY());
-        dcaInfo = std::sqrt(dcaX * dcaX + dcaY * dcaY);
-
-        if ((dcaInfo < bestDCA)) {
-          bestCol = collision.globalIndex();
-          bestDCA = dcaInfo;
-          bestDCAx = dcaX;
-          bestDCAy = dcaY;
+      auto best = scanFwdCandidates(trackPar, bestDCA);
+      if (best >= 0) {
+        auto const& candidate = fwdCandidates[best];
+        bestCol = candidate.globalIndex;
+        bestDCA = candidate.dcaXY;
+        bestDCAx = candidate.dcaX;
+        bestDCAy = candidate.dcaY;
+        if (produceExtra) {
           bestTrackPar = trackPar;
+          bestTrackPar.propagateToZhelix(candidate.z, bZ); // covariance transport only for the chosen vertex
         }
-        if ((track.collisionId() != collision.globalIndex()) && produceHistos) {
-          registry.fill(HIST("DeltaZ"), track.collision().posZ() - collision.posZ()); // deltaZ between the 1st coll zvtx and the other compatible ones
-        }
-        if (produceHistos) {
-          registry.fill(HIST("TracksDCAXY"), dcaInfo);
-        }
+      }
 
-        if ((collision.globalIndex() == track.collisionId()) && produceHistos) {
-          registry.fill(HIST("TracksOrigDCAXY"), dcaInfo);
+      if (produceHistos) {
+        for (auto const& candidate : fwdCandidates) {
+          if (track.collisionId() != candidate.globalIndex) {
+            registry.fill(HIST("DeltaZ"), track.collision().posZ() - candidate.z); // deltaZ between the 1st coll zvtx and the other compatible ones
+          }
+          registry.fill(HIST("TracksDCAXY"), candidate.dcaXY);
+          if (candidate.globalIndex == track.collisionId()) {
+            registry.fill(HIST("TracksOrigDCAXY"), candidate.dcaXY);
+          }
         }
       }
       if ((bestCol != track.collisionId()) && produceHistos) {